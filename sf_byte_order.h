@@ -0,0 +1,73 @@
+/**
+* @version 1.0.0
+* @author skyfire
+* @mail skyfireitdiy@hotmail.com
+* @see http://github.com/skyfireitdiy/sflib
+* @file sf_byte_order.h
+
+* sflib第一版本发布
+* 版本号1.0.0
+* 发布日期：2018-10-22
+*/
+
+/*
+ * sf_byte_order 字节序转换
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+namespace skyfire
+{
+    /**
+     * 本机是否为小端字节序（编译期确定，小端主机上的转换全部在编译期去除）
+     */
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    constexpr bool sf_host_little_endian = false;
+#else
+    constexpr bool sf_host_little_endian = true;
+#endif
+
+    /**
+     * 反转16位整数的字节序
+     */
+    inline unsigned short sf_byte_swap16(unsigned short value);
+
+    /**
+     * 反转32位整数的字节序
+     */
+    inline unsigned int sf_byte_swap32(unsigned int value);
+
+    /**
+     * 反转64位整数的字节序
+     */
+    inline unsigned long long sf_byte_swap64(unsigned long long value);
+
+    /**
+     * 反转数值类型（整数、枚举、浮点数）的字节序
+     * @param value 值
+     * @return 反转后的值
+     */
+    template<typename _Type>
+    _Type sf_byte_swap(_Type value);
+
+    /**
+     * 本机字节序与小端字节序互相转换（小端主机上直接返回）
+     * @param value 值
+     * @return 转换后的值
+     */
+    template<typename _Type>
+    _Type sf_little_endian(_Type value);
+
+    /**
+     * 复制count个元素并反转每个元素的字节序，x86（SSE2）与ARM（NEON）上每次处理16字节
+     * @param dst 目标（不能与源重叠）
+     * @param src 源
+     * @param count 元素个数
+     * @param unit 元素字节数（1、2、4、8）
+     */
+    inline void sf_byte_swap_copy(void *dst, const void *src, size_t count, size_t unit);
+}
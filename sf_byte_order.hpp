@@ -0,0 +1,134 @@
+/**
+* @version 1.0.0
+* @author skyfire
+* @mail skyfireitdiy@hotmail.com
+* @see http://github.com/skyfireitdiy/sflib
+* @file sf_byte_order.hpp
+
+* sflib第一版本发布
+* 版本号1.0.0
+* 发布日期：2018-10-22
+*/
+
+/*
+ * sf_byte_order 字节序转换
+ */
+
+#pragma once
+
+#include "sf_byte_order.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SF_BYTE_SWAP_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SF_BYTE_SWAP_NEON
+#endif
+
+#ifdef _MSC_VER
+#include <cstdlib>
+#endif
+
+namespace skyfire
+{
+    inline unsigned short sf_byte_swap16(unsigned short value) {
+#ifdef _MSC_VER
+        return _byteswap_ushort(value);
+#else
+        return __builtin_bswap16(value);
+#endif
+    }
+
+    inline unsigned int sf_byte_swap32(unsigned int value) {
+#ifdef _MSC_VER
+        return _byteswap_ulong(value);
+#else
+        return __builtin_bswap32(value);
+#endif
+    }
+
+    inline unsigned long long sf_byte_swap64(unsigned long long value) {
+#ifdef _MSC_VER
+        return _byteswap_uint64(value);
+#else
+        return __builtin_bswap64(value);
+#endif
+    }
+
+    template<typename _Type>
+    inline _Type sf_byte_swap(_Type value) {
+        static_assert(std::is_arithmetic<_Type>::value || std::is_enum<_Type>::value, "Type must be arithmetic or enum");
+        if constexpr (sizeof(_Type) == 2) {
+            unsigned short tmp;
+            memcpy(&tmp, &value, sizeof(tmp));
+            tmp = sf_byte_swap16(tmp);
+            memcpy(&value, &tmp, sizeof(tmp));
+        } else if constexpr (sizeof(_Type) == 4) {
+            unsigned int tmp;
+            memcpy(&tmp, &value, sizeof(tmp));
+            tmp = sf_byte_swap32(tmp);
+            memcpy(&value, &tmp, sizeof(tmp));
+        } else if constexpr (sizeof(_Type) == 8) {
+            unsigned long long tmp;
+            memcpy(&tmp, &value, sizeof(tmp));
+            tmp = sf_byte_swap64(tmp);
+            memcpy(&value, &tmp, sizeof(tmp));
+        } else {
+            static_assert(sizeof(_Type) == 1, "Unsupported size");
+        }
+        return value;
+    }
+
+    template<typename _Type>
+    inline _Type sf_little_endian(_Type value) {
+        if constexpr (sf_host_little_endian) {
+            return value;
+        } else {
+            return sf_byte_swap(value);
+        }
+    }
+
+    inline void sf_byte_swap_copy(void *dst, const void *src, size_t count, size_t unit) {
+        auto d = static_cast<unsigned char *>(dst);
+        auto s = static_cast<const unsigned char *>(src);
+        auto size = count * unit;
+        if (unit == 1) {
+            memcpy(d, s, size);
+            return;
+        }
+        size_t i = 0;
+#if defined(SF_BYTE_SWAP_SSE2)
+        // NOTE SSE2没有字节重排指令：先重排16位字，再交换每个字中的两个字节
+        for (; i + 16 <= size; i += 16) {
+            auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+            if (unit == 4) {
+                v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+                v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+            } else if (unit == 8) {
+                v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+                v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+            }
+            v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(d + i), v);
+        }
+#elif defined(SF_BYTE_SWAP_NEON)
+        for (; i + 16 <= size; i += 16) {
+            auto v = vld1q_u8(s + i);
+            if (unit == 2) {
+                v = vrev16q_u8(v);
+            } else if (unit == 4) {
+                v = vrev32q_u8(v);
+            } else {
+                v = vrev64q_u8(v);
+            }
+            vst1q_u8(d + i, v);
+        }
+#endif
+        for (; i < size; i += unit) {
+            for (size_t k = 0; k < unit; ++k) {
+                d[i + k] = s[i + unit - 1 - k];
+            }
+        }
+    }
+}
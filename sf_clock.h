@@ -0,0 +1,48 @@
+/**
+* @version 1.0.0
+* @author skyfire
+* @mail skyfireitdiy@hotmail.com
+* @see http://github.com/skyfireitdiy/sflib
+* @file sf_clock.h
+
+* sflib第一版本发布
+* 版本号1.0.0
+* 发布日期：2018-10-22
+*/
+
+/*
+ * sf_clock 时间字符串缓存
+ * 格式化后的秒级时间字符串按线程缓存，同一秒内只格式化一次（线程安全，不使用localtime/gmtime的静态缓冲区）
+ * 本文件只依赖标准库，可以随sf_logger独立使用
+ */
+
+#pragma once
+
+#include <chrono>
+#include <ctime>
+#include <string>
+
+namespace skyfire
+{
+    /**
+     * 生成日志时间字符串（本地时间，格式为 2018-10-22 12:00:00）
+     * @param tt 时间
+     * @return 时间字符串（线程内缓存，下一次调用前有效）
+     */
+    inline const std::string &sf_log_time_str(time_t tt);
+
+    /**
+     * 生成带秒以下部分的日志时间字符串（如 2018-10-22 12:00:00.123）
+     * @param ticks system_clock纪元以来的纳秒数
+     * @param precision 秒以下的位数（0-9，0表示不带小数部分）
+     * @return 时间字符串
+     */
+    inline std::string sf_log_time_str(long long ticks, int precision);
+
+    /**
+     * 生成http时间字符串（RFC 7231，GMT，如 Mon, 22 Oct 2018 04:00:00 GMT）
+     * @param tt 时间
+     * @return 时间字符串（线程内缓存，下一次调用前有效）
+     */
+    inline const std::string &sf_http_gmt_time_str(time_t tt);
+}
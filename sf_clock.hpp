@@ -0,0 +1,128 @@
+/**
+* @version 1.0.0
+* @author skyfire
+* @mail skyfireitdiy@hotmail.com
+* @see http://github.com/skyfireitdiy/sflib
+* @file sf_clock.hpp
+
+* sflib第一版本发布
+* 版本号1.0.0
+* 发布日期：2018-10-22
+*/
+
+/*
+ * sf_clock 时间字符串缓存
+ */
+
+#pragma once
+
+#include "sf_clock.h"
+
+namespace skyfire
+{
+    /**
+     *  @brief 秒级时间字符串缓存
+     */
+    struct sf_time_str_cache_t__
+    {
+        time_t second = -1;                 // 缓存对应的时间
+        std::string str;                    // 缓存的字符串
+    };
+
+    inline void sf_append_digits__(std::string &str, unsigned int value, int width) {
+        char buffer[10];
+        for (auto i = width - 1; i >= 0; --i)
+        {
+            buffer[i] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+        str.append(buffer, static_cast<size_t>(width));
+    }
+
+    inline const std::string &sf_log_time_str(time_t tt) {
+        thread_local sf_time_str_cache_t__ cache;
+        if (cache.second != tt)
+        {
+            std::tm tm_d{};
+#ifdef _MSC_VER
+            localtime_s(&tm_d, &tt);
+#else
+            localtime_r(&tt, &tm_d);
+#endif
+            cache.str.clear();
+            sf_append_digits__(cache.str, static_cast<unsigned int>(tm_d.tm_year + 1900), 4);
+            cache.str += '-';
+            sf_append_digits__(cache.str, static_cast<unsigned int>(tm_d.tm_mon + 1), 2);
+            cache.str += '-';
+            sf_append_digits__(cache.str, static_cast<unsigned int>(tm_d.tm_mday), 2);
+            cache.str += ' ';
+            sf_append_digits__(cache.str, static_cast<unsigned int>(tm_d.tm_hour), 2);
+            cache.str += ':';
+            sf_append_digits__(cache.str, static_cast<unsigned int>(tm_d.tm_min), 2);
+            cache.str += ':';
+            sf_append_digits__(cache.str, static_cast<unsigned int>(tm_d.tm_sec), 2);
+            cache.second = tt;
+        }
+        return cache.str;
+    }
+
+    inline std::string sf_log_time_str(long long ticks, int precision) {
+        constexpr long long ns_per_second = 1000000000LL;
+        auto second = ticks / ns_per_second;
+        auto sub_second = ticks % ns_per_second;
+        if (sub_second < 0)
+        {
+            --second;
+            sub_second += ns_per_second;
+        }
+        std::string ret = sf_log_time_str(static_cast<time_t>(second));
+        if (precision > 0)
+        {
+            if (precision > 9)
+            {
+                precision = 9;
+            }
+            for (auto i = precision; i < 9; ++i)
+            {
+                sub_second /= 10;
+            }
+            ret += '.';
+            sf_append_digits__(ret, static_cast<unsigned int>(sub_second), precision);
+        }
+        return ret;
+    }
+
+    inline const std::string &sf_http_gmt_time_str(time_t tt) {
+        // NOTE 不使用strftime的%a、%b，避免受locale影响
+        static constexpr char week_days[][4] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+        static constexpr char months[][4] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                             "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+        thread_local sf_time_str_cache_t__ cache;
+        if (cache.second != tt)
+        {
+            std::tm tm_d{};
+#ifdef _MSC_VER
+            gmtime_s(&tm_d, &tt);
+#else
+            gmtime_r(&tt, &tm_d);
+#endif
+            cache.str.clear();
+            cache.str += week_days[tm_d.tm_wday];
+            cache.str += ", ";
+            sf_append_digits__(cache.str, static_cast<unsigned int>(tm_d.tm_mday), 2);
+            cache.str += ' ';
+            cache.str += months[tm_d.tm_mon];
+            cache.str += ' ';
+            sf_append_digits__(cache.str, static_cast<unsigned int>(tm_d.tm_year + 1900), 4);
+            cache.str += ' ';
+            sf_append_digits__(cache.str, static_cast<unsigned int>(tm_d.tm_hour), 2);
+            cache.str += ':';
+            sf_append_digits__(cache.str, static_cast<unsigned int>(tm_d.tm_min), 2);
+            cache.str += ':';
+            sf_append_digits__(cache.str, static_cast<unsigned int>(tm_d.tm_sec), 2);
+            cache.str += " GMT";
+            cache.second = tt;
+        }
+        return cache.str;
+    }
+}
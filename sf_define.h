@@ -75,6 +75,24 @@ namespace skyfire {
     // RPC响应包类型
     constexpr int RPC_RES_TYPE = 0x0000fffe;
 
+    // RPC错误响应包类型（数据为sf_rpc_err_context_t）
+    constexpr int RPC_ERR_TYPE = 0x0000fffd;
+
+    // RPC按函数编号请求包类型（数据为sf_rpc_req_id_view_t）
+    constexpr int RPC_REQ_ID_TYPE = 0x0000fffc;
+
+    // RPC函数表请求包类型（无数据）
+    constexpr int RPC_TABLE_REQ_TYPE = 0x0000fffb;
+
+    // RPC函数表响应包类型（数据为std::vector<sf_rpc_method_t>）
+    constexpr int RPC_TABLE_RES_TYPE = 0x0000fffa;
+
+    // RPC压缩握手请求包类型（无数据，扩展标志中设置sf_pkg_ex_accept_compress）
+    constexpr int RPC_COMPRESS_REQ_TYPE = 0x0000fff9;
+
+    // RPC压缩握手响应包类型（无数据，服务端开启了压缩时回复）
+    constexpr int RPC_COMPRESS_ACK_TYPE = 0x0000fff8;
+
 
 
 
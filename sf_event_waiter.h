@@ -82,8 +82,8 @@ namespace skyfire {
      * @tparam ARGS 参数表
      * @return 等待器
      */
-    template<typename...ARGS>
+    template<typename...ARGS, typename..._Other>
     std::shared_ptr<sf_event_waiter<ARGS...>>
-    sf_make_waiter(const std::vector<std::tuple<std::function<void(ARGS...)>, bool, int>> &);
+    sf_make_waiter(const sf_rcu<std::vector<std::tuple<std::shared_ptr<const std::function<void(ARGS...)>>, _Other...>>> &);
 
 }
@@ -52,9 +52,9 @@ namespace skyfire {
     sf_event_waiter<ARGS...>::sf_event_waiter() {
     }
 
-    template<typename... ARGS>
+    template<typename... ARGS, typename..._Other>
     std::shared_ptr<sf_event_waiter<ARGS...>>
-    sf_make_waiter(const std::vector<std::tuple<std::function<void(ARGS...)>, bool, int>> &) {
+    sf_make_waiter(const sf_rcu<std::vector<std::tuple<std::shared_ptr<const std::function<void(ARGS...)>>, _Other...>>> &) {
         return std::make_shared<sf_event_waiter<ARGS...>>();
     }
 }
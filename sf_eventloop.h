@@ -1,4 +1,3 @@
-
 /**
 * @version 1.0.0
 * @author skyfire
@@ -20,6 +19,17 @@
 #include <condition_variable>
 #include <mutex>
 #include <atomic>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#endif
 
 #include "sf_single_instance.hpp"
 #include "sf_msg_queue.hpp"
@@ -27,19 +37,95 @@
 
 namespace skyfire
 {
+    /**
+     *  @brief 事件循环模式
+     */
+    enum class sf_eventloop_mode
+    {
+        global_queue = 0,                   // 处理全局消息队列（默认）
+        private_queue = 1,                  // 拥有独立的消息队列，仅处理移动到此循环的对象的消息
+        reactor = 2                         // 基于epoll的反应堆（仅Linux）：独立消息队列（eventfd）、定时器（timerfd）和socket在同一线程中处理
+    };
+
     /**
      *  @brief 消息循环
      */
     class sf_eventloop : sf_nocopy<>
     {
     private:
-        sf_msg_queue* __p_msg_queue__ = sf_msg_queue::get_instance();
+        std::shared_ptr<sf_msg_queue> __p_msg_queue__;
         std::atomic<int> running__ { 0 };
+        sf_eventloop_mode mode__;
+#ifndef _WIN32
+        int epoll_fd__ = -1;
+        int event_fd__ = -1;
+        std::unordered_map<int, std::shared_ptr<std::function<void(unsigned int)>>> fd_callback__;
+        std::mutex mu_fd_callback__;
+
+        void exec_reactor__();
+
+        void process_msg__();
+#endif
     public:
         /**
          * @brief sf_eventloop 构造一个事件循环对象
+         * @param mode 事件循环模式
+         */
+        explicit sf_eventloop(sf_eventloop_mode mode = sf_eventloop_mode::global_queue);
+
+        ~sf_eventloop();
+
+        /**
+         * @brief get_msg_queue 获取事件循环处理的消息队列
+         * @return 消息队列
+         */
+        std::shared_ptr<sf_msg_queue> get_msg_queue() const;
+
+        /**
+         * @brief is_reactor 是否是反应堆模式的事件循环
+         * @return 是否是反应堆
+         */
+        bool is_reactor() const;
+
+#ifndef _WIN32
+        /**
+         * @brief add_fd 向反应堆注册文件描述符（仅反应堆模式有效，回调在事件循环线程中执行）
+         * @param fd 文件描述符
+         * @param events epoll事件（如EPOLLIN | EPOLLET）
+         * @param callback 回调函数，参数为触发的epoll事件
+         * @return 是否成功
+         */
+        bool add_fd(int fd, unsigned int events, std::function<void(unsigned int)> callback);
+
+        /**
+         * @brief modify_fd 修改文件描述符关注的事件
+         * @param fd 文件描述符
+         * @param events epoll事件
+         * @return 是否成功
+         */
+        bool modify_fd(int fd, unsigned int events);
+
+        /**
+         * @brief remove_fd 从反应堆移除文件描述符（不会关闭文件描述符）
+         * @param fd 文件描述符
+         */
+        void remove_fd(int fd);
+
+        /**
+         * @brief add_timer 添加定时器（基于timerfd，回调在事件循环线程中执行）
+         * @param ms 毫秒
+         * @param once 是否是一次性定时器
+         * @param callback 回调函数
+         * @return 定时器id，失败返回-1
+         */
+        int add_timer(int ms, bool once, std::function<void()> callback);
+
+        /**
+         * @brief remove_timer 移除定时器
+         * @param timer_id 定时器id
          */
-        sf_eventloop();
+        void remove_timer(int timer_id);
+#endif
 
         /**
          * @brief exec 执行事件循环
@@ -1,4 +1,3 @@
-
 /**
 * @version 1.0.0
 * @author skyfire
@@ -22,8 +21,47 @@
 namespace skyfire
 {
 
-    inline sf_eventloop::sf_eventloop() {
+    inline sf_eventloop::sf_eventloop(sf_eventloop_mode mode) :
+            __p_msg_queue__(mode == sf_eventloop_mode::global_queue ? sf_msg_queue::get_global_queue()
+                                                                    : std::make_shared<sf_msg_queue>()),
+            mode__(mode) {
+#ifndef _WIN32
+        if (mode__ == sf_eventloop_mode::reactor)
+        {
+            epoll_fd__ = epoll_create1(EPOLL_CLOEXEC);
+            event_fd__ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.fd = event_fd__;
+            epoll_ctl(epoll_fd__, EPOLL_CTL_ADD, event_fd__, &ev);
+            auto efd = event_fd__;
+            __p_msg_queue__->set_notify_func([efd] {
+                uint64_t one = 1;
+                auto ret = ::write(efd, &one, sizeof(one));
+                (void) ret;
+            });
+        }
+#endif
+    }
+
+    inline sf_eventloop::~sf_eventloop() {
+#ifndef _WIN32
+        if (mode__ == sf_eventloop_mode::reactor)
+        {
+            // NOTE 消息队列可能被对象继续持有，解除与eventfd的关联
+            __p_msg_queue__->set_notify_func(nullptr);
+            ::close(event_fd__);
+            ::close(epoll_fd__);
+        }
+#endif
+    }
+
+    inline std::shared_ptr<sf_msg_queue> sf_eventloop::get_msg_queue() const {
+        return __p_msg_queue__;
+    }
 
+    inline bool sf_eventloop::is_reactor() const {
+        return mode__ == sf_eventloop_mode::reactor;
     }
 
     inline void sf_eventloop::quit() {
@@ -41,6 +79,13 @@ namespace skyfire
 
     inline void sf_eventloop::exec() {
         running__ = true;
+#ifndef _WIN32
+        if (mode__ == sf_eventloop_mode::reactor)
+        {
+            exec_reactor__();
+            return;
+        }
+#endif
         while(true)
         {
             if(running__ == false)
@@ -66,5 +111,167 @@ namespace skyfire
         }
     }
 
+#ifndef _WIN32
+
+    inline void sf_eventloop::process_msg__() {
+        uint64_t count = 0;
+        auto ret = ::read(event_fd__, &count, sizeof(count));
+        (void) ret;
+        while (running__)
+        {
+            auto func = __p_msg_queue__->take();
+            if (!func)
+            {
+                break;
+            }
+            func();
+        }
+    }
+
+    inline void sf_eventloop::exec_reactor__() {
+        constexpr int max_events = 64;
+        epoll_event evs[max_events];
+        // NOTE 处理exec之前投递的消息
+        process_msg__();
+        while (running__)
+        {
+            auto count = epoll_wait(epoll_fd__, evs, max_events, -1);
+            if (count == -1)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                break;
+            }
+            for (auto i = 0; i < count && running__; ++i)
+            {
+                if (evs[i].data.fd == event_fd__)
+                {
+                    process_msg__();
+                    continue;
+                }
+                std::shared_ptr<std::function<void(unsigned int)>> callback;
+                {
+                    std::lock_guard<std::mutex> lck(mu_fd_callback__);
+                    auto iter = fd_callback__.find(evs[i].data.fd);
+                    if (iter == fd_callback__.end())
+                    {
+                        continue;
+                    }
+                    callback = iter->second;
+                }
+                (*callback)(evs[i].events);
+            }
+        }
+    }
+
+    inline bool sf_eventloop::add_fd(int fd, unsigned int events, std::function<void(unsigned int)> callback) {
+        if (mode__ != sf_eventloop_mode::reactor)
+        {
+            return false;
+        }
+        {
+            std::lock_guard<std::mutex> lck(mu_fd_callback__);
+            fd_callback__[fd] = std::make_shared<std::function<void(unsigned int)>>(std::move(callback));
+        }
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.fd = fd;
+        if (epoll_ctl(epoll_fd__, EPOLL_CTL_ADD, fd, &ev) == -1)
+        {
+            std::lock_guard<std::mutex> lck(mu_fd_callback__);
+            fd_callback__.erase(fd);
+            return false;
+        }
+        return true;
+    }
+
+    inline bool sf_eventloop::modify_fd(int fd, unsigned int events) {
+        if (mode__ != sf_eventloop_mode::reactor)
+        {
+            return false;
+        }
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.fd = fd;
+        return epoll_ctl(epoll_fd__, EPOLL_CTL_MOD, fd, &ev) != -1;
+    }
+
+    inline void sf_eventloop::remove_fd(int fd) {
+        if (mode__ != sf_eventloop_mode::reactor)
+        {
+            return;
+        }
+        epoll_event ev{};
+        epoll_ctl(epoll_fd__, EPOLL_CTL_DEL, fd, &ev);
+        std::lock_guard<std::mutex> lck(mu_fd_callback__);
+        fd_callback__.erase(fd);
+    }
+
+    inline int sf_eventloop::add_timer(int ms, bool once, std::function<void()> callback) {
+        if (mode__ != sf_eventloop_mode::reactor)
+        {
+            return -1;
+        }
+        auto timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (timer_fd == -1)
+        {
+            return -1;
+        }
+        itimerspec spec{};
+        spec.it_value.tv_sec = ms / 1000;
+        spec.it_value.tv_nsec = (ms % 1000) * 1000000L;
+        if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0)
+        {
+            // NOTE 全0会解除定时器，最小设置为1纳秒
+            spec.it_value.tv_nsec = 1;
+        }
+        if (!once)
+        {
+            spec.it_interval = spec.it_value;
+        }
+        if (timerfd_settime(timer_fd, 0, &spec, nullptr) == -1)
+        {
+            ::close(timer_fd);
+            return -1;
+        }
+        auto ok = add_fd(timer_fd, EPOLLIN, [=](unsigned int) {
+            uint64_t expirations = 0;
+            if (::read(timer_fd, &expirations, sizeof(expirations)) != sizeof(expirations))
+            {
+                return;
+            }
+            if (once)
+            {
+                remove_timer(timer_fd);
+            }
+            callback();
+        });
+        if (!ok)
+        {
+            ::close(timer_fd);
+            return -1;
+        }
+        return timer_fd;
+    }
+
+    inline void sf_eventloop::remove_timer(int timer_id) {
+        std::shared_ptr<std::function<void(unsigned int)>> callback;
+        {
+            std::lock_guard<std::mutex> lck(mu_fd_callback__);
+            auto iter = fd_callback__.find(timer_id);
+            if (iter == fd_callback__.end())
+            {
+                return;
+            }
+            // NOTE 回调可能正在执行（一次性定时器在回调中移除自身），延长其生命周期
+            callback = iter->second;
+        }
+        remove_fd(timer_id);
+        ::close(timer_id);
+    }
+
+#endif
 
 }
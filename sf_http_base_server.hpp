@@ -440,7 +440,7 @@ namespace skyfire
         auto curr_read_pos = file.begin;
         while (curr_read_pos < file.end - buffer_size)
             {
-                sf_debug("read file", curr_read_pos, file.end);
+                sf_debug_every_ms(1000, "read file", curr_read_pos, file.end);
                 fi.read(buffer.data(), buffer_size);
                 server__->send(sock, buffer);
                 curr_read_pos += buffer_size;
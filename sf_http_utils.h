@@ -23,6 +23,7 @@
 #include "sf_type.h"
 #include "sf_http_request_line.h"
 #include "sf_serialize_binary.hpp"
+#include "sf_clock.hpp"
 
 
 
@@ -147,7 +148,7 @@ namespace skyfire
 
 
     /**
-     * 生成http时间字符串
+     * 生成http时间字符串（GMT）
      * @param tp 时间点
      * @return http时间字符串
      */
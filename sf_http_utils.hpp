@@ -145,12 +145,7 @@ namespace skyfire
 
     inline std::string sf_make_http_time_str(const std::chrono::system_clock::time_point &tp)
     {
-        auto raw_time = std::chrono::system_clock::to_time_t(tp);
-        std::tm *time_info = std::localtime(&raw_time);
-        std::string ret(128,'\0');
-        strftime(ret.data(),128,"%a, %d %b %Y %T GMT",time_info);
-        ret.resize(strlen(ret.c_str()));
-        return ret;
+        return sf_http_gmt_time_str(std::chrono::system_clock::to_time_t(tp));
     }
 
     inline byte_array read_file(const std::string &filename, size_t max_size)
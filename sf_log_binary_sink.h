@@ -0,0 +1,119 @@
+/**
+* @version 1.0.0
+* @author skyfire
+* @mail skyfireitdiy@hotmail.com
+* @see http://github.com/skyfireitdiy/sflib
+* @file sf_log_binary_sink.h
+
+* sflib第一版本发布
+* 版本号1.0.0
+* 发布日期：2018-10-22
+*/
+
+/*
+ * sf_log_binary_sink 二进制日志输出
+ * 运行时不格式化文本：日志位置与线程只在第一次出现时写入字典，之后的记录只包含编号、时间与参数的原始字节，
+ * 由sf_log_decode工具离线还原为文本或json
+ *
+ * 文件由若干条目组成，每个条目以一个字节的类型开始，后续字段的布局与sf_serialize_binary相同
+ * （数值为内存中的原始字节，字符串为size_t长度加内容）：
+ *  header   : char[8] magic, uint32 version                    （每个文件开头，之后字典重新编号）
+ *  location : uint32 id, int32 level, int32 line, string file, string func
+ *  thread   : uint32 id, string thread
+ *  record   : uint32 location_id, uint32 thread_id, int64 ticks, uint32 arg_count, 参数（类型标记 + 数据）
+ *  text     : int32 level, string time, uint32 thread_id, string file, int32 line, string func, string msg
+ * 本文件只依赖标准库，可以随sf_logger独立使用
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "sf_log_ring.h"
+#include "sf_log_file_sink.h"
+
+namespace skyfire
+{
+    /**
+     *  @brief 二进制日志文件标识
+     */
+    constexpr char sf_log_binary_magic[8] = {'S', 'F', 'L', 'O', 'G', 'B', 'I', 'N'};
+
+    /**
+     *  @brief 二进制日志格式版本
+     */
+    constexpr unsigned int sf_log_binary_version = 1;
+
+    /**
+     *  @brief 二进制日志条目类型
+     */
+    enum class sf_log_binary_entry : unsigned char
+    {
+        header = 0,         // 文件头
+        location = 1,       // 日志位置字典
+        thread = 2,         // 线程字典
+        record = 3,         // 日志记录
+        text = 4            // 已格式化的日志（非日志宏打印的日志）
+    };
+
+    /**
+     *  @brief 二进制日志输出，数据写入sf_log_file_sink（批量写入、切分等由其负责，切分后字典在新文件中重新写入）
+     */
+    class sf_log_binary_sink
+    {
+    private:
+        std::shared_ptr<sf_log_file_sink> file__;
+        std::unordered_map<const sf_log_location_t *, unsigned int> location_ids__;
+        std::unordered_map<std::thread::id, unsigned int> thread_ids__;
+        bool header_written__ = false;
+        unsigned long long rotate_count__ = 0;
+        std::string chunk__;
+
+        void reset__();
+
+        void append_header__();
+
+        unsigned int thread_id__(std::thread::id id);
+
+        template<typename T>
+        void append__(const T &value);
+
+        void append__(const char *str, size_t len);
+
+        template<typename _Func>
+        void write_chunk__(_Func build);
+
+    public:
+        /**
+         * @param file 文件输出
+         */
+        explicit sf_log_binary_sink(std::shared_ptr<sf_log_file_sink> file);
+
+        /**
+         * 文件是否打开成功
+         */
+        bool is_open() const;
+
+        /**
+         * 写入日志宏打印的记录
+         * @param header 记录头
+         * @param thread_id 打印日志的线程
+         * @param args 编码后的参数
+         */
+        void write(const sf_log_record_header_t &header, std::thread::id thread_id, const char *args);
+
+        /**
+         * 写入已格式化的日志
+         */
+        void write_text(int level, const std::string &time, std::thread::id thread_id, const std::string &file,
+                        int line, const std::string &func, const std::string &msg);
+
+        /**
+         * 将缓冲区写入文件
+         */
+        void flush();
+    };
+}
@@ -0,0 +1,160 @@
+/**
+* @version 1.0.0
+* @author skyfire
+* @mail skyfireitdiy@hotmail.com
+* @see http://github.com/skyfireitdiy/sflib
+* @file sf_log_binary_sink.hpp
+
+* sflib第一版本发布
+* 版本号1.0.0
+* 发布日期：2018-10-22
+*/
+
+/*
+ * sf_log_binary_sink 二进制日志输出
+ */
+
+#pragma once
+
+#include "sf_log_binary_sink.h"
+#include "sf_log_ring.hpp"
+#include "sf_log_file_sink.hpp"
+
+#include <cstdint>
+#include <sstream>
+
+namespace skyfire
+{
+    inline sf_log_binary_sink::sf_log_binary_sink(std::shared_ptr<sf_log_file_sink> file) : file__(std::move(file)) {
+        if (file__)
+        {
+            rotate_count__ = file__->rotate_count();
+        }
+    }
+
+    inline bool sf_log_binary_sink::is_open() const {
+        return file__ && file__->is_open();
+    }
+
+    inline void sf_log_binary_sink::reset__() {
+        location_ids__.clear();
+        thread_ids__.clear();
+        header_written__ = false;
+    }
+
+    template<typename T>
+    inline void sf_log_binary_sink::append__(const T &value) {
+        chunk__.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+    inline void sf_log_binary_sink::append__(const char *str, size_t len) {
+        append__(len);
+        chunk__.append(str, len);
+    }
+
+    inline void sf_log_binary_sink::append_header__() {
+        if (!header_written__)
+        {
+            append__(sf_log_binary_entry::header);
+            chunk__.append(sf_log_binary_magic, sizeof(sf_log_binary_magic));
+            append__(static_cast<std::uint32_t>(sf_log_binary_version));
+            header_written__ = true;
+        }
+    }
+
+    inline unsigned int sf_log_binary_sink::thread_id__(std::thread::id id) {
+        auto iter = thread_ids__.find(id);
+        if (iter != thread_ids__.end())
+        {
+            return iter->second;
+        }
+        auto thread_id = static_cast<unsigned int>(thread_ids__.size());
+        thread_ids__.emplace(id, thread_id);
+        std::ostringstream oss;
+        oss << id;
+        auto str = oss.str();
+        append__(sf_log_binary_entry::thread);
+        append__(static_cast<std::uint32_t>(thread_id));
+        append__(str.data(), str.size());
+        return thread_id;
+    }
+
+    template<typename _Func>
+    inline void sf_log_binary_sink::write_chunk__(_Func build) {
+        if (!is_open())
+        {
+            return;
+        }
+        // NOTE 文件已切分（按时间切分发生在flush中）时，新文件需要重新写入文件头与字典
+        if (file__->rotate_count() != rotate_count__)
+        {
+            reset__();
+        }
+        chunk__.clear();
+        build();
+        if (file__->rotate_if_full(chunk__.size()))
+        {
+            reset__();
+            chunk__.clear();
+            build();
+        }
+        file__->write(chunk__.data(), chunk__.size());
+        rotate_count__ = file__->rotate_count();
+    }
+
+    inline void sf_log_binary_sink::write(const sf_log_record_header_t &header, std::thread::id thread_id,
+                                          const char *args) {
+        write_chunk__([&] {
+            append_header__();
+            auto location = header.location;
+            auto iter = location_ids__.find(location);
+            unsigned int location_id;
+            if (iter != location_ids__.end())
+            {
+                location_id = iter->second;
+            }
+            else
+            {
+                location_id = static_cast<unsigned int>(location_ids__.size());
+                location_ids__.emplace(location, location_id);
+                append__(sf_log_binary_entry::location);
+                append__(static_cast<std::uint32_t>(location_id));
+                append__(static_cast<std::int32_t>(location->level));
+                append__(static_cast<std::int32_t>(location->line));
+                append__(location->file, std::strlen(location->file));
+                append__(location->func, std::strlen(location->func));
+            }
+            auto thread = thread_id__(thread_id);
+            append__(sf_log_binary_entry::record);
+            append__(static_cast<std::uint32_t>(location_id));
+            append__(static_cast<std::uint32_t>(thread));
+            append__(static_cast<std::int64_t>(header.ticks));
+            append__(static_cast<std::uint32_t>(header.arg_count));
+            chunk__.append(args, sf_log_args_size(args, header.arg_count));
+        });
+    }
+
+    inline void sf_log_binary_sink::write_text(int level, const std::string &time, std::thread::id thread_id,
+                                               const std::string &file, int line, const std::string &func,
+                                               const std::string &msg) {
+        write_chunk__([&] {
+            append_header__();
+            auto thread = thread_id__(thread_id);
+            append__(sf_log_binary_entry::text);
+            append__(static_cast<std::int32_t>(level));
+            append__(time.data(), time.size());
+            append__(static_cast<std::uint32_t>(thread));
+            append__(file.data(), file.size());
+            append__(static_cast<std::int32_t>(line));
+            append__(func.data(), func.size());
+            append__(msg.data(), msg.size());
+        });
+    }
+
+    inline void sf_log_binary_sink::flush() {
+        if (is_open())
+        {
+            file__->flush();
+        }
+    }
+}
@@ -0,0 +1,156 @@
+/**
+* @version 1.0.0
+* @author skyfire
+* @mail skyfireitdiy@hotmail.com
+* @see http://github.com/skyfireitdiy/sflib
+* @file sf_log_file_sink.h
+
+* sflib第一版本发布
+* 版本号1.0.0
+* 发布日期：2018-10-22
+*/
+
+/*
+ * sf_log_file_sink 日志文件输出
+ * 日志先写入对齐的大块缓冲区，缓冲区写满或日志线程处理完一批日志时，用writev一次写入文件
+ * 支持按大小、按时间切分文件（保留指定数量的历史文件），后台压缩历史文件，以及fsync策略
+ * 压缩需要定义SF_LOG_ENABLE_ZLIB并链接zlib（CMake为链接zlib的目标定义），其余部分只依赖标准库与系统调用，可以随sf_logger独立使用
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace skyfire
+{
+    /**
+     *  @brief 日志文件同步（fsync）策略
+     */
+    enum class sf_log_fsync_policy
+    {
+        never = 0,          // 不主动同步，由操作系统决定
+        interval = 1,       // 距上次同步超过指定时间后同步
+        bytes = 2           // 距上次同步写入超过指定字节数后同步
+    };
+
+    /**
+     *  @brief 日志文件输出配置
+     */
+    struct sf_log_file_sink_config_t
+    {
+        std::string filename;                                           // 文件名
+        size_t buffer_size = 64 * 1024;                                 // 单块缓冲区大小（向上对齐到4096）
+        size_t buffer_count = 16;                                       // 缓冲区块数，全部写满时写入文件
+        size_t max_file_size = 0;                                       // 单个文件最大字节数，0表示不按大小切分
+        std::chrono::seconds rotate_interval{0};                        // 切分间隔，0表示不按时间切分
+        size_t max_history = 0;                                         // 保留的历史文件数量，0表示全部保留
+        bool compress = false;                                          // 是否压缩历史文件（需要SF_LOG_ENABLE_ZLIB，否则打开失败）
+        sf_log_fsync_policy fsync_policy = sf_log_fsync_policy::never;  // 同步策略
+        std::chrono::milliseconds fsync_interval{1000};                 // 同步间隔（interval策略）
+        size_t fsync_bytes = 4 * 1024 * 1024;                           // 同步字节数（bytes策略）
+    };
+
+    /**
+     *  @brief 日志文件输出
+     *  历史文件命名为 filename.1、filename.2 ...（压缩后追加.gz），序号越大越旧
+     */
+    class sf_log_file_sink
+    {
+    private:
+        struct sf_aligned_free_t__
+        {
+            void operator()(char *p) const;
+        };
+
+        sf_log_file_sink_config_t config__;
+        int fd__ = -1;
+        size_t file_size__ = 0;
+        std::chrono::steady_clock::time_point open_time__;
+
+        std::vector<std::unique_ptr<char[], sf_aligned_free_t__>> buffers__;
+        size_t current_buffer__ = 0;
+        size_t current_size__ = 0;
+
+        size_t unsynced_bytes__ = 0;
+        std::chrono::steady_clock::time_point last_sync_time__;
+        unsigned long long written_bytes__ = 0;
+        unsigned long long rotate_count__ = 0;
+
+        // 后台线程：切分后的文件改名与压缩
+        std::mutex archive_mu__;
+        std::condition_variable archive_cond__;
+        std::deque<std::string> archive_queue__;
+        bool archive_run__ = true;
+        std::thread archive_thread__;
+        unsigned long long pending_seq__ = 0;
+
+        bool open_file__();
+
+        void write_buffers__();
+
+        void sync__();
+
+        void rotate__();
+
+        void archive__(const std::string &pending_name);
+
+        std::string history_name__(size_t index, bool compressed) const;
+
+        static bool compress_file__(const std::string &src, const std::string &dst);
+
+    public:
+        /**
+         * @param config 配置
+         */
+        explicit sf_log_file_sink(sf_log_file_sink_config_t config);
+
+        ~sf_log_file_sink();
+
+        sf_log_file_sink(const sf_log_file_sink &) = delete;
+
+        sf_log_file_sink &operator=(const sf_log_file_sink &) = delete;
+
+        /**
+         * 文件是否打开成功（要求压缩但未定义SF_LOG_ENABLE_ZLIB时不打开文件，返回false）
+         */
+        bool is_open() const;
+
+        /**
+         * 写入数据（先写入缓冲区）
+         * @param data 数据
+         * @param size 长度
+         */
+        void write(const char *data, size_t size);
+
+        /**
+         * 写入指定长度的数据会超过文件大小上限时先切分文件
+         * （需要保证一段数据完整写入同一个文件时，在write之前调用）
+         * @param size 即将写入的长度
+         * @return 是否进行了切分
+         */
+        bool rotate_if_full(size_t size);
+
+        /**
+         * 将缓冲区写入文件，并按策略同步、检查是否需要按时间切分
+         */
+        void flush();
+
+        /**
+         * 已写入文件的字节数
+         */
+        unsigned long long written_bytes() const;
+
+        /**
+         * 切分次数
+         */
+        unsigned long long rotate_count() const;
+    };
+}
@@ -0,0 +1,390 @@
+/**
+* @version 1.0.0
+* @author skyfire
+* @mail skyfireitdiy@hotmail.com
+* @see http://github.com/skyfireitdiy/sflib
+* @file sf_log_file_sink.hpp
+
+* sflib第一版本发布
+* 版本号1.0.0
+* 发布日期：2018-10-22
+*/
+
+/*
+ * sf_log_file_sink 日志文件输出
+ */
+
+#pragma once
+
+#include "sf_log_file_sink.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#include <sys/uio.h>
+#endif
+
+#ifdef SF_LOG_ENABLE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace skyfire
+{
+    inline void sf_log_file_sink::sf_aligned_free_t__::operator()(char *p) const {
+#ifdef _MSC_VER
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+
+    inline sf_log_file_sink::sf_log_file_sink(sf_log_file_sink_config_t config) : config__(std::move(config)) {
+        constexpr size_t align = 4096;
+        auto size = (std::max<size_t>(config__.buffer_size, align) + align - 1) / align * align;
+        config__.buffer_size = size;
+        config__.buffer_count = std::max<size_t>(config__.buffer_count, 1);
+        for (size_t i = 0; i < config__.buffer_count; ++i)
+        {
+#ifdef _MSC_VER
+            buffers__.emplace_back(static_cast<char *>(_aligned_malloc(size, align)));
+#else
+            buffers__.emplace_back(static_cast<char *>(std::aligned_alloc(align, size)));
+#endif
+        }
+#ifndef SF_LOG_ENABLE_ZLIB
+        // NOTE 不支持压缩时不能静默地保留未压缩的历史文件，打开失败
+        if (config__.compress)
+        {
+            return;
+        }
+#endif
+        if (!open_file__())
+        {
+            return;
+        }
+        last_sync_time__ = open_time__;
+        if (config__.max_file_size != 0 || config__.rotate_interval.count() != 0)
+        {
+            archive_thread__ = std::thread([this] {
+                std::unique_lock<std::mutex> lck(archive_mu__);
+                while (true)
+                {
+                    archive_cond__.wait(lck, [this] {
+                        return !archive_queue__.empty() || !archive_run__;
+                    });
+                    if (archive_queue__.empty())
+                    {
+                        break;
+                    }
+                    auto pending_name = std::move(archive_queue__.front());
+                    archive_queue__.pop_front();
+                    lck.unlock();
+                    archive__(pending_name);
+                    lck.lock();
+                }
+            });
+        }
+    }
+
+    inline sf_log_file_sink::~sf_log_file_sink() {
+        if (fd__ != -1)
+        {
+            write_buffers__();
+            if (config__.fsync_policy != sf_log_fsync_policy::never)
+            {
+                sync__();
+            }
+#ifdef _WIN32
+            _close(fd__);
+#else
+            close(fd__);
+#endif
+        }
+        if (archive_thread__.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lck(archive_mu__);
+                archive_run__ = false;
+            }
+            archive_cond__.notify_one();
+            archive_thread__.join();
+        }
+    }
+
+    inline bool sf_log_file_sink::open_file__() {
+#ifdef _WIN32
+        fd__ = _open(config__.filename.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+        fd__ = open(config__.filename.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+#endif
+        if (fd__ == -1)
+        {
+            return false;
+        }
+        struct stat st{};
+        file_size__ = fstat(fd__, &st) == 0 ? static_cast<size_t>(st.st_size) : 0;
+        open_time__ = std::chrono::steady_clock::now();
+        return true;
+    }
+
+    inline bool sf_log_file_sink::is_open() const {
+        return fd__ != -1;
+    }
+
+    inline void sf_log_file_sink::write(const char *data, size_t size) {
+        if (fd__ == -1)
+        {
+            return;
+        }
+        rotate_if_full(size);
+        while (size != 0)
+        {
+            auto len = std::min(size, config__.buffer_size - current_size__);
+            std::memcpy(buffers__[current_buffer__].get() + current_size__, data, len);
+            current_size__ += len;
+            data += len;
+            size -= len;
+            if (current_size__ == config__.buffer_size)
+            {
+                if (current_buffer__ + 1 == buffers__.size())
+                {
+                    write_buffers__();
+                }
+                else
+                {
+                    ++current_buffer__;
+                    current_size__ = 0;
+                }
+            }
+        }
+    }
+
+    inline bool sf_log_file_sink::rotate_if_full(size_t size) {
+        if (fd__ == -1 || config__.max_file_size == 0)
+        {
+            return false;
+        }
+        auto pending = file_size__ + current_buffer__ * config__.buffer_size + current_size__;
+        if (pending != 0 && pending + size > config__.max_file_size)
+        {
+            rotate__();
+            return true;
+        }
+        return false;
+    }
+
+    inline void sf_log_file_sink::write_buffers__() {
+        auto total = current_buffer__ * config__.buffer_size + current_size__;
+        if (total == 0)
+        {
+            return;
+        }
+#ifdef _WIN32
+        for (size_t i = 0; i <= current_buffer__ && i < buffers__.size(); ++i)
+        {
+            auto len = i == current_buffer__ ? current_size__ : config__.buffer_size;
+            _write(fd__, buffers__[i].get(), static_cast<unsigned int>(len));
+        }
+#else
+        std::vector<iovec> iov;
+        for (size_t i = 0; i <= current_buffer__ && i < buffers__.size(); ++i)
+        {
+            auto len = i == current_buffer__ ? current_size__ : config__.buffer_size;
+            if (len != 0)
+            {
+                iov.push_back({buffers__[i].get(), len});
+            }
+        }
+        size_t index = 0;
+        while (index < iov.size())
+        {
+            auto ret = writev(fd__, iov.data() + index, static_cast<int>(iov.size() - index));
+            if (ret < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                break;
+            }
+            // NOTE 部分写入时跳过已写入的部分继续写
+            auto written = static_cast<size_t>(ret);
+            while (index < iov.size() && written >= iov[index].iov_len)
+            {
+                written -= iov[index].iov_len;
+                ++index;
+            }
+            if (index < iov.size())
+            {
+                iov[index].iov_base = static_cast<char *>(iov[index].iov_base) + written;
+                iov[index].iov_len -= written;
+            }
+        }
+#endif
+        file_size__ += total;
+        unsynced_bytes__ += total;
+        written_bytes__ += total;
+        current_buffer__ = 0;
+        current_size__ = 0;
+        if (config__.fsync_policy == sf_log_fsync_policy::bytes && unsynced_bytes__ >= config__.fsync_bytes)
+        {
+            sync__();
+        }
+    }
+
+    inline void sf_log_file_sink::sync__() {
+#ifdef _WIN32
+        _commit(fd__);
+#elif defined(__APPLE__)
+        fsync(fd__);
+#else
+        fdatasync(fd__);
+#endif
+        unsynced_bytes__ = 0;
+        last_sync_time__ = std::chrono::steady_clock::now();
+    }
+
+    inline void sf_log_file_sink::flush() {
+        if (fd__ == -1)
+        {
+            return;
+        }
+        write_buffers__();
+        if ((config__.fsync_policy == sf_log_fsync_policy::interval && unsynced_bytes__ != 0)
+            || config__.rotate_interval.count() != 0)
+        {
+            auto now = std::chrono::steady_clock::now();
+            if (config__.fsync_policy == sf_log_fsync_policy::interval && unsynced_bytes__ != 0
+                && now - last_sync_time__ >= config__.fsync_interval)
+            {
+                sync__();
+            }
+            if (config__.rotate_interval.count() != 0 && file_size__ != 0
+                && now - open_time__ >= config__.rotate_interval)
+            {
+                rotate__();
+            }
+        }
+    }
+
+    inline void sf_log_file_sink::rotate__() {
+        write_buffers__();
+        if (config__.fsync_policy != sf_log_fsync_policy::never)
+        {
+            sync__();
+        }
+#ifdef _WIN32
+        _close(fd__);
+#else
+        close(fd__);
+#endif
+        // NOTE 先改为临时名称并立即打开新文件，历史文件的编号调整与压缩在后台线程中按顺序进行
+        auto pending_name = config__.filename + ".rotating." + std::to_string(pending_seq__++);
+        std::rename(config__.filename.c_str(), pending_name.c_str());
+        ++rotate_count__;
+        {
+            std::lock_guard<std::mutex> lck(archive_mu__);
+            archive_queue__.push_back(pending_name);
+        }
+        archive_cond__.notify_one();
+        open_file__();
+    }
+
+    inline std::string sf_log_file_sink::history_name__(size_t index, bool compressed) const {
+        return config__.filename + "." + std::to_string(index) + (compressed ? ".gz" : "");
+    }
+
+    inline void sf_log_file_sink::archive__(const std::string &pending_name) {
+        auto exists = [](const std::string &name) {
+            struct stat st{};
+            return stat(name.c_str(), &st) == 0;
+        };
+        // 找到最旧的历史文件编号，依次向后移动
+        size_t last = 0;
+        while (exists(history_name__(last + 1, false)) || exists(history_name__(last + 1, true)))
+        {
+            ++last;
+        }
+        for (auto i = last; i >= 1; --i)
+        {
+            for (auto compressed : {false, true})
+            {
+                auto name = history_name__(i, compressed);
+                if (!exists(name))
+                {
+                    continue;
+                }
+                if (config__.max_history != 0 && i >= config__.max_history)
+                {
+                    std::remove(name.c_str());
+                }
+                else
+                {
+                    std::rename(name.c_str(), history_name__(i + 1, compressed).c_str());
+                }
+            }
+        }
+        if (config__.compress && compress_file__(pending_name, history_name__(1, true)))
+        {
+            std::remove(pending_name.c_str());
+        }
+        else
+        {
+            std::rename(pending_name.c_str(), history_name__(1, false).c_str());
+        }
+    }
+
+    inline bool sf_log_file_sink::compress_file__(const std::string &src, const std::string &dst) {
+#ifdef SF_LOG_ENABLE_ZLIB
+        auto in = std::fopen(src.c_str(), "rb");
+        if (in == nullptr)
+        {
+            return false;
+        }
+        auto out = gzopen(dst.c_str(), "wb");
+        if (out == nullptr)
+        {
+            std::fclose(in);
+            return false;
+        }
+        std::vector<char> buffer(64 * 1024);
+        auto ok = true;
+        size_t len;
+        while ((len = std::fread(buffer.data(), 1, buffer.size(), in)) != 0)
+        {
+            if (gzwrite(out, buffer.data(), static_cast<unsigned int>(len)) != static_cast<int>(len))
+            {
+                ok = false;
+                break;
+            }
+        }
+        std::fclose(in);
+        ok = gzclose(out) == Z_OK && ok;
+        if (!ok)
+        {
+            std::remove(dst.c_str());
+        }
+        return ok;
+#else
+        (void) src;
+        (void) dst;
+        return false;
+#endif
+    }
+
+    inline unsigned long long sf_log_file_sink::written_bytes() const {
+        return written_bytes__;
+    }
+
+    inline unsigned long long sf_log_file_sink::rotate_count() const {
+        return rotate_count__;
+    }
+}
@@ -0,0 +1,186 @@
+
+/**
+* @version 1.0.0
+* @author skyfire
+* @mail skyfireitdiy@hotmail.com
+* @see http://github.com/skyfireitdiy/sflib
+* @file sf_log_ring.h
+
+* sflib第一版本发布
+* 版本号1.0.0
+* 发布日期：2018-10-22
+*/
+
+/*
+ * sf_log_ring 日志环形缓冲区
+ * 每个打印日志的线程拥有一个单生产者单消费者的字节环，日志以紧凑的二进制记录写入，由后台线程解码格式化
+ * 本文件只依赖标准库，可以随sf_logger独立使用
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+namespace skyfire
+{
+    /**
+     *  @brief 日志溢出策略（线程的日志缓冲区已满时）
+     */
+    enum class sf_log_overflow_policy
+    {
+        drop = 0,           // 丢弃日志并计数
+        block = 1           // 等待后台线程取走日志
+    };
+
+    /**
+     *  @brief 日志位置（每个打印点一个静态对象，记录中只保存其指针）
+     */
+    struct sf_log_location_t
+    {
+        int level;                          // 日志等级
+        const char *file;                   // 文件名称
+        int line;                           // 行号
+        const char *func;                   // 函数名称
+    };
+
+    /**
+     *  @brief 日志参数类型标记，标记后的数据布局与sf_serialize_binary相同
+     *  （数值为内存中的原始字节，字符串为size_t长度加内容）
+     */
+    enum class sf_log_arg_tag : unsigned char
+    {
+        int64 = 1,
+        uint64 = 2,
+        float64 = 3,
+        boolean = 4,
+        character = 5,
+        string = 6
+    };
+
+    /**
+     *  @brief 日志记录头
+     */
+    struct sf_log_record_header_t
+    {
+        unsigned int size;                      // 记录总长度（包括记录头，8字节对齐）
+        unsigned int arg_count;                 // 参数数量
+        const sf_log_location_t *location;      // 日志位置，为nullptr时表示环尾部的填充
+        long long ticks;                        // 时间（system_clock纳秒）
+    };
+
+    /**
+     *  @brief 单生产者单消费者字节环
+     */
+    class sf_log_ring
+    {
+    private:
+        std::unique_ptr<char[]> buffer__;
+        size_t capacity__;
+        std::thread::id thread_id__;
+
+        alignas(64) std::atomic<size_t> write_pos__{0};
+        size_t cached_read_pos__ = 0;
+        size_t reserved_size__ = 0;
+
+        alignas(64) std::atomic<size_t> read_pos__{0};
+        std::atomic<bool> closed__{false};
+
+    public:
+        /**
+         * @param capacity 容量（向上取整为2的幂）
+         */
+        explicit sf_log_ring(size_t capacity);
+
+        /**
+         * 生产者预留空间
+         * @param size 记录长度（8字节对齐）
+         * @return 写入位置，空间不足时返回nullptr
+         */
+        char *reserve(size_t size);
+
+        /**
+         * 生产者提交上一次预留的记录
+         */
+        void commit();
+
+        /**
+         * 消费者读取所有已提交的记录
+         * @tparam _Func 回调函数类型，形如 void(const sf_log_record_header_t &, const char *args)
+         * @param func 回调函数
+         * @return 读取的记录数量
+         */
+        template<typename _Func>
+        size_t consume(_Func func);
+
+        /**
+         * 生产者查询未读取的数据是否超过容量的一半
+         */
+        bool above_watermark();
+
+        /**
+         * 是否没有未读取的记录
+         */
+        bool empty() const;
+
+        /**
+         * 容量
+         */
+        size_t capacity() const;
+
+        /**
+         * 生产者线程id
+         */
+        std::thread::id thread_id() const;
+
+        /**
+         * 标记生产者线程已退出（读取完剩余记录后可释放）
+         */
+        void close();
+
+        bool closed() const;
+    };
+
+    /**
+     * 将参数转换为可编码的类型：数值、字符、字符串直接编码，其他类型在调用线程中通过operator<<格式化为字符串
+     */
+    template<typename T>
+    decltype(auto) sf_log_arg_convert(const T &arg);
+
+    /**
+     * 编码后参数的长度
+     */
+    template<typename T>
+    size_t sf_log_arg_size(const T &arg);
+
+    /**
+     * 编码参数
+     * @param buffer 写入位置
+     * @param arg 参数
+     * @return 写入后的位置
+     */
+    template<typename T>
+    char *sf_log_arg_encode(char *buffer, const T &arg);
+
+    /**
+     * 解码一个参数并以operator<<输出
+     * @param os 输出流
+     * @param buffer 读取位置
+     * @return 读取后的位置
+     */
+    const char *sf_log_arg_decode(std::ostream &os, const char *buffer);
+
+    /**
+     * 编码后的参数列表的实际长度（不含记录尾部的对齐填充）
+     * @param buffer 参数起始位置
+     * @param arg_count 参数数量
+     * @return 长度
+     */
+    size_t sf_log_args_size(const char *buffer, unsigned int arg_count);
+}
@@ -0,0 +1,271 @@
+
+/**
+* @version 1.0.0
+* @author skyfire
+* @mail skyfireitdiy@hotmail.com
+* @see http://github.com/skyfireitdiy/sflib
+* @file sf_log_ring.hpp
+
+* sflib第一版本发布
+* 版本号1.0.0
+* 发布日期：2018-10-22
+*/
+
+/*
+ * sf_log_ring 日志环形缓冲区
+ * 每个打印日志的线程拥有一个单生产者单消费者的字节环，日志以紧凑的二进制记录写入，由后台线程解码格式化
+ * 本文件只依赖标准库，可以随sf_logger独立使用
+ */
+
+#pragma once
+
+#include "sf_log_ring.h"
+
+namespace skyfire
+{
+    inline sf_log_ring::sf_log_ring(size_t capacity) : thread_id__(std::this_thread::get_id()) {
+        capacity__ = 1024;
+        while (capacity__ < capacity)
+        {
+            capacity__ <<= 1;
+        }
+        buffer__.reset(new char[capacity__]);
+    }
+
+    inline char *sf_log_ring::reserve(size_t size) {
+        auto write_pos = write_pos__.load(std::memory_order_relaxed);
+        auto offset = write_pos & (capacity__ - 1);
+        // NOTE 记录不跨越环尾，剩余空间不足时填充到环尾，从头写入
+        auto skip = capacity__ - offset < size ? capacity__ - offset : 0;
+        if (write_pos + skip + size - cached_read_pos__ > capacity__)
+        {
+            cached_read_pos__ = read_pos__.load(std::memory_order_acquire);
+            if (write_pos + skip + size - cached_read_pos__ > capacity__)
+            {
+                return nullptr;
+            }
+        }
+        if (skip >= sizeof(sf_log_record_header_t))
+        {
+            sf_log_record_header_t padding{static_cast<unsigned int>(skip), 0, nullptr, 0};
+            std::memcpy(buffer__.get() + offset, &padding, sizeof(padding));
+        }
+        reserved_size__ = skip + size;
+        return buffer__.get() + (skip == 0 ? offset : 0);
+    }
+
+    inline void sf_log_ring::commit() {
+        write_pos__.store(write_pos__.load(std::memory_order_relaxed) + reserved_size__, std::memory_order_release);
+    }
+
+    template<typename _Func>
+    inline size_t sf_log_ring::consume(_Func func) {
+        auto read_pos = read_pos__.load(std::memory_order_relaxed);
+        auto write_pos = write_pos__.load(std::memory_order_acquire);
+        size_t count = 0;
+        while (read_pos != write_pos)
+        {
+            auto offset = read_pos & (capacity__ - 1);
+            if (capacity__ - offset < sizeof(sf_log_record_header_t))
+            {
+                read_pos += capacity__ - offset;
+                continue;
+            }
+            sf_log_record_header_t header;
+            std::memcpy(&header, buffer__.get() + offset, sizeof(header));
+            if (header.location != nullptr)
+            {
+                func(header, buffer__.get() + offset + sizeof(header));
+                ++count;
+            }
+            read_pos += header.size;
+        }
+        read_pos__.store(read_pos, std::memory_order_release);
+        return count;
+    }
+
+    inline bool sf_log_ring::above_watermark() {
+        auto write_pos = write_pos__.load(std::memory_order_relaxed);
+        if (write_pos - cached_read_pos__ > capacity__ / 2)
+        {
+            cached_read_pos__ = read_pos__.load(std::memory_order_acquire);
+        }
+        return write_pos - cached_read_pos__ > capacity__ / 2;
+    }
+
+    inline bool sf_log_ring::empty() const {
+        return read_pos__.load(std::memory_order_acquire) == write_pos__.load(std::memory_order_acquire);
+    }
+
+    inline size_t sf_log_ring::capacity() const {
+        return capacity__;
+    }
+
+    inline std::thread::id sf_log_ring::thread_id() const {
+        return thread_id__;
+    }
+
+    inline void sf_log_ring::close() {
+        closed__ = true;
+    }
+
+    inline bool sf_log_ring::closed() const {
+        return closed__;
+    }
+
+    template<typename T>
+    inline decltype(auto) sf_log_arg_convert(const T &arg) {
+        if constexpr (std::is_arithmetic<T>::value
+                      || std::is_same<T, std::string>::value
+                      || std::is_same<std::decay_t<T>, const char *>::value
+                      || std::is_same<std::decay_t<T>, char *>::value)
+        {
+            return (arg);
+        }
+        else
+        {
+            std::ostringstream oss;
+            oss << arg;
+            return oss.str();
+        }
+    }
+
+    template<typename T>
+    inline size_t sf_log_arg_size(const T &arg) {
+        if constexpr (std::is_same<T, std::string>::value)
+        {
+            return 1 + sizeof(size_t) + arg.size();
+        }
+        else if constexpr (std::is_same<std::decay_t<T>, const char *>::value
+                           || std::is_same<std::decay_t<T>, char *>::value)
+        {
+            return 1 + sizeof(size_t) + std::strlen(arg);
+        }
+        else if constexpr (sizeof(T) == 1)
+        {
+            return 2;
+        }
+        else
+        {
+            return 1 + 8;
+        }
+    }
+
+    template<typename T>
+    inline char *sf_log_arg_encode(char *buffer, const T &arg) {
+        auto write = [&](sf_log_arg_tag tag, const void *data, size_t size) {
+            *buffer++ = static_cast<char>(tag);
+            std::memcpy(buffer, data, size);
+            buffer += size;
+        };
+        auto write_string = [&](const char *str, size_t len) {
+            write(sf_log_arg_tag::string, &len, sizeof(len));
+            std::memcpy(buffer, str, len);
+            buffer += len;
+        };
+        if constexpr (std::is_same<T, std::string>::value)
+        {
+            write_string(arg.data(), arg.size());
+        }
+        else if constexpr (std::is_same<std::decay_t<T>, const char *>::value
+                           || std::is_same<std::decay_t<T>, char *>::value)
+        {
+            write_string(arg, std::strlen(arg));
+        }
+        else if constexpr (std::is_same<T, bool>::value)
+        {
+            write(sf_log_arg_tag::boolean, &arg, 1);
+        }
+        else if constexpr (sizeof(T) == 1)
+        {
+            write(sf_log_arg_tag::character, &arg, 1);
+        }
+        else if constexpr (std::is_floating_point<T>::value)
+        {
+            double value = arg;
+            write(sf_log_arg_tag::float64, &value, sizeof(value));
+        }
+        else if constexpr (std::is_signed<T>::value)
+        {
+            long long value = arg;
+            write(sf_log_arg_tag::int64, &value, sizeof(value));
+        }
+        else
+        {
+            unsigned long long value = arg;
+            write(sf_log_arg_tag::uint64, &value, sizeof(value));
+        }
+        return buffer;
+    }
+
+    inline const char *sf_log_arg_decode(std::ostream &os, const char *buffer) {
+        auto tag = static_cast<sf_log_arg_tag>(*buffer++);
+        switch (tag)
+        {
+            case sf_log_arg_tag::int64:
+            {
+                long long value;
+                std::memcpy(&value, buffer, sizeof(value));
+                os << value;
+                return buffer + sizeof(value);
+            }
+            case sf_log_arg_tag::uint64:
+            {
+                unsigned long long value;
+                std::memcpy(&value, buffer, sizeof(value));
+                os << value;
+                return buffer + sizeof(value);
+            }
+            case sf_log_arg_tag::float64:
+            {
+                double value;
+                std::memcpy(&value, buffer, sizeof(value));
+                os << value;
+                return buffer + sizeof(value);
+            }
+            case sf_log_arg_tag::boolean:
+            {
+                bool value;
+                std::memcpy(&value, buffer, 1);
+                os << value;
+                return buffer + 1;
+            }
+            case sf_log_arg_tag::character:
+                os << *buffer;
+                return buffer + 1;
+            case sf_log_arg_tag::string:
+            {
+                size_t len;
+                std::memcpy(&len, buffer, sizeof(len));
+                os.write(buffer + sizeof(len), static_cast<std::streamsize>(len));
+                return buffer + sizeof(len) + len;
+            }
+        }
+        return buffer;
+    }
+
+    inline size_t sf_log_args_size(const char *buffer, unsigned int arg_count) {
+        auto pos = buffer;
+        for (unsigned int i = 0; i < arg_count; ++i)
+        {
+            switch (static_cast<sf_log_arg_tag>(*pos++))
+            {
+                case sf_log_arg_tag::boolean:
+                case sf_log_arg_tag::character:
+                    pos += 1;
+                    break;
+                case sf_log_arg_tag::string:
+                {
+                    size_t len;
+                    std::memcpy(&len, pos, sizeof(len));
+                    pos += sizeof(len) + len;
+                    break;
+                }
+                default:
+                    pos += 8;
+                    break;
+            }
+        }
+        return static_cast<size_t>(pos - buffer);
+    }
+}
@@ -33,6 +33,13 @@
 #include <climits>
 #include <shared_mutex>
 #include <thread>
+#include <vector>
+#include <algorithm>
+#include <charconv>
+#include "sf_log_ring.hpp"
+#include "sf_clock.hpp"
+#include "sf_log_file_sink.hpp"
+#include "sf_log_binary_sink.hpp"
 
 #ifdef QT_CORE_LIB
 #include <QString>
@@ -104,6 +111,102 @@ namespace skyfire
      */
     constexpr char sf_default_log_format[] = "[{level}][{time}][{thread}][{file} ({line}) {func}] --> {msg}\n";
 
+    /**
+     *  @brief 日志等级字符串（按SF_LOG_LEVEL索引）
+     */
+    constexpr const char *sf_log_level_str[] = {"DEBUG", "INFO ", "WARN ", "ERROR", "FATAL"};
+
+    /**
+     *  @brief 日志格式字段
+     */
+    enum class sf_log_format_field
+    {
+        literal,
+        level,
+        time,
+        thread,
+        file,
+        line,
+        func,
+        msg
+    };
+
+    /**
+     *  @brief 日志格式片段
+     */
+    struct sf_log_format_segment_t
+    {
+        sf_log_format_field field;              // 字段
+        std::string text;                       // 字面量（仅literal有效）
+    };
+
+    /**
+     *  @brief 预编译的日志格式：格式字符串只解析一次，输出时按片段依次拼接
+     */
+    class sf_log_format
+    {
+    private:
+        std::vector<sf_log_format_segment_t> segments__;
+
+        static const std::string &thread_str__(std::thread::id id);
+
+    public:
+        /**
+         * @param format_str 格式化字符串，支持{level}、{time}、{thread}、{file}、{line}、{func}、{msg}
+         */
+        explicit sf_log_format(const std::string &format_str);
+
+        /**
+         * 格式化日志
+         * @param out 输出缓冲区（先清空，可重复使用以避免分配）
+         * @param log_info 日志信息
+         */
+        void render(std::string &out, const sf_logger_info_t__ &log_info) const;
+
+        /**
+         * 格式化日志，使用指定的线程号字符串（如离线解码时的原始线程号）
+         * @param out 输出缓冲区
+         * @param log_info 日志信息（thread_id字段不使用）
+         * @param thread_str 线程号字符串
+         */
+        void render(std::string &out, const sf_logger_info_t__ &log_info, const std::string &thread_str) const;
+    };
+
+    /**
+     *  @brief 限频日志打印点的状态（每个打印点一个静态对象，只使用原子操作）
+     *  检查函数返回-1表示本次不打印，否则返回上次打印之后被抑制的数量
+     */
+    class sf_log_rate_state_t
+    {
+    private:
+        std::atomic<unsigned long long> count__{0};
+        std::atomic<long long> last_ms__{LLONG_MIN};
+        std::atomic<long long> suppressed__{0};
+
+        long long pass__();
+
+        long long suppress__();
+
+    public:
+        /**
+         * 每n次打印一次（第1、n+1、2n+1……次）
+         * @param n 间隔次数
+         */
+        long long every_n(unsigned long long n);
+
+        /**
+         * 每ms毫秒最多打印一次
+         * @param ms 间隔毫秒数
+         */
+        long long every_ms(long long ms);
+
+        /**
+         * 按概率采样打印
+         * @param prob 概率（0-1）
+         */
+        long long sampled(double prob);
+    };
+
     /**
      * 日志类
      * @tparam _Base 基类（默认为empty_class）
@@ -140,12 +243,35 @@ namespace skyfire
          */
         int add_level_file(SF_LOG_LEVEL level, const std::string &filename, std::string format = sf_default_log_format);
 
+        /**
+         * 添加指定等级日志文件输出（可配置批量写入、切分与同步策略）
+         * @param level 等级
+         * @param sink 日志文件输出
+         * @param format 格式化字符串
+         * @return id号（可用于移除回调），文件打开失败返回-1
+         */
+        int add_level_file_sink(SF_LOG_LEVEL level, std::shared_ptr<sf_log_file_sink> sink,
+                                std::string format = sf_default_log_format);
+
+        /**
+         * 添加指定等级二进制日志输出（参数不在运行时格式化，用sf_log_decode还原）
+         * @param level 等级
+         * @param sink 二进制日志输出
+         * @return id号（可用于移除回调），文件打开失败返回-1
+         */
+        int add_level_binary_sink(SF_LOG_LEVEL level, std::shared_ptr<sf_log_binary_sink> sink);
+
         /**
          * 根据id删除过滤器
          * @param key id
          */
         void remove_filter(int key);
 
+        /**
+         * 删除所有过滤器（包括默认的标准输出）
+         */
+        void clear_filters();
+
 
         template<typename T>
         void logout(SF_LOG_LEVEL level, const std::string &file, int line, const std::string &func, const T &dt);
@@ -153,6 +279,52 @@ namespace skyfire
         template<typename...T>
         void logout(SF_LOG_LEVEL level, const std::string &file, int line, const std::string &func, const T &...dt);
 
+        /**
+         * 打印日志（日志宏使用）：参数编码后写入当前线程的日志缓冲区，由后台线程格式化输出
+         * @param location 日志位置（静态对象）
+         * @param dt 参数
+         */
+        template<typename...T>
+        void logout(const sf_log_location_t &location, const T &...dt);
+
+        /**
+         * 设置线程日志缓冲区已满时的策略（默认丢弃）
+         * @param policy 策略
+         */
+        void set_overflow_policy(sf_log_overflow_policy policy);
+
+        /**
+         * 设置线程日志缓冲区大小（对之后首次打印日志的线程生效）
+         * @param size 字节数
+         */
+        void set_thread_buffer_size(size_t size);
+
+        /**
+         * 获取因缓冲区已满而丢弃的日志数量
+         * @return 丢弃数量
+         */
+        unsigned long long dropped_count() const;
+
+        /**
+         * 设置日志时间秒以下的位数（默认为0，即只精确到秒）
+         * @param precision 位数（0-9，3为毫秒，6为微秒）
+         */
+        void set_time_precision(int precision);
+
+        /**
+         * 设置最低日志等级，低于此等级的日志在求值参数前即被丢弃
+         * （实际生效的等级还不低于已注册输出中的最低等级）
+         * @param level 等级
+         */
+        void set_min_level(SF_LOG_LEVEL level);
+
+        /**
+         * 指定等级的日志是否会被输出（日志宏在求值参数前调用，只有一次relaxed读取）
+         * @param level 等级
+         * @return 是否输出
+         */
+        static bool is_enabled(int level);
+
         void stop_logger();
 
         void empty_func__(){}
@@ -167,19 +339,52 @@ namespace skyfire
         std::map<int, std::unordered_map<int ,std::function<void(const sf_logger_info_t__ &)>>> logger_func_set__;
         std::atomic<bool> run__ {true};
         std::recursive_mutex func_set_mutex__;
+        // 每批日志处理完成后调用（文件输出的缓冲区写入等）
+        std::unordered_map<int, std::function<void()>> flush_func_set__;
+        // 二进制输出：id -> (等级, 输出)
+        std::unordered_map<int, std::pair<int, std::shared_ptr<sf_log_binary_sink>>> binary_sink_set__;
+        // 文本输出中的最低等级（低于此等级的记录不需要解码格式化）
+        int text_min_level__ = SF_DEBUG_LEVEL;
+
+        /**
+         *  @brief 线程日志缓冲区持有者，线程退出时关闭缓冲区
+         */
+        struct sf_log_ring_holder_t__
+        {
+            std::shared_ptr<sf_log_ring> ring;
+
+            ~sf_log_ring_holder_t__();
+        };
+
+        std::mutex rings_mu__;
+        std::vector<std::shared_ptr<sf_log_ring>> rings__;
+        std::atomic<sf_log_overflow_policy> overflow_policy__ {sf_log_overflow_policy::drop};
+        std::atomic<size_t> thread_buffer_size__ {256 * 1024};
+        std::atomic<unsigned long long> dropped_count__ {0};
+        std::atomic<bool> consumer_sleeping__ {false};
+        std::atomic<int> time_precision__ {0};
+        static inline std::atomic<int> min_level__ {SF_DEBUG_LEVEL};
+        std::atomic<int> user_min_level__ {SF_DEBUG_LEVEL};
+
+        void update_min_level__();
+
+        sf_log_ring *get_thread_ring__();
+
+        void notify_consumer__();
+
+        template<typename...T>
+        void logout_record__(const sf_log_location_t &location, const T &...dt);
+
+        bool has_pending_log__();
+
+        void process_log__();
+
+        void dispatch_log__(const sf_logger_info_t__ &log);
 
         bool check_key_can_use__(int key);
 
         int make_random_logger_id__();
 
-        std::map<SF_LOG_LEVEL, std::string> logger_level_str__{
-                {SF_DEBUG_LEVEL, "DEBUG"},
-                {SF_INFO_LEVEL,  "INFO "},
-                {SF_WARN_LEVEL,  "WARN "},
-                {SF_ERROR_LEVEL, "ERROR"},
-                {SF_FATAL_LEVEL, "FATAL"},
-        };
-
 
         sf_logger__();
 
@@ -196,21 +401,113 @@ namespace skyfire
         template<typename T>
         void logout__(std::ostringstream &oss, sf_logger_info_t__ &log_info, const T &tmp);
 
-        static std::string make_time_str__();
+        std::string make_time_str__();
+
+        std::string make_time_str__(long long ticks);
     };
     using sf_logger = sf_logger__<>;
 
 
-#ifdef SF_DEBUG
-#define sf_debug(...) skyfire::g_logger->logout(skyfire::SF_DEBUG_LEVEL,__FILE__,__LINE__,__FUNCTION__,__VA_ARGS__)
+/*
+ * SF_LOG_COMPILE_LEVEL 编译期最低日志等级（0-4，对应SF_DEBUG_LEVEL-SF_FATAL_LEVEL），低于此等级的日志宏展开为空语句
+ */
+#ifndef SF_LOG_COMPILE_LEVEL
+#define SF_LOG_COMPILE_LEVEL 0
+#endif
+
+/*
+ * sf_log_at__ 在当前位置打印日志，位置信息保存在静态对象中，运行期等级检查在参数求值之前
+ */
+#define sf_log_at__(level, ...)                                                                                         \
+do {                                                                                                                    \
+    if (skyfire::sf_logger::is_enabled(level))                                                                         \
+    {                                                                                                                   \
+        static const skyfire::sf_log_location_t __sf_log_location__{level, __FILE__, __LINE__, __FUNCTION__};         \
+        skyfire::g_logger->logout(__sf_log_location__, __VA_ARGS__);                                                    \
+    }                                                                                                                   \
+} while (0)                                                                                                             \
+
+/*
+ * sf_log_limited__ 限频打印：每个打印点一个静态的sf_log_rate_state_t（无锁），恢复打印时先输出被抑制的数量
+ */
+#define sf_log_limited__(level, check, ...)                                                                             \
+do {                                                                                                                    \
+    if (skyfire::sf_logger::is_enabled(level))                                                                         \
+    {                                                                                                                   \
+        static skyfire::sf_log_rate_state_t __sf_log_rate__;                                                            \
+        const auto __sf_log_suppressed__ = __sf_log_rate__.check;                                                       \
+        if (__sf_log_suppressed__ >= 0)                                                                                 \
+        {                                                                                                               \
+            if (__sf_log_suppressed__ > 0)                                                                              \
+            {                                                                                                           \
+                sf_log_at__(level, "suppressed", __sf_log_suppressed__, "messages");                                    \
+            }                                                                                                           \
+            sf_log_at__(level, __VA_ARGS__);                                                                            \
+        }                                                                                                               \
+    }                                                                                                                   \
+} while (0)                                                                                                             \
+
+#define sf_log_disabled__(...) do { } while (0)
+
+#if defined(SF_DEBUG) && SF_LOG_COMPILE_LEVEL <= 0
+#define sf_debug(...) sf_log_at__(skyfire::SF_DEBUG_LEVEL, __VA_ARGS__)
+#define sf_debug_every_n(n, ...) sf_log_limited__(skyfire::SF_DEBUG_LEVEL, every_n(n), __VA_ARGS__)
+#define sf_debug_every_ms(ms, ...) sf_log_limited__(skyfire::SF_DEBUG_LEVEL, every_ms(ms), __VA_ARGS__)
+#define sf_debug_sampled(prob, ...) sf_log_limited__(skyfire::SF_DEBUG_LEVEL, sampled(prob), __VA_ARGS__)
+#else
+#define sf_debug(...) sf_log_disabled__(__VA_ARGS__)
+#define sf_debug_every_n(n, ...) sf_log_disabled__(__VA_ARGS__)
+#define sf_debug_every_ms(ms, ...) sf_log_disabled__(__VA_ARGS__)
+#define sf_debug_sampled(prob, ...) sf_log_disabled__(__VA_ARGS__)
+#endif
+
+#if SF_LOG_COMPILE_LEVEL <= 1
+#define sf_info(...) sf_log_at__(skyfire::SF_INFO_LEVEL, __VA_ARGS__)
+#define sf_info_every_n(n, ...) sf_log_limited__(skyfire::SF_INFO_LEVEL, every_n(n), __VA_ARGS__)
+#define sf_info_every_ms(ms, ...) sf_log_limited__(skyfire::SF_INFO_LEVEL, every_ms(ms), __VA_ARGS__)
+#define sf_info_sampled(prob, ...) sf_log_limited__(skyfire::SF_INFO_LEVEL, sampled(prob), __VA_ARGS__)
 #else
-#define sf_debug(...) skyfire::g_logger->empty_func__()
+#define sf_info(...) sf_log_disabled__(__VA_ARGS__)
+#define sf_info_every_n(n, ...) sf_log_disabled__(__VA_ARGS__)
+#define sf_info_every_ms(ms, ...) sf_log_disabled__(__VA_ARGS__)
+#define sf_info_sampled(prob, ...) sf_log_disabled__(__VA_ARGS__)
 #endif
 
-#define sf_info(...) skyfire::g_logger->logout(skyfire::SF_INFO_LEVEL,__FILE__,__LINE__,__FUNCTION__,__VA_ARGS__)
-#define sf_warn(...) skyfire::g_logger->logout(skyfire::SF_WARN_LEVEL,__FILE__,__LINE__,__FUNCTION__,__VA_ARGS__)
-#define sf_error(...) skyfire::g_logger->logout(skyfire::SF_ERROR_LEVEL,__FILE__,__LINE__,__FUNCTION__,__VA_ARGS__)
-#define sf_fatal(...) skyfire::g_logger->logout(skyfire::SF_FATAL_LEVEL,__FILE__,__LINE__,__FUNCTION__,__VA_ARGS__)
+#if SF_LOG_COMPILE_LEVEL <= 2
+#define sf_warn(...) sf_log_at__(skyfire::SF_WARN_LEVEL, __VA_ARGS__)
+#define sf_warn_every_n(n, ...) sf_log_limited__(skyfire::SF_WARN_LEVEL, every_n(n), __VA_ARGS__)
+#define sf_warn_every_ms(ms, ...) sf_log_limited__(skyfire::SF_WARN_LEVEL, every_ms(ms), __VA_ARGS__)
+#define sf_warn_sampled(prob, ...) sf_log_limited__(skyfire::SF_WARN_LEVEL, sampled(prob), __VA_ARGS__)
+#else
+#define sf_warn(...) sf_log_disabled__(__VA_ARGS__)
+#define sf_warn_every_n(n, ...) sf_log_disabled__(__VA_ARGS__)
+#define sf_warn_every_ms(ms, ...) sf_log_disabled__(__VA_ARGS__)
+#define sf_warn_sampled(prob, ...) sf_log_disabled__(__VA_ARGS__)
+#endif
+
+#if SF_LOG_COMPILE_LEVEL <= 3
+#define sf_error(...) sf_log_at__(skyfire::SF_ERROR_LEVEL, __VA_ARGS__)
+#define sf_error_every_n(n, ...) sf_log_limited__(skyfire::SF_ERROR_LEVEL, every_n(n), __VA_ARGS__)
+#define sf_error_every_ms(ms, ...) sf_log_limited__(skyfire::SF_ERROR_LEVEL, every_ms(ms), __VA_ARGS__)
+#define sf_error_sampled(prob, ...) sf_log_limited__(skyfire::SF_ERROR_LEVEL, sampled(prob), __VA_ARGS__)
+#else
+#define sf_error(...) sf_log_disabled__(__VA_ARGS__)
+#define sf_error_every_n(n, ...) sf_log_disabled__(__VA_ARGS__)
+#define sf_error_every_ms(ms, ...) sf_log_disabled__(__VA_ARGS__)
+#define sf_error_sampled(prob, ...) sf_log_disabled__(__VA_ARGS__)
+#endif
+
+#if SF_LOG_COMPILE_LEVEL <= 4
+#define sf_fatal(...) sf_log_at__(skyfire::SF_FATAL_LEVEL, __VA_ARGS__)
+#define sf_fatal_every_n(n, ...) sf_log_limited__(skyfire::SF_FATAL_LEVEL, every_n(n), __VA_ARGS__)
+#define sf_fatal_every_ms(ms, ...) sf_log_limited__(skyfire::SF_FATAL_LEVEL, every_ms(ms), __VA_ARGS__)
+#define sf_fatal_sampled(prob, ...) sf_log_limited__(skyfire::SF_FATAL_LEVEL, sampled(prob), __VA_ARGS__)
+#else
+#define sf_fatal(...) sf_log_disabled__(__VA_ARGS__)
+#define sf_fatal_every_n(n, ...) sf_log_disabled__(__VA_ARGS__)
+#define sf_fatal_every_ms(ms, ...) sf_log_disabled__(__VA_ARGS__)
+#define sf_fatal_sampled(prob, ...) sf_log_disabled__(__VA_ARGS__)
+#endif
 
 
 
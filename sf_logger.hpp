@@ -30,44 +30,44 @@ namespace skyfire
         }
         auto key = make_random_logger_id__();
         logger_func_set__[level][key] = func;
+        update_min_level__();
         return key;
     }
 
     template<typename _Base>
     int sf_logger__<_Base>::add_level_stream(SF_LOG_LEVEL level, std::ostream *os, std::string format_str) {
-        std::unique_lock<std::recursive_mutex> lock(func_set_mutex__);
-        if (logger_func_set__.count(level) == 0)
-        {
-            logger_func_set__[level] = std::unordered_map<int,std::function<void(const sf_logger_info_t__ &)>>();
-        }
-        auto key = make_random_logger_id__();
-        logger_func_set__[level][key] = [=](const sf_logger_info_t__ &log_info)
+        return add_level_func(level, [=, fmt = sf_log_format(format_str), buffer = std::string()](
+                const sf_logger_info_t__ &log_info) mutable
         {
-            *os<<format(format_str, log_info);
-        };
-        return key;
+            fmt.render(buffer, log_info);
+            os->write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        });
     }
 
     template<typename _Base>
     int sf_logger__<_Base>::add_level_file(SF_LOG_LEVEL level, const std::string &filename, std::string format_str) {
-        std::shared_ptr<std::ofstream> ofs = std::make_shared<std::ofstream>(filename, std::ios::app);
-        if(*ofs)
-        {
-            std::unique_lock<std::recursive_mutex> lock(func_set_mutex__);
-            if (logger_func_set__.count(level) == 0)
-            {
-                logger_func_set__[level] = std::unordered_map<int,std::function<void(const sf_logger_info_t__ &)>>();
-            }
-
-            auto key = make_random_logger_id__();
-            logger_func_set__[level][key] = [=](const sf_logger_info_t__ &log_info){
-                *ofs<<format(format_str, log_info);
-            };
-            return key;
+        sf_log_file_sink_config_t config;
+        config.filename = filename;
+        return add_level_file_sink(level, std::make_shared<sf_log_file_sink>(config), format_str);
+    }
 
-        }else{
+    template<typename _Base>
+    int sf_logger__<_Base>::add_level_file_sink(SF_LOG_LEVEL level, std::shared_ptr<sf_log_file_sink> sink,
+                                                std::string format_str) {
+        if (!sink || !sink->is_open())
+        {
             return -1;
         }
+        std::unique_lock<std::recursive_mutex> lock(func_set_mutex__);
+        auto key = add_level_func(level, [=, fmt = sf_log_format(format_str), buffer = std::string()](
+                const sf_logger_info_t__ &log_info) mutable {
+            fmt.render(buffer, log_info);
+            sink->write(buffer.data(), buffer.size());
+        });
+        flush_func_set__[key] = [=] {
+            sink->flush();
+        };
+        return key;
     }
 
     template<typename _Base>
@@ -76,6 +76,66 @@ namespace skyfire
         for(auto &p:logger_func_set__){
             p.second.erase(key);
         }
+        flush_func_set__.erase(key);
+        binary_sink_set__.erase(key);
+        update_min_level__();
+    }
+
+    template<typename _Base>
+    void sf_logger__<_Base>::clear_filters() {
+        std::unique_lock<std::recursive_mutex> lock(func_set_mutex__);
+        logger_func_set__.clear();
+        flush_func_set__.clear();
+        binary_sink_set__.clear();
+        update_min_level__();
+    }
+
+    template<typename _Base>
+    int sf_logger__<_Base>::add_level_binary_sink(SF_LOG_LEVEL level, std::shared_ptr<sf_log_binary_sink> sink) {
+        if (!sink || !sink->is_open())
+        {
+            return -1;
+        }
+        std::unique_lock<std::recursive_mutex> lock(func_set_mutex__);
+        auto key = make_random_logger_id__();
+        binary_sink_set__[key] = {level, sink};
+        flush_func_set__[key] = [=] {
+            sink->flush();
+        };
+        update_min_level__();
+        return key;
+    }
+
+    template<typename _Base>
+    void sf_logger__<_Base>::update_min_level__() {
+        std::unique_lock<std::recursive_mutex> lock(func_set_mutex__);
+        // NOTE 输出按阈值匹配，最低的已注册等级（map有序，第一个非空）以下的日志不会被任何输出接收
+        auto level = SF_FATAL_LEVEL + 1;
+        for (auto &p : logger_func_set__)
+        {
+            if (!p.second.empty())
+            {
+                level = p.first;
+                break;
+            }
+        }
+        text_min_level__ = level;
+        for (auto &p : binary_sink_set__)
+        {
+            level = std::min(level, p.second.first);
+        }
+        min_level__.store(std::max(level, user_min_level__.load()), std::memory_order_relaxed);
+    }
+
+    template<typename _Base>
+    void sf_logger__<_Base>::set_min_level(SF_LOG_LEVEL level) {
+        user_min_level__ = level;
+        update_min_level__();
+    }
+
+    template<typename _Base>
+    bool sf_logger__<_Base>::is_enabled(int level) {
+        return level >= min_level__.load(std::memory_order_relaxed);
     }
 
     template<typename _Base>
@@ -87,7 +147,7 @@ namespace skyfire
                     return false;
             }
         }
-        return true;
+        return binary_sink_set__.count(key) == 0;
     }
 
     template<typename _Base>
@@ -112,6 +172,10 @@ namespace skyfire
     template<typename T>
     void sf_logger__<_Base>::logout(SF_LOG_LEVEL level, const std::string &file, int line, const std::string &func,
                                     const T &dt) {
+        if (!is_enabled(level))
+        {
+            return;
+        }
         sf_logger_info_t__ log_info;
         log_info.level = level;
         log_info.file = file;
@@ -130,39 +194,231 @@ namespace skyfire
                     {
                         while (true)
                         {
-                            std::unique_lock<std::mutex> lck(cond_mu__);
-                            cond__.wait(lck);
-                            {
-                                std::deque<sf_logger_info_t__> tmp_info;
-                                {
-                                    std::unique_lock<std::mutex> de_lck(deque_mu__);
-                                    tmp_info=std::move(log_deque__);
-                                    log_deque__.clear();
-                                }
-                                for (auto &log: tmp_info)
-                                {
-                                    std::unique_lock<std::recursive_mutex> lock(func_set_mutex__);
-                                    for (auto &level_func:logger_func_set__)
-                                    {
-                                        if (log.level >= level_func.first)
-                                        {
-                                            for (auto &func:level_func.second)
-                                            {
-                                                func.second(log);
-                                            }
-                                        }
-                                    }
-                                }
-                            }
+                            process_log__();
                             if(!run__){
+                                // NOTE 退出前再处理一次，保证stop_logger之前的日志都已输出
+                                process_log__();
                                 run__ = true;
                                 break;
                             }
+                            std::unique_lock<std::mutex> lck(cond_mu__);
+                            consumer_sleeping__ = true;
+                            if (!has_pending_log__() && run__)
+                            {
+                                // NOTE 生产者只在缓冲区过半时唤醒，定时轮询保证日志及时输出
+                                cond__.wait_for(lck, std::chrono::milliseconds(10));
+                            }
+                            consumer_sleeping__ = false;
                         }
                         std::cout<<"thread exit"<<std::endl;
                     }).detach();
     }
 
+    template<typename _Base>
+    sf_logger__<_Base>::sf_log_ring_holder_t__::~sf_log_ring_holder_t__() {
+        if (ring)
+        {
+            ring->close();
+        }
+    }
+
+    template<typename _Base>
+    sf_log_ring *sf_logger__<_Base>::get_thread_ring__() {
+        static thread_local sf_log_ring_holder_t__ holder;
+        if (!holder.ring)
+        {
+            holder.ring = std::make_shared<sf_log_ring>(thread_buffer_size__);
+            std::lock_guard<std::mutex> lck(rings_mu__);
+            rings__.push_back(holder.ring);
+        }
+        return holder.ring.get();
+    }
+
+    template<typename _Base>
+    void sf_logger__<_Base>::notify_consumer__() {
+        if (consumer_sleeping__.exchange(false))
+        {
+            std::lock_guard<std::mutex> lck(cond_mu__);
+            cond__.notify_one();
+        }
+    }
+
+    template<typename _Base>
+    template<typename... T>
+    void sf_logger__<_Base>::logout(const sf_log_location_t &location, const T &... dt) {
+        logout_record__(location, sf_log_arg_convert(dt)...);
+    }
+
+    template<typename _Base>
+    template<typename... T>
+    void sf_logger__<_Base>::logout_record__(const sf_log_location_t &location, const T &... dt) {
+        auto ring = get_thread_ring__();
+        size_t size = sizeof(sf_log_record_header_t);
+        ((size += sf_log_arg_size(dt)), ...);
+        size = (size + 7) & ~static_cast<size_t>(7);
+        if (size > ring->capacity() / 4)
+        {
+            // NOTE 过长的日志不进入缓冲区
+            logout(static_cast<SF_LOG_LEVEL>(location.level), location.file, location.line, location.func, dt...);
+            return;
+        }
+        auto buffer = ring->reserve(size);
+        while (buffer == nullptr)
+        {
+            if (overflow_policy__ == sf_log_overflow_policy::drop || !run__)
+            {
+                ++dropped_count__;
+                return;
+            }
+            notify_consumer__();
+            std::this_thread::yield();
+            buffer = ring->reserve(size);
+        }
+        sf_log_record_header_t header{static_cast<unsigned int>(size), sizeof...(dt), &location,
+                                      std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                              std::chrono::system_clock::now().time_since_epoch()).count()};
+        std::memcpy(buffer, &header, sizeof(header));
+        auto pos = buffer + sizeof(header);
+        ((pos = sf_log_arg_encode(pos, dt)), ...);
+        ring->commit();
+        // NOTE 消费线程定时轮询，只有缓冲区过半时才唤醒，避免每条日志都产生一次唤醒
+        if (consumer_sleeping__.load(std::memory_order_relaxed) && ring->above_watermark())
+        {
+            notify_consumer__();
+        }
+    }
+
+    template<typename _Base>
+    bool sf_logger__<_Base>::has_pending_log__() {
+        {
+            std::lock_guard<std::mutex> lck(deque_mu__);
+            if (!log_deque__.empty())
+            {
+                return true;
+            }
+        }
+        std::lock_guard<std::mutex> lck(rings_mu__);
+        return std::any_of(rings__.begin(), rings__.end(), [](const std::shared_ptr<sf_log_ring> &ring) {
+            return !ring->empty();
+        });
+    }
+
+    template<typename _Base>
+    void sf_logger__<_Base>::process_log__() {
+        std::deque<sf_logger_info_t__> tmp_info;
+        {
+            std::unique_lock<std::mutex> de_lck(deque_mu__);
+            tmp_info = std::move(log_deque__);
+            log_deque__.clear();
+        }
+        std::unique_lock<std::recursive_mutex> lock(func_set_mutex__);
+        for (auto &log: tmp_info)
+        {
+            for (auto &p : binary_sink_set__)
+            {
+                if (log.level >= p.second.first)
+                {
+                    p.second.second->write_text(log.level, log.time, log.thread_id, log.file, log.line, log.func,
+                                                log.msg);
+                }
+            }
+            dispatch_log__(log);
+        }
+
+        std::vector<std::shared_ptr<sf_log_ring>> rings;
+        {
+            std::lock_guard<std::mutex> lck(rings_mu__);
+            // NOTE 线程已退出且已读取完的缓冲区可以释放（关闭后不会再写入）
+            rings__.erase(std::remove_if(rings__.begin(), rings__.end(), [](const std::shared_ptr<sf_log_ring> &ring) {
+                return ring->closed() && ring->empty();
+            }), rings__.end());
+            rings = rings__;
+        }
+
+        // 合并各线程的日志，按时间排序后输出
+        std::vector<std::pair<long long, sf_logger_info_t__>> records;
+        for (auto &ring : rings)
+        {
+            ring->consume([&](const sf_log_record_header_t &header, const char *args) {
+                // NOTE 二进制输出直接写入编码后的参数，没有文本输出接收时不再解码格式化
+                for (auto &p : binary_sink_set__)
+                {
+                    if (header.location->level >= p.second.first)
+                    {
+                        p.second.second->write(header, ring->thread_id(), args);
+                    }
+                }
+                if (header.location->level < text_min_level__)
+                {
+                    return;
+                }
+                sf_logger_info_t__ log_info;
+                log_info.level = static_cast<SF_LOG_LEVEL>(header.location->level);
+                log_info.file = header.location->file;
+                log_info.line = header.location->line;
+                log_info.func = header.location->func;
+                log_info.thread_id = ring->thread_id();
+                log_info.time = make_time_str__(header.ticks);
+                std::ostringstream oss;
+                for (unsigned int i = 0; i < header.arg_count; ++i)
+                {
+                    oss << "[";
+                    args = sf_log_arg_decode(oss, args);
+                    oss << "]";
+                }
+                log_info.msg = oss.str();
+                records.emplace_back(header.ticks, std::move(log_info));
+            });
+        }
+        std::stable_sort(records.begin(), records.end(), [](const auto &a, const auto &b) {
+            return a.first < b.first;
+        });
+        for (auto &p : records)
+        {
+            dispatch_log__(p.second);
+        }
+
+        for (auto &p : flush_func_set__)
+        {
+            p.second();
+        }
+    }
+
+    template<typename _Base>
+    void sf_logger__<_Base>::dispatch_log__(const sf_logger_info_t__ &log) {
+        std::unique_lock<std::recursive_mutex> lock(func_set_mutex__);
+        for (auto &level_func:logger_func_set__)
+        {
+            if (log.level >= level_func.first)
+            {
+                for (auto &func:level_func.second)
+                {
+                    func.second(log);
+                }
+            }
+        }
+    }
+
+    template<typename _Base>
+    void sf_logger__<_Base>::set_overflow_policy(sf_log_overflow_policy policy) {
+        overflow_policy__ = policy;
+    }
+
+    template<typename _Base>
+    void sf_logger__<_Base>::set_thread_buffer_size(size_t size) {
+        thread_buffer_size__ = size;
+    }
+
+    template<typename _Base>
+    unsigned long long sf_logger__<_Base>::dropped_count() const {
+        return dropped_count__;
+    }
+
+    template<typename _Base>
+    void sf_logger__<_Base>::set_time_precision(int precision) {
+        time_precision__ = precision;
+    }
+
     template<typename _Base>
     template<typename T, typename... U>
     void sf_logger__<_Base>::logout__(std::ostringstream &oss, sf_logger_info_t__ &log_info, const T &tmp, const U &... tmp2) {
@@ -184,23 +440,23 @@ namespace skyfire
 
     template<typename _Base>
     std::string sf_logger__<_Base>::make_time_str__() {
-        auto tt = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-        tm tm_d;
-        tm *ptm = &tm_d;
-#ifdef _MSC_VER
-        localtime_s(ptm, &tt);
-#else
-        ptm = localtime(&tt);
-#endif
-        std::ostringstream os;
-        os << std::put_time(ptm, "%Y-%m-%d %H:%M:%S");
-        return os.str();
+        return make_time_str__(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+
+    template<typename _Base>
+    std::string sf_logger__<_Base>::make_time_str__(long long ticks) {
+        return sf_log_time_str(ticks, time_precision__.load(std::memory_order_relaxed));
     }
 
     template<typename _Base>
     template<typename... T>
     void sf_logger__<_Base>::logout(SF_LOG_LEVEL level, const std::string &file, int line, const std::string &func,
                                     const T &... dt) {
+        if (!is_enabled(level))
+        {
+            return;
+        }
         sf_logger_info_t__ log_info;
         log_info.level = level;
         log_info.file = file;
@@ -250,27 +506,153 @@ namespace skyfire
     template <typename _Base>
     inline std::string sf_logger__<_Base>::format(std::string format_str, const sf_logger_info_t__& log_info)
     {
-        auto replace = [](std::string& str,const std::string &from, const std::string &to)
+        std::string out;
+        sf_log_format(format_str).render(out, log_info);
+        return out;
+    }
+
+    inline sf_log_format::sf_log_format(const std::string &format_str) {
+        static const std::pair<const char *, sf_log_format_field> fields[] = {
+                {"{level}",  sf_log_format_field::level},
+                {"{time}",   sf_log_format_field::time},
+                {"{thread}", sf_log_format_field::thread},
+                {"{file}",   sf_log_format_field::file},
+                {"{line}",   sf_log_format_field::line},
+                {"{func}",   sf_log_format_field::func},
+                {"{msg}",    sf_log_format_field::msg},
+        };
+        size_t pos = 0;
+        while (pos < format_str.size())
         {
-            size_t start_pos = 0;
-            while((start_pos = str.find(from, start_pos)) != std::string::npos) {
-                str.replace(start_pos, from.length(), to);
-                start_pos += to.length();
+            auto matched = false;
+            if (format_str[pos] == '{')
+            {
+                for (auto &p : fields)
+                {
+                    auto len = std::strlen(p.first);
+                    if (format_str.compare(pos, len, p.first) == 0)
+                    {
+                        segments__.push_back({p.second, std::string()});
+                        pos += len;
+                        matched = true;
+                        break;
+                    }
+                }
             }
-        };
-        auto thread_to_str=[](std::thread::id id){
-            std::ostringstream oss;
-            oss<<id;
-            return oss.str();
-        };
-        replace(format_str,"{func}",log_info.func);
-        replace(format_str,"{time}",log_info.time);
-        replace(format_str,"{thread}",thread_to_str(log_info.thread_id));
-        replace(format_str,"{line}",std::to_string(log_info.line));
-        replace(format_str,"{file}",log_info.file);
-        replace(format_str,"{level}",logger_level_str__[log_info.level]);
-        replace(format_str,"{msg}",log_info.msg);
-        return format_str;
+            if (!matched)
+            {
+                if (segments__.empty() || segments__.back().field != sf_log_format_field::literal)
+                {
+                    segments__.push_back({sf_log_format_field::literal, std::string()});
+                }
+                segments__.back().text += format_str[pos];
+                ++pos;
+            }
+        }
+    }
+
+    inline const std::string &sf_log_format::thread_str__(std::thread::id id) {
+        // NOTE 线程号转换需要经过ostringstream，缓存转换结果
+        thread_local std::unordered_map<std::thread::id, std::string> cache;
+        auto iter = cache.find(id);
+        if (iter != cache.end())
+        {
+            return iter->second;
+        }
+        if (cache.size() >= 4096)
+        {
+            cache.clear();
+        }
+        std::ostringstream oss;
+        oss << id;
+        return cache.emplace(id, oss.str()).first->second;
     }
 
+    inline void sf_log_format::render(std::string &out, const sf_logger_info_t__ &log_info) const {
+        render(out, log_info, thread_str__(log_info.thread_id));
+    }
+
+    inline void sf_log_format::render(std::string &out, const sf_logger_info_t__ &log_info,
+                                      const std::string &thread_str) const {
+        out.clear();
+        for (auto &segment : segments__)
+        {
+            switch (segment.field)
+            {
+                case sf_log_format_field::literal:
+                    out += segment.text;
+                    break;
+                case sf_log_format_field::level:
+                    if (log_info.level >= 0 && log_info.level < static_cast<int>(std::size(sf_log_level_str)))
+                    {
+                        out += sf_log_level_str[log_info.level];
+                    }
+                    break;
+                case sf_log_format_field::time:
+                    out += log_info.time;
+                    break;
+                case sf_log_format_field::thread:
+                    out += thread_str;
+                    break;
+                case sf_log_format_field::file:
+                    out += log_info.file;
+                    break;
+                case sf_log_format_field::line:
+                {
+                    char buffer[16];
+                    auto result = std::to_chars(buffer, buffer + sizeof(buffer), log_info.line);
+                    out.append(buffer, result.ptr);
+                    break;
+                }
+                case sf_log_format_field::func:
+                    out += log_info.func;
+                    break;
+                case sf_log_format_field::msg:
+                    out += log_info.msg;
+                    break;
+            }
+        }
+    }
+
+    inline long long sf_log_rate_state_t::pass__() {
+        return suppressed__.exchange(0, std::memory_order_relaxed);
+    }
+
+    inline long long sf_log_rate_state_t::suppress__() {
+        suppressed__.fetch_add(1, std::memory_order_relaxed);
+        return -1;
+    }
+
+    inline long long sf_log_rate_state_t::every_n(unsigned long long n) {
+        auto count = count__.fetch_add(1, std::memory_order_relaxed);
+        return n <= 1 || count % n == 0 ? pass__() : suppress__();
+    }
+
+    inline long long sf_log_rate_state_t::every_ms(long long ms) {
+        auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        auto last = last_ms__.load(std::memory_order_relaxed);
+        // NOTE 多个线程同时到达时只有交换成功的一个打印
+        if ((last == LLONG_MIN || now - last >= ms)
+            && last_ms__.compare_exchange_strong(last, now, std::memory_order_relaxed))
+        {
+            return pass__();
+        }
+        return suppress__();
+    }
+
+    inline long long sf_log_rate_state_t::sampled(double prob) {
+        if (prob >= 1.0)
+        {
+            return pass__();
+        }
+        // xorshift64*，每个线程一个随机数状态
+        thread_local unsigned long long state = std::hash<std::thread::id>()(std::this_thread::get_id())
+                                                | 1ULL;
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        auto value = static_cast<double>((state * 0x2545F4914F6CDD1DULL) >> 11) / 9007199254740992.0;
+        return value < prob ? pass__() : suppress__();
+    }
 }
@@ -21,6 +21,7 @@
 #include "sf_type.hpp"
 #include "sf_tcp_client.hpp"
 #include "sf_msg_bus_utils.h"
+#include "sf_pkg_compress.hpp"
 
 
 namespace skyfire
@@ -90,6 +91,24 @@ namespace skyfire
          */
         void send_msg(const std::string& type, const byte_array& data);
 
+        /**
+         * @brief set_serialize_profile 设置序列化方式（之后注册消息时服务器按该方式转发消息，不同字节序或字长的主机之间使用portable）
+         * @param profile 序列化方式
+         */
+        void set_serialize_profile(sf_binary_profile profile);
+
+        /**
+         * @brief set_compress_option 设置压缩选项（服务器也开启压缩时，双方发送的大消息都会被压缩，需要在连接之前设置）
+         * @param option 压缩选项
+         */
+        void set_compress_option(const sf_pkg_compress_option_t &option);
+
+        /**
+         * @brief compress_stat 压缩统计
+         * @return 统计数据
+         */
+        sf_pkg_compress_stat_t compress_stat() const;
+
         /**
          * @brief close 关闭总线客户端
          */
@@ -111,6 +130,12 @@ namespace skyfire
 
     private:
         std::shared_ptr<sf_tcp_client> p_client__ = sf_tcp_client::make_client();
+        sf_binary_profile serialize_profile__ = sf_binary_profile::native;
+        std::shared_ptr<sf_pkg_compressor> compressor__;
+        std::atomic<bool> peer_accept_compress__{false};
+
+        template<typename... _Type>
+        void send_pkg__(int type, const _Type &... value);
 
         void on_reg_data__(const sf_pkg_header_t& header, const byte_array& data);
 
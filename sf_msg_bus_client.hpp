@@ -45,43 +45,93 @@ namespace skyfire
     }
 
     inline void sf_msg_bus_client::reg_msg_to_bus(const std::string &type) {
-        p_client__->send(msg_bus_reg_type_single, sf_serialize_binary(type));
+        send_pkg__(msg_bus_reg_type_single, type);
     }
 
     inline void sf_msg_bus_client::reg_msg_to_bus(const std::vector<std::string> &types) {
-        p_client__->send(msg_bus_reg_type_multi, sf_serialize_binary(types));
+        send_pkg__(msg_bus_reg_type_multi, types);
     }
 
     inline void sf_msg_bus_client::unreg_msg_to_bus(const std::string &type) {
-        p_client__->send(msg_bus_unreg_single, sf_serialize_binary(type));
+        send_pkg__(msg_bus_unreg_single, type);
     }
 
     inline void sf_msg_bus_client::unreg_msg_to_bus(const std::vector<std::string> &types) {
-        p_client__->send(msg_bus_unreg_multi, sf_serialize_binary(types));
+        send_pkg__(msg_bus_unreg_multi, types);
     }
 
     inline bool sf_msg_bus_client::connect_to_server(const std::string &ip, unsigned short port) {
-        return p_client__->connect_to_server(ip,port);
+        if (!p_client__->connect_to_server(ip, port)) {
+            return false;
+        }
+        // NOTE 开启压缩时发送握手数据包，收到确认之前（不支持压缩的服务器不确认）发送的消息都不压缩
+        if (compressor__) {
+            p_client__->send(sf_make_pkg_frame(msg_bus_compress_req,
+                                               static_cast<unsigned char>(serialize_profile__) | sf_pkg_ex_accept_compress,
+                                               0, [](byte_array &) {}));
+        }
+        return true;
+    }
+
+    template<typename... _Type>
+    inline void sf_msg_bus_client::send_pkg__(int type, const _Type &... value) {
+        // NOTE 包头与数据一次写入准确大小的缓冲区，不复制到sf_msg_bus_t中（数据与序列化sf_msg_bus_t相同）
+        auto send_data = sf_make_pkg_frame(type, static_cast<unsigned char>(serialize_profile__), sf_serialized_size_obj_helper(value...),
+                                           [&](byte_array &buffer) {
+                                               sf_binary_writer writer(buffer, serialize_profile__);
+                                               sf_serialize_binary_obj_to_helper(writer, value...);
+                                           });
+        if (compressor__ && peer_accept_compress__) {
+            compressor__->compress_frame(send_data);
+        }
+        p_client__->send(send_data);
     }
 
     inline void sf_msg_bus_client::send_msg(const std::string &type, const byte_array &data) {
-        sf_msg_bus_t msg;
-        msg.type = type;
-        msg.data = data;
-        auto send_data = sf_serialize_binary(msg);
-        p_client__->send(msg_bus_new_msg, send_data);
+        send_pkg__(msg_bus_new_msg, type, data);
+    }
+
+    inline void sf_msg_bus_client::set_serialize_profile(sf_binary_profile profile) {
+        serialize_profile__ = profile;
+    }
+
+    inline void sf_msg_bus_client::set_compress_option(const sf_pkg_compress_option_t &option) {
+        compressor__ = option.enable ? std::make_shared<sf_pkg_compressor>(option) : nullptr;
+    }
+
+    inline sf_pkg_compress_stat_t sf_msg_bus_client::compress_stat() const {
+        return compressor__ ? compressor__->stat() : sf_pkg_compress_stat_t();
     }
 
     inline void sf_msg_bus_client::close() {
         p_client__->close();
+        peer_accept_compress__ = false;
     }
 
     inline void sf_msg_bus_client::on_reg_data__(const sf_pkg_header_t &header, const byte_array &data) {
-        if(header.type == msg_bus_new_msg)
+        unsigned char ex_flags;
+        size_t offset;
+        byte_array buffer;
+        auto body = sf_take_pkg_body(header, data, ex_flags, offset, buffer, compressor__.get());
+        if (body == nullptr) {
+            return;
+        }
+        auto type = sf_pkg_base_type(header.type);
+        if (type == msg_bus_compress_ack) {
+            peer_accept_compress__ = compressor__ != nullptr && (ex_flags & sf_pkg_ex_accept_compress);
+            return;
+        }
+        if(type == msg_bus_new_msg)
         {
-            sf_msg_bus_t msg_data;
-            sf_deserialize_binary(data, msg_data, 0);
-            msg_come(msg_data.type, msg_data.data);
+            if (!sf_is_binary_profile_supported(ex_flags & sf_pkg_ex_profile_mask)) {
+                return;
+            }
+            sf_binary_cursor cursor(*body, offset, static_cast<sf_binary_profile>(ex_flags & sf_pkg_ex_profile_mask));
+            sf_msg_bus_view_t msg_data;
+            if (!sf_try_deserialize_binary_from(cursor, msg_data)) {
+                return;
+            }
+            msg_come(std::string(msg_data.type), msg_data.data.to_byte_array());
         }
     }
 
@@ -18,12 +18,14 @@
 #pragma once
 
 #include <string>
+#include <mutex>
 
 #include "sf_msg_bus_utils.h"
 #include "sf_type.hpp"
 #include "sf_object.hpp"
 #include "sf_tcp_server.hpp"
 #include "sf_serialize_binary.hpp"
+#include "sf_pkg_compress.hpp"
 
 namespace skyfire {
 
@@ -85,13 +87,55 @@ namespace skyfire {
          */
         bool get_server_addr(sf_addr_info_t &addr);
 
+        /**
+         * @brief set_compress_option 设置压缩选项（只对开启了压缩的客户端压缩，需要在listen之前设置）
+         * @param option 压缩选项
+         */
+        void set_compress_option(const sf_pkg_compress_option_t &option);
+
+        /**
+         * @brief compress_stat 压缩统计（所有连接之和，包括已断开的连接）
+         * @return 统计数据
+         */
+        sf_pkg_compress_stat_t compress_stat() const;
+
     private:
         std::shared_ptr<sf_tcp_server> p_server__ = sf_tcp_server::make_server();
 
-        std::map<std::string, std::list<SOCKET>> msg_map__;
+        std::map<std::string, std::list<SOCKET>, std::less<>> msg_map__;
+        // NOTE 客户端的序列化方式，由客户端发送的数据包确定
+        std::map<SOCKET, sf_binary_profile> profile_map__;
+
+        sf_pkg_compress_option_t compress_option__;
+        // NOTE 开启了压缩的客户端的压缩上下文，由客户端的压缩握手确定
+        std::map<SOCKET, std::shared_ptr<sf_pkg_compressor>> compressor_map__;
+        sf_pkg_compress_stat_t closed_compress_stat__;
+        mutable std::mutex compress_mu__;
+
+        /**
+         *  @brief 一种序列化方式的消息数据包，压缩后的数据包在第一次发送给开启了压缩的客户端时生成
+         */
+        struct msg_frame_cache_t__
+        {
+            byte_array frame;
+            byte_array compressed;
+            bool compress_tried = false;
+        };
+
+        std::shared_ptr<sf_pkg_compressor> compressor_of__(SOCKET sock, bool create);
+
+        void send_cached_frame__(SOCKET sock, msg_frame_cache_t__ &cache);
+
+        unsigned char ex_flags_of__(sf_binary_profile profile) const;
 
         void reg_msg__(SOCKET sock, const std::string &msg_name);
 
+        sf_binary_profile profile_of__(SOCKET sock) const;
+
+        byte_array make_msg_frame__(std::string_view type, sf_byte_view data, sf_binary_profile profile) const;
+
+        void forward_msg__(std::string_view type, sf_byte_view data, sf_byte_view body, sf_binary_profile profile);
+
         void on_reg_data__(SOCKET sock, const sf_pkg_header_t &header, const byte_array &data);
 
         void unreg_msg__(SOCKET sock, const std::string &msg);
@@ -37,6 +37,13 @@ namespace skyfire {
         for (auto &p: remove_msg) {
             msg_map__.erase(p);
         }
+        profile_map__.erase(sock);
+        std::lock_guard<std::mutex> lck(compress_mu__);
+        auto iter = compressor_map__.find(sock);
+        if (iter != compressor_map__.end()) {
+            closed_compress_stat__ += iter->second->stat();
+            compressor_map__.erase(iter);
+        }
     }
 
     inline void sf_msg_bus_server::unreg_msg__(SOCKET sock, const std::string &msg) {
@@ -46,29 +53,63 @@ namespace skyfire {
     }
 
     inline void sf_msg_bus_server::on_reg_data__(SOCKET sock, const sf_pkg_header_t &header, const byte_array &data) {
-        if (header.type == msg_bus_reg_type_single) {
+        unsigned char ex_flags;
+        sf_take_pkg_ex_flags(header, data, ex_flags);
+        auto type = sf_pkg_base_type(header.type);
+        if (type == msg_bus_compress_req) {
+            // NOTE 双方都开启了压缩，通知客户端之后的大消息可以压缩（未开启压缩时不回复，客户端不压缩）
+            if (compress_option__.enable && (ex_flags & sf_pkg_ex_accept_compress)) {
+                compressor_of__(sock, true);
+                p_server__->send(sock, sf_make_pkg_frame(msg_bus_compress_ack, sf_pkg_ex_accept_compress, 0,
+                                                         [](byte_array &) {}));
+            }
+            return;
+        }
+        auto compressor = compressor_of__(sock, false);
+        size_t offset;
+        byte_array buffer;
+        auto body = sf_take_pkg_body(header, data, ex_flags, offset, buffer, compressor.get());
+        if (body == nullptr || !sf_is_binary_profile_supported(ex_flags & sf_pkg_ex_profile_mask)) {
+            return;
+        }
+        auto profile = static_cast<sf_binary_profile>(ex_flags & sf_pkg_ex_profile_mask);
+        profile_map__[sock] = profile;
+        // NOTE 数据包来自网络，解析失败（数据不完整或格式错误）时丢弃，不能在IO线程中抛出异常
+        sf_binary_cursor cursor(*body, offset, profile);
+        if (type == msg_bus_reg_type_single) {
             std::string name;
-            sf_deserialize_binary(data, name, 0);
+            if (!sf_try_deserialize_binary_from(cursor, name)) {
+                return;
+            }
             reg_msg__(sock, name);
-        } else if (header.type == msg_bus_reg_type_multi) {
+        } else if (type == msg_bus_reg_type_multi) {
             std::vector<std::string> names;
-            sf_deserialize_binary(data, names, 0);
+            if (!sf_try_deserialize_binary_from(cursor, names)) {
+                return;
+            }
             for (auto &p:names) {
                 reg_msg__(sock, p);
             }
-        } else if (header.type == msg_bus_new_msg) {
-            sf_msg_bus_t msg_data;
-            sf_deserialize_binary(data, msg_data, 0);
-            msg_come(sock, msg_data.type, msg_data.data);
+        } else if (type == msg_bus_new_msg) {
+            sf_msg_bus_view_t msg_data;
+            if (!sf_try_deserialize_binary_from(cursor, msg_data)) {
+                return;
+            }
+            msg_come(sock, std::string(msg_data.type), msg_data.data.to_byte_array());
             // TODO 服务器是否需要转发所有的消息？
-            send_msg(msg_data.type, msg_data.data);
-        } else if (header.type == msg_bus_unreg_single) {
+            forward_msg__(msg_data.type, msg_data.data, sf_byte_view(body->data() + offset, body->size() - offset),
+                          profile);
+        } else if (type == msg_bus_unreg_single) {
             std::string name;
-            sf_deserialize_binary(data, name, 0);
+            if (!sf_try_deserialize_binary_from(cursor, name)) {
+                return;
+            }
             unreg_msg__(sock, name);
-        } else if (header.type == msg_bus_unreg_multi) {
+        } else if (type == msg_bus_unreg_multi) {
             std::vector<std::string> names;
-            sf_deserialize_binary(data, names, 0);
+            if (!sf_try_deserialize_binary_from(cursor, names)) {
+                return;
+            }
             for (auto &p:names) {
                 unreg_msg__(sock, p);
             }
@@ -91,25 +132,125 @@ namespace skyfire {
         }
     }
 
+    inline sf_binary_profile sf_msg_bus_server::profile_of__(SOCKET sock) const {
+        auto iter = profile_map__.find(sock);
+        return iter == profile_map__.end() ? sf_binary_profile::native : iter->second;
+    }
+
+    inline byte_array
+    sf_msg_bus_server::make_msg_frame__(std::string_view type, sf_byte_view data, sf_binary_profile profile) const {
+        // NOTE 包头与消息一次写入准确大小的缓冲区，不复制到sf_msg_bus_t中（数据与序列化sf_msg_bus_t相同）
+        return sf_make_pkg_frame(msg_bus_new_msg, ex_flags_of__(profile),
+                                 sf_serialized_size(type) + sf_serialized_size(data), [&](byte_array &buffer) {
+                    sf_binary_writer writer(buffer, profile);
+                    sf_serialize_binary_to(writer, type);
+                    sf_serialize_binary_to(writer, data);
+                });
+    }
+
     inline void sf_msg_bus_server::send_msg(const std::string &type, const byte_array &data) {
-        sf_msg_bus_t msg;
-        msg.type = type;
-        msg.data = data;
-        auto send_data = sf_serialize_binary(msg);
-        if (msg_map__.count(type) != 0) {
-            for (auto &sock : msg_map__[type]) {
-                p_server__->send(sock, msg_bus_new_msg, send_data);
+        auto iter = msg_map__.find(type);
+        if (iter == msg_map__.end()) {
+            return;
+        }
+        // NOTE 每种序列化方式只生成（压缩）一次数据包
+        msg_frame_cache_t__ frames[sf_pkg_ex_profile_mask + 1];
+        for (auto &sock : iter->second) {
+            auto &cache = frames[static_cast<unsigned char>(profile_of__(sock))];
+            if (cache.frame.empty()) {
+                cache.frame = make_msg_frame__(type, data, profile_of__(sock));
+            }
+            send_cached_frame__(sock, cache);
+        }
+    }
+
+    inline void sf_msg_bus_server::forward_msg__(std::string_view type, sf_byte_view data, sf_byte_view body,
+                                                 sf_binary_profile profile) {
+        auto iter = msg_map__.find(type);
+        if (iter == msg_map__.end()) {
+            return;
+        }
+        msg_frame_cache_t__ frames[sf_pkg_ex_profile_mask + 1];
+        for (auto &sock : iter->second) {
+            auto sock_profile = profile_of__(sock);
+            auto &cache = frames[static_cast<unsigned char>(sock_profile)];
+            if (cache.frame.empty()) {
+                if (sock_profile == profile) {
+                    // NOTE 序列化方式相同时，收到的数据就是序列化后的消息，直接加上包头转发，不重新序列化
+                    cache.frame = sf_make_pkg_frame(msg_bus_new_msg, ex_flags_of__(profile), body.size(),
+                                                    [&](byte_array &buffer) {
+                                                        buffer.insert(buffer.end(), body.begin(), body.end());
+                                                    });
+                } else {
+                    cache.frame = make_msg_frame__(type, data, sock_profile);
+                }
+            }
+            send_cached_frame__(sock, cache);
+        }
+    }
+
+    inline unsigned char sf_msg_bus_server::ex_flags_of__(sf_binary_profile profile) const {
+        // NOTE 只带客户端使用的序列化方式，旧版本客户端（native方式）收到的数据包不变
+        return static_cast<unsigned char>(profile);
+    }
+
+    inline std::shared_ptr<sf_pkg_compressor> sf_msg_bus_server::compressor_of__(SOCKET sock, bool create) {
+        std::lock_guard<std::mutex> lck(compress_mu__);
+        auto iter = compressor_map__.find(sock);
+        if (iter != compressor_map__.end()) {
+            return iter->second;
+        }
+        if (!create) {
+            return nullptr;
+        }
+        return compressor_map__[sock] = std::make_shared<sf_pkg_compressor>(compress_option__);
+    }
+
+    inline void sf_msg_bus_server::send_cached_frame__(SOCKET sock, msg_frame_cache_t__ &cache) {
+        if (auto compressor = compressor_of__(sock, false)) {
+            // NOTE 压缩结果与使用哪个连接的上下文无关，只压缩一次（统计计入第一个连接）
+            if (!cache.compress_tried) {
+                cache.compress_tried = true;
+                cache.compressed = cache.frame;
+                if (!compressor->compress_frame(cache.compressed)) {
+                    cache.compressed.clear();
+                }
+            }
+            if (!cache.compressed.empty()) {
+                p_server__->send(sock, cache.compressed);
+                return;
             }
         }
+        p_server__->send(sock, cache.frame);
     }
 
     inline void sf_msg_bus_server::clear_client() {
         msg_map__.clear();
+        profile_map__.clear();
     }
 
     inline void sf_msg_bus_server::close() {
         p_server__->close();
         msg_map__.clear();
+        profile_map__.clear();
+        std::lock_guard<std::mutex> lck(compress_mu__);
+        for (auto &p : compressor_map__) {
+            closed_compress_stat__ += p.second->stat();
+        }
+        compressor_map__.clear();
+    }
+
+    inline void sf_msg_bus_server::set_compress_option(const sf_pkg_compress_option_t &option) {
+        compress_option__ = option;
+    }
+
+    inline sf_pkg_compress_stat_t sf_msg_bus_server::compress_stat() const {
+        std::lock_guard<std::mutex> lck(compress_mu__);
+        auto ret = closed_compress_stat__;
+        for (auto &p : compressor_map__) {
+            ret += p.second->stat();
+        }
+        return ret;
     }
 
     inline bool sf_msg_bus_server::listen(const std::string &ip, unsigned short port) {
@@ -14,6 +14,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 #include "sf_type.hpp"
 #include "sf_serialize_binary.hpp"
@@ -26,6 +27,10 @@ namespace skyfire
     constexpr int msg_bus_new_msg = 2;
     constexpr int msg_bus_unreg_single = 3;
     constexpr int msg_bus_unreg_multi = 4;
+    // NOTE 压缩握手：开启了压缩的客户端连接后发送msg_bus_compress_req，服务器也开启了压缩时回复msg_bus_compress_ack，
+    // 之后双方发送的大消息开始压缩（不支持压缩的服务器忽略请求，不回复，客户端始终发送不压缩的数据包）
+    constexpr int msg_bus_compress_ack = 5;
+    constexpr int msg_bus_compress_req = 6;
 
     /**
      *   @brief  消息总线数据
@@ -38,4 +43,15 @@ namespace skyfire
 
     SF_MAKE_SERIALIZABLE_BINARY(sf_msg_bus_t, type, data)
 
+    /**
+     *   @brief  消息总线数据视图（与sf_msg_bus_t序列化结果相同，反序列化时不复制数据）
+     */
+    struct sf_msg_bus_view_t
+    {
+        std::string_view type;
+        sf_byte_view data;
+    };
+
+    SF_MAKE_SERIALIZABLE_BINARY(sf_msg_bus_view_t, type, data)
+
 }
\ No newline at end of file
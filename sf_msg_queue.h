@@ -1,4 +1,3 @@
-
 /**
 * @version 1.0.0
 * @author skyfire
@@ -18,39 +17,125 @@
 #pragma once
 
 #include "sf_single_instance.hpp"
+#include "sf_small_function.hpp"
+#include <atomic>
 #include <functional>
-#include <list>
+#include <vector>
 #include <map>
+#include <unordered_map>
+#include <memory>
 #include <mutex>
 #include <algorithm>
 #include <condition_variable>
 
 namespace skyfire
 {
+    /**
+     * 队列中的消息函数（小对象优化，捕获的数据不超过内联容量时投递消息不分配内存）
+     */
+    using sf_msg_func_t = sf_small_function<void()>;
+
     /**
      *  @brief 消息队列
+     *  每个事件循环可以拥有独立的消息队列，get_instance/get_global_queue获取的全局队列作为默认队列
      */
     class sf_msg_queue
     {
     public:
         SF_SINGLE_TON(sf_msg_queue);
-    private:
+
+        /**
+         * @brief sf_msg_queue 构造一个独立的消息队列
+         */
         sf_msg_queue();
-        std::list<std::pair<void*,std::function<void()>>> func_data__;
-        std::mutex mu_func_data_op__;
 
-        std::mutex wait_mu__;
+        ~sf_msg_queue();
+
+        /**
+         * 获取全局（默认）消息队列
+         * @return 全局消息队列
+         */
+        static std::shared_ptr<sf_msg_queue> get_global_queue();
+    private:
+        /**
+         *  @brief 队列中的消息
+         */
+        struct sf_msg_t__
+        {
+            void *id;                                   // 对象
+            unsigned long long generation;              // 投递时对象的消息代数
+            sf_msg_func_t func;                         // 要调用的函数
+        };
+
+        /**
+         *  @brief 对象的消息状态（仅在对象有未处理消息时存在）
+         */
+        struct sf_msg_id_state_t__
+        {
+            unsigned long long generation = 0;          // 当前代数，remove_msg时递增，旧代数的消息出队时被跳过
+            size_t pending = 0;                         // 队列中属于此对象的消息数量（包括已作废的消息）
+            size_t valid = 0;                           // 队列中属于此对象的有效消息数量
+            bool removed = false;                       // 已调用remove_msg，未处理消息清空后删除状态
+        };
+
+        static constexpr size_t msg_block_size__ = 64;
+        static constexpr size_t max_free_block_count__ = 16;
+        // NOTE take每次持有锁时最多跳过的作废消息数量（暂存在栈上，在锁外析构）
+        static constexpr size_t max_canceled_per_lock__ = 16;
+        // NOTE 作废消息不少于此数量且不少于队列的一半时整理队列，释放作废消息（捕获的数据），
+        // 没有消费者（如事件循环已退出）时作废消息也不会无限保留
+        static constexpr size_t compact_threshold__ = 1024;
+
+        /**
+         *  @brief 消息块，队列由消息块组成的单链表构成
+         */
+        struct sf_msg_block_t__
+        {
+            sf_msg_t__ msgs[msg_block_size__];
+            sf_msg_block_t__ *next = nullptr;
+        };
+
+        // NOTE 出队后的消息块放入空闲链表复用，稳定运行时入队出队不分配内存；扩容时也不搬移已有消息
+        sf_msg_block_t__ *head_block__ = nullptr;
+        sf_msg_block_t__ *tail_block__ = nullptr;
+        sf_msg_block_t__ *free_block_list__ = nullptr;
+        size_t free_block_count__ = 0;
+        size_t head_index__ = 0;
+        size_t tail_index__ = 0;
+        size_t func_data_size__ = 0;
+        size_t canceled_size__ = 0;
+        std::unordered_map<void*, sf_msg_id_state_t__> id_state__;
+        std::mutex mu_func_data_op__;
         std::condition_variable wait_cond__;
+        // NOTE 通知函数在mu_notify__内设置与调用，set_notify_func返回后不会再调用旧的通知函数（如已关闭的eventfd）
+        std::function<void()> notify_func__;
+        std::mutex mu_notify__;
+        std::atomic<bool> has_notify__{false};
+        unsigned long long wake_generation__ = 0;
+
+        sf_msg_block_t__ *alloc_block__();
+
+        void recycle_block__(sf_msg_block_t__ *block);
+
+        void push_msg__(sf_msg_t__ &&msg);
+
+        sf_msg_t__ &front_msg__();
+
+        void pop_msg__();
+
+        void compact__();
+
+        void notify__();
     public:
         /**
          * 增加消息
          * @param id 对象
          * @param func 要调用的函数
          */
-        void add_msg(void *id, std::function<void()> func);
+        void add_msg(void *id, sf_msg_func_t func);
 
         /**
-         * 删除对象的所有消息
+         * 删除对象的所有消息（均摊O(1)，消息被标记作废，出队时跳过；作废消息占队列一半以上时整理队列释放）
          * @param id 对象
          */
         void remove_msg(void *id);
@@ -62,9 +147,9 @@ namespace skyfire
 
         /**
          * 获取一条消息
-         * @return
+         * @return 消息函数（队列为空时为空函数）
          */
-        std::function<void()> take();
+        sf_msg_func_t take();
 
         /**
          * 判断是否队列为空
@@ -73,7 +158,7 @@ namespace skyfire
         bool empty();
 
         /**
-         * 等待消息到来
+         * 等待消息到来（队列非空或被add_empty_msg唤醒时返回）
          */
         void wait_msg();
 
@@ -81,6 +166,12 @@ namespace skyfire
          * 添加一个空消息
          */
         void add_empty_msg();
+
+        /**
+         * 设置消息到来通知函数（在add_msg/add_empty_msg后调用，用于唤醒非条件变量等待的事件循环，如epoll）
+         * @param func 通知函数
+         */
+        void set_notify_func(std::function<void()> func);
     };
 
 }
@@ -1,4 +1,3 @@
-
 /**
 * @version 1.0.0
 * @author skyfire
@@ -24,45 +23,283 @@ namespace skyfire
 
     inline sf_msg_queue::sf_msg_queue() {}
 
-    inline void sf_msg_queue::add_msg(void *id, std::function<void()> func) {
-        std::lock_guard<std::mutex> lck(mu_func_data_op__);
-        func_data__.emplace_back(id, func);
-        wait_cond__.notify_all();
+    inline std::shared_ptr<sf_msg_queue> sf_msg_queue::get_global_queue() {
+        // NOTE 全局队列永不释放，此处使用空删除器
+        static std::shared_ptr<sf_msg_queue> global_queue(get_instance(), [](sf_msg_queue *) {});
+        return global_queue;
+    }
+
+    inline sf_msg_queue::~sf_msg_queue() {
+        for (auto block : {head_block__, free_block_list__})
+        {
+            while (block != nullptr)
+            {
+                auto next = block->next;
+                delete block;
+                block = next;
+            }
+        }
+    }
+
+    inline sf_msg_queue::sf_msg_block_t__ *sf_msg_queue::alloc_block__() {
+        if(free_block_list__ == nullptr)
+        {
+            return new sf_msg_block_t__;
+        }
+        auto block = free_block_list__;
+        free_block_list__ = block->next;
+        block->next = nullptr;
+        --free_block_count__;
+        return block;
+    }
+
+    inline void sf_msg_queue::recycle_block__(sf_msg_block_t__ *block) {
+        if(free_block_count__ >= max_free_block_count__)
+        {
+            delete block;
+            return;
+        }
+        block->next = free_block_list__;
+        free_block_list__ = block;
+        ++free_block_count__;
+    }
+
+    inline void sf_msg_queue::push_msg__(sf_msg_t__ &&msg) {
+        if(tail_block__ == nullptr)
+        {
+            head_block__ = tail_block__ = alloc_block__();
+            head_index__ = tail_index__ = 0;
+        }
+        else if(tail_index__ == msg_block_size__)
+        {
+            tail_block__->next = alloc_block__();
+            tail_block__ = tail_block__->next;
+            tail_index__ = 0;
+        }
+        tail_block__->msgs[tail_index__++] = std::move(msg);
+        ++func_data_size__;
+    }
+
+    inline sf_msg_queue::sf_msg_t__ &sf_msg_queue::front_msg__() {
+        return head_block__->msgs[head_index__];
+    }
+
+    inline void sf_msg_queue::pop_msg__() {
+        --func_data_size__;
+        if(++head_index__ < msg_block_size__ && func_data_size__ != 0)
+        {
+            return;
+        }
+        if(func_data_size__ == 0)
+        {
+            // NOTE 队列为空时保留当前块，从头开始使用
+            for (auto block = head_block__->next; block != nullptr;)
+            {
+                auto next = block->next;
+                recycle_block__(block);
+                block = next;
+            }
+            head_block__->next = nullptr;
+            tail_block__ = head_block__;
+            head_index__ = tail_index__ = 0;
+            return;
+        }
+        auto block = head_block__;
+        head_block__ = block->next;
+        head_index__ = 0;
+        recycle_block__(block);
+    }
+
+    inline void sf_msg_queue::add_msg(void *id, sf_msg_func_t func) {
+        {
+            std::lock_guard<std::mutex> lck(mu_func_data_op__);
+            auto &state = id_state__[id];
+            ++state.pending;
+            ++state.valid;
+            state.removed = false;
+            push_msg__(sf_msg_t__{id, state.generation, std::move(func)});
+            wait_cond__.notify_all();
+        }
+        notify__();
     }
 
     inline void sf_msg_queue::remove_msg(void *id) {
         std::lock_guard<std::mutex> lck(mu_func_data_op__);
-        func_data__.remove_if([=](const std::pair<void*,std::function<void()>> dt){
-            return dt.first == id;
-        });
+        auto iter = id_state__.find(id);
+        if(iter == id_state__.end())
+        {
+            return;
+        }
+        if(iter->second.pending == 0)
+        {
+            id_state__.erase(iter);
+            return;
+        }
+        ++iter->second.generation;
+        iter->second.removed = true;
+        canceled_size__ += iter->second.valid;
+        iter->second.valid = 0;
+        // NOTE 每次整理至少释放一半的消息，整理的开销均摊到作废的消息上
+        if(canceled_size__ >= compact_threshold__ && canceled_size__ * 2 >= func_data_size__)
+        {
+            compact__();
+        }
+    }
+
+    inline void sf_msg_queue::compact__() {
+        // NOTE 有效消息按顺序前移，作废消息在锁内析构（整理不频繁）
+        auto read_block = head_block__;
+        auto read_index = head_index__;
+        auto write_block = head_block__;
+        auto write_index = head_index__;
+        size_t kept = 0;
+        for(size_t i = 0; i < func_data_size__; ++i)
+        {
+            if(read_index == msg_block_size__)
+            {
+                read_block = read_block->next;
+                read_index = 0;
+            }
+            auto &msg = read_block->msgs[read_index++];
+            auto iter = id_state__.find(msg.id);
+            if(msg.generation == iter->second.generation)
+            {
+                if(write_index == msg_block_size__)
+                {
+                    write_block = write_block->next;
+                    write_index = 0;
+                }
+                auto &target = write_block->msgs[write_index++];
+                if(&target != &msg)
+                {
+                    target = std::move(msg);
+                }
+                ++kept;
+                continue;
+            }
+            msg.func = nullptr;
+            if(--iter->second.pending == 0 && iter->second.removed)
+            {
+                id_state__.erase(iter);
+            }
+        }
+        func_data_size__ = kept;
+        canceled_size__ = 0;
+        for(auto block = write_block->next; block != nullptr;)
+        {
+            auto next = block->next;
+            recycle_block__(block);
+            block = next;
+        }
+        write_block->next = nullptr;
+        tail_block__ = write_block;
+        tail_index__ = write_index;
+        if(kept == 0)
+        {
+            head_index__ = tail_index__ = 0;
+        }
     }
 
     inline void sf_msg_queue::clear() {
         std::lock_guard<std::mutex> lck(mu_func_data_op__);
-        func_data__.clear();
+        while(func_data_size__ != 0)
+        {
+            front_msg__().func = nullptr;
+            pop_msg__();
+        }
+        id_state__.clear();
+        canceled_size__ = 0;
     }
 
-    inline std::function<void()> sf_msg_queue::take() {
-        std::lock_guard<std::mutex> lck(mu_func_data_op__);
-        if(func_data__.empty())
+    inline sf_msg_func_t sf_msg_queue::take() {
+        sf_msg_func_t ret;
+        // NOTE 作废的消息暂存在栈上的数组中，在锁外析构，避免捕获对象的析构阻塞生产者（锁内不分配内存）；
+        // 数组满时先释放锁析构，再继续查找
+        sf_msg_func_t canceled[max_canceled_per_lock__];
+        auto full = true;
+        while(full)
         {
-            return std::function<void()>();
+            full = false;
+            size_t canceled_count = 0;
+            {
+                std::lock_guard<std::mutex> lck(mu_func_data_op__);
+                while(func_data_size__ != 0)
+                {
+                    auto &msg = front_msg__();
+                    auto iter = id_state__.find(msg.id);
+                    auto valid = msg.generation == iter->second.generation;
+                    // NOTE 对象的状态在remove_msg之前一直保留，避免频繁投递时反复分配状态节点
+                    if(valid)
+                    {
+                        --iter->second.valid;
+                    }
+                    else
+                    {
+                        --canceled_size__;
+                    }
+                    if(--iter->second.pending == 0 && iter->second.removed)
+                    {
+                        id_state__.erase(iter);
+                    }
+                    if(valid)
+                    {
+                        ret = std::move(msg.func);
+                        pop_msg__();
+                        break;
+                    }
+                    canceled[canceled_count++] = std::move(msg.func);
+                    pop_msg__();
+                    if(canceled_count == max_canceled_per_lock__)
+                    {
+                        full = true;
+                        break;
+                    }
+                }
+            }
+            for(size_t i = 0; i < canceled_count; ++i)
+            {
+                canceled[i] = nullptr;
+            }
         }
-        auto ret = func_data__.begin()->second;
-        func_data__.pop_front();
         return ret;
     }
 
     inline bool sf_msg_queue::empty() {
-        return func_data__.empty();
+        std::lock_guard<std::mutex> lck(mu_func_data_op__);
+        return func_data_size__ == 0;
     }
 
     inline void sf_msg_queue::wait_msg() {
-        std::unique_lock<std::mutex> lck(wait_mu__);
-        wait_cond__.wait(lck);
+        std::unique_lock<std::mutex> lck(mu_func_data_op__);
+        // NOTE 使用唤醒代数而不是标志位，保证共享同一队列的所有事件循环都能被唤醒
+        auto generation = wake_generation__;
+        wait_cond__.wait(lck, [&] { return func_data_size__ != 0 || generation != wake_generation__; });
     }
 
     inline void sf_msg_queue::add_empty_msg() {
-        wait_cond__.notify_all();
+        {
+            std::lock_guard<std::mutex> lck(mu_func_data_op__);
+            ++wake_generation__;
+            wait_cond__.notify_all();
+        }
+        notify__();
+    }
+
+    inline void sf_msg_queue::notify__() {
+        if(!has_notify__.load(std::memory_order_acquire))
+        {
+            return;
+        }
+        std::lock_guard<std::mutex> lck(mu_notify__);
+        if(notify_func__)
+        {
+            notify_func__();
+        }
+    }
+
+    inline void sf_msg_queue::set_notify_func(std::function<void()> func) {
+        std::lock_guard<std::mutex> lck(mu_notify__);
+        notify_func__ = std::move(func);
+        has_notify__.store(static_cast<bool>(notify_func__), std::memory_order_release);
     }
 }
@@ -22,34 +22,29 @@
 #include <vector>
 #include <thread>
 #include <functional>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <tuple>
 #include "sf_empty_class.hpp"
 #include "sf_msg_queue.hpp"
 #include "sf_eventloop.hpp"
+#include "sf_rcu.hpp"
 
 /*
  * SF_REG_SIGNAL 注册信号的宏
+ * 槽列表保存在sf_rcu中，发射信号时读取快照后遍历，不加锁；绑定/解绑时复制并替换快照
+ * （槽函数中可以再次发射信号或绑定/解绑，本次发射仍使用旧快照）
+ * 排队槽函数的参数在只有一个排队槽函数时移动到消息中，有多个时共享同一份拷贝
  */
 #define SF_REG_SIGNAL(name,...)                                                                                         \
 public:                                                                                                                \
-std::recursive_mutex __mu_##name##_signal_;                                                                             \
-std::vector<std::tuple<std::function<void(__VA_ARGS__)>, bool, int>>__##name##_signal_func_vec__;                     \
+skyfire::sf_rcu<std::vector<std::tuple<std::shared_ptr<const std::function<void(__VA_ARGS__)>>, bool, int,             \
+    std::shared_ptr<skyfire::sf_object_handle_t>>>> __##name##_signal_func_vec__;                                      \
 template<typename...__SF_OBJECT_ARGS__>                                                                              \
 void name(__SF_OBJECT_ARGS__&&... args) {                                                                              \
-    std::lock_guard<std::recursive_mutex> lck(__mu_##name##_signal_);                                                   \
-    for (auto &p :__##name##_signal_func_vec__)                                                                        \
-    {                                                                                                                   \
-        if (std::get<1>(p))                                                                                             \
-        {                                                                                                               \
-            std::get<0>(p)(std::forward<__SF_OBJECT_ARGS__>(args)...);                                                  \
-        }                                                                                                               \
-        else                                                                                                            \
-        {                                                                                                               \
-            auto bind_obj = std::bind(std::get<0>(p),                                                                   \
-                                         std::forward<__SF_OBJECT_ARGS__>(args)...);                                    \
-            __p_msg_queue__->add_msg(this, bind_obj);                                                                  \
-                                                                                                                        \
-        }                                                                                                               \
-    }                                                                                                                   \
+    auto __sf_slots = __##name##_signal_func_vec__.read();                                                              \
+    __sf_emit_helper(*__sf_slots, std::forward<__SF_OBJECT_ARGS__>(args)...);                                           \
 }                                                                                                                       \
 
 
@@ -116,18 +111,39 @@ public:
  * sf_bind_signal 信号绑定
  */
 #define sf_bind_signal(objptr,name,func,mul_thread)                                                                     \
-(objptr)->__sf_bind_helper((objptr)->__mu_##name##_signal_,(objptr)->__##name##_signal_func_vec__,func,mul_thread)      \
+(objptr)->__sf_bind_helper((objptr)->__##name##_signal_func_vec__,func,mul_thread)                                 \
+
+
+/*
+ * sf_bind_signal_to 信号绑定到接收对象，槽函数总是投递到接收对象所在的事件循环中执行
+ * （接收对象析构后不再投递，已投递未执行的槽函数也会被取消）
+ */
+#define sf_bind_signal_to(objptr,name,receiver,func)                                                                    \
+(objptr)->__sf_bind_helper((objptr)->__##name##_signal_func_vec__,func,false,&*(receiver))                          \
 
 
 /*
  * sf_unbind_signal 信号解绑
  */
 #define sf_unbind_signal(objptr,name,bind_id)                                                                           \
-(objptr)->__sf_signal_unbind_helper((objptr)->__mu_##name##_signal_,(objptr)->__##name##_signal_func_vec__,bind_id);    \
+(objptr)->__sf_signal_unbind_helper((objptr)->__##name##_signal_func_vec__,bind_id);                               \
 
 
 namespace skyfire
 {
+    class sf_object;
+
+    /**
+     *  @brief 接收对象句柄，由绑定到该对象的排队槽函数共享，对象析构时置空
+     */
+    struct sf_object_handle_t
+    {
+        std::mutex mu;
+        sf_object *object;
+
+        explicit sf_object_handle_t(sf_object *obj) : object(obj) {}
+    };
+
     /**
      *  @brief 元对象
      */
@@ -135,10 +151,11 @@ namespace skyfire
     {
     public:
         template<typename _VectorType, typename _FuncType>
-        int __sf_bind_helper(std::recursive_mutex &mu,_VectorType &vec, _FuncType func, bool mul_thread);
+        int __sf_bind_helper(sf_rcu<_VectorType> &vec, _FuncType func, bool mul_thread,
+                             sf_object *receiver = nullptr);
 
         template<typename _VectorType>
-        void __sf_signal_unbind_helper(std::recursive_mutex &mu,_VectorType &vec, int bind_id);
+        void __sf_signal_unbind_helper(sf_rcu<_VectorType> &vec, int bind_id);
 
         template<typename _VectorType, typename _FuncType>
         int __sf_aop_before_add_helper(std::recursive_mutex &mu,_VectorType &vec, _FuncType func);
@@ -150,10 +167,39 @@ namespace skyfire
         void __sf_aop_unbind_helper(std::recursive_mutex &mu,_VectorType &vec, int bind_id);
 
 
+        template<typename _VectorType, typename... _Args>
+        void __sf_emit_helper(const _VectorType &slots, _Args &&... args);
+
+        void __sf_post_slot_msg(const std::shared_ptr<sf_object_handle_t> &receiver, sf_msg_func_t func);
+
+        std::shared_ptr<sf_object_handle_t> __sf_handle();
+
+        /**
+         * 修改对象的线程亲和性，之后投递给此对象的排队槽函数都在指定的事件循环中执行
+         * （移动前已投递的消息仍在原事件循环中执行）。
+         * 若事件循环为反应堆模式，之后启动的tcp服务器/客户端和定时器会直接在该事件循环中处理IO与超时
+         * @param loop 事件循环，nullptr表示恢复到全局消息队列
+         */
+        void move_to_thread(sf_eventloop *loop);
+
+        /**
+         * 获取对象所在的事件循环
+         * @return 事件循环，nullptr表示全局消息队列
+         */
+        sf_eventloop *get_eventloop() const;
+
         virtual ~sf_object();
 
     protected:
-        sf_msg_queue* __p_msg_queue__ = sf_msg_queue::get_instance();
+        std::atomic<sf_eventloop *> __p_eventloop__{nullptr};
+
+        // NOTE 发射信号时只读取裸指针；移动过的队列都保存在__msg_queue_holder__中直到对象析构，
+        // 保证与move_to_thread并发的发射不会访问已释放的队列
+        std::atomic<sf_msg_queue *> __p_msg_queue__{sf_msg_queue::get_instance()};
+        std::mutex __mu_msg_queue_holder__;
+        std::vector<std::shared_ptr<sf_msg_queue>> __msg_queue_holder__;
+        // NOTE 第一次作为接收对象绑定时创建（由__mu_msg_queue_holder__保护），析构时置空，之后的发射跳过该接收对象
+        std::shared_ptr<sf_object_handle_t> __handle__;
     };
 
 }
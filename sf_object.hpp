@@ -24,21 +24,155 @@ namespace skyfire
 {
 
     template<typename _VectorType, typename _FuncType>
-    int sf_object::__sf_bind_helper(std::recursive_mutex &mu, _VectorType &vec, _FuncType func, bool mul_thread) {
-        std::lock_guard<std::recursive_mutex> lck(mu);
-        int bind_id = rand();
-        while(std::find_if(vec.begin(),vec.end(),[=](auto p){
-            return std::get<2>(p) == bind_id;
-        }) != vec.end())
-        {
+    int sf_object::__sf_bind_helper(sf_rcu<_VectorType> &vec, _FuncType func, bool mul_thread,
+                                    sf_object *receiver) {
+        int bind_id = 0;
+        vec.update([&](_VectorType &slots) {
             bind_id = rand();
-        }
-        vec.push_back(std::make_tuple(func, mul_thread, bind_id));
+            while (std::find_if(slots.begin(), slots.end(), [=](auto &p) {
+                return std::get<2>(p) == bind_id;
+            }) != slots.end())
+            {
+                bind_id = rand();
+            }
+            using slot_func_type = std::remove_const_t<typename std::tuple_element_t<
+                    0, typename _VectorType::value_type>::element_type>;
+            slots.emplace_back(std::make_shared<slot_func_type>(func), mul_thread, bind_id,
+                               receiver == nullptr ? nullptr : receiver->__sf_handle());
+        });
         return bind_id;
     }
 
+    template<typename _VectorType, typename... _Args>
+    void sf_object::__sf_emit_helper(const _VectorType &slots, _Args &&... args) {
+        size_t queued_count = 0;
+        for (auto &p : slots)
+        {
+            if (!std::get<1>(p))
+            {
+                ++queued_count;
+            }
+        }
+        if (queued_count == 0)
+        {
+            if (slots.size() == 1)
+            {
+                (*std::get<0>(slots.front()))(std::forward<_Args>(args)...);
+                return;
+            }
+            for (auto &p : slots)
+            {
+                (*std::get<0>(p))(args...);
+            }
+            return;
+        }
+
+        // NOTE 只有一个排队槽函数且没有直接调用的槽函数时参数可以移动到消息中，否则只能复制
+        auto move_args = queued_count == 1 && slots.size() == 1;
+        auto make_args = [&]() {
+            if (move_args)
+            {
+                return std::tuple<std::decay_t<_Args>...>(std::forward<_Args>(args)...);
+            }
+            return std::tuple<std::decay_t<_Args>...>(args...);
+        };
+
+        // NOTE 参数都可以按位复制时每个槽函数复制一份（不分配内存），否则多个排队槽函数共享一份
+        constexpr bool share_args = !(std::is_trivially_copyable<std::decay_t<_Args>>::value && ...);
+        if (queued_count == 1 || !share_args)
+        {
+            for (auto &p : slots)
+            {
+                if (std::get<1>(p))
+                {
+                    (*std::get<0>(p))(args...);
+                }
+                else
+                {
+                    __sf_post_slot_msg(std::get<3>(p), [func = std::get<0>(p), slot_args = make_args()]() mutable {
+                        std::apply(*func, slot_args);
+                    });
+                }
+            }
+            return;
+        }
+
+        // NOTE 多个排队槽函数共享同一份参数（只读），避免每个槽函数复制一次（如byte_array）
+        std::shared_ptr<const std::tuple<std::decay_t<_Args>...>> shared_args;
+        for (auto &p : slots)
+        {
+            if (std::get<1>(p))
+            {
+                (*std::get<0>(p))(args...);
+            }
+            else
+            {
+                if (!shared_args)
+                {
+                    shared_args = std::make_shared<const std::tuple<std::decay_t<_Args>...>>(make_args());
+                }
+                __sf_post_slot_msg(std::get<3>(p), [func = std::get<0>(p), shared_args] {
+                    std::apply(*func, *shared_args);
+                });
+            }
+        }
+    }
+
+    inline void sf_object::__sf_post_slot_msg(const std::shared_ptr<sf_object_handle_t> &receiver, sf_msg_func_t func) {
+        if (receiver == nullptr) {
+            __p_msg_queue__.load(std::memory_order_acquire)->add_msg(this, std::move(func));
+            return;
+        }
+        // NOTE 持有句柄的锁投递，接收对象析构时置空句柄后再移除消息，投递的消息不会在析构后残留
+        std::lock_guard<std::mutex> lck(receiver->mu);
+        auto target = receiver->object;
+        if (target == nullptr) {
+            return;
+        }
+        target->__p_msg_queue__.load(std::memory_order_acquire)->add_msg(target, std::move(func));
+    }
+
+    inline std::shared_ptr<sf_object_handle_t> sf_object::__sf_handle() {
+        std::lock_guard<std::mutex> lck(__mu_msg_queue_holder__);
+        if (__handle__ == nullptr) {
+            __handle__ = std::make_shared<sf_object_handle_t>(this);
+        }
+        return __handle__;
+    }
+
+    inline void sf_object::move_to_thread(sf_eventloop *loop) {
+        auto queue = loop == nullptr ? sf_msg_queue::get_global_queue() : loop->get_msg_queue();
+        std::lock_guard<std::mutex> lck(__mu_msg_queue_holder__);
+        if (std::find(__msg_queue_holder__.begin(), __msg_queue_holder__.end(), queue) == __msg_queue_holder__.end())
+        {
+            __msg_queue_holder__.push_back(queue);
+        }
+        __p_eventloop__ = loop;
+        __p_msg_queue__.store(queue.get(), std::memory_order_release);
+    }
+
+    inline sf_eventloop *sf_object::get_eventloop() const {
+        return __p_eventloop__;
+    }
+
     inline sf_object::~sf_object() {
-        __p_msg_queue__->remove_msg(this);
+        // NOTE move_to_thread之前投递的消息仍在原来的队列中执行，初始队列与移动过的队列都要移除
+        std::lock_guard<std::mutex> lck(__mu_msg_queue_holder__);
+        if (__handle__ != nullptr) {
+            std::lock_guard<std::mutex> handle_lck(__handle__->mu);
+            __handle__->object = nullptr;
+        }
+        auto current = __p_msg_queue__.load();
+        auto initial = sf_msg_queue::get_instance();
+        current->remove_msg(this);
+        if (initial != current) {
+            initial->remove_msg(this);
+        }
+        for (auto &p : __msg_queue_holder__) {
+            if (p.get() != current && p.get() != initial) {
+                p->remove_msg(this);
+            }
+        }
     }
 
     template<typename _VectorType>
@@ -78,11 +212,12 @@ namespace skyfire
     }
 
     template<typename _VectorType>
-    void sf_object::__sf_signal_unbind_helper(std::recursive_mutex &mu, _VectorType &vec, int bind_id) {
-        std::lock_guard<std::recursive_mutex> lck(mu);
-        vec.erase(std::remove_if(vec.begin(),vec.end(),[=](auto p){
-            return std::get<2>(p) == bind_id;
-        }), vec.end());
+    void sf_object::__sf_signal_unbind_helper(sf_rcu<_VectorType> &vec, int bind_id) {
+        vec.update([=](_VectorType &slots) {
+            slots.erase(std::remove_if(slots.begin(), slots.end(), [=](auto &p) {
+                return std::get<2>(p) == bind_id;
+            }), slots.end());
+        });
     }
 
 }
@@ -0,0 +1,126 @@
+/**
+* @version 1.0.0
+* @author skyfire
+* @mail skyfireitdiy@hotmail.com
+* @see http://github.com/skyfireitdiy/sflib
+* @file sf_pkg_compress.h
+
+* sflib第一版本发布
+* 版本号1.0.0
+* 发布日期：2018-10-22
+*/
+
+/*
+ * sf_pkg_compress 数据包压缩
+ * 压缩后的数据包在扩展标志中设置sf_pkg_ex_compressed，数据为8字节小端的原始长度加zlib压缩数据
+ * 协商：开启压缩的客户端连接后发送握手数据包（设置sf_pkg_ex_accept_compress），双方都开启压缩时服务端回复确认，
+ * 之后双方才发送压缩的数据包；其他数据包只在序列化方式不是native时带扩展标志，不支持扩展标志的旧版本对端不受影响
+ */
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <zlib.h>
+
+#include "sf_nocopy.h"
+#include "sf_tcp_utils.hpp"
+
+namespace skyfire
+{
+    /**
+     *  @brief 压缩选项
+     */
+    struct sf_pkg_compress_option_t
+    {
+        bool enable = false;                    // 是否启用压缩
+        size_t threshold = 1024;                // 数据长度不小于该值时才压缩
+        int level = Z_DEFAULT_COMPRESSION;      // 压缩级别（0-9）
+    };
+
+    /**
+     *  @brief 压缩统计
+     */
+    struct sf_pkg_compress_stat_t
+    {
+        unsigned long long compressed_frames = 0;      // 压缩发送的数据包数
+        unsigned long long skipped_frames = 0;         // 超过阈值但压缩后没有变小，按原样发送的数据包数
+        unsigned long long raw_bytes = 0;              // 压缩发送的数据包压缩前的字节数
+        unsigned long long compressed_bytes = 0;       // 压缩发送的数据包压缩后的字节数
+        unsigned long long compress_ns = 0;            // 压缩耗时（包括没有变小的数据包）
+        unsigned long long decompressed_frames = 0;    // 解压的数据包数
+        unsigned long long decompress_ns = 0;          // 解压耗时
+
+        /**
+         * 压缩比（压缩后字节数/压缩前字节数，没有压缩过数据时为1）
+         */
+        double ratio() const;
+
+        sf_pkg_compress_stat_t &operator+=(const sf_pkg_compress_stat_t &other);
+    };
+
+    /**
+     *  @brief 一个连接的压缩上下文，z_stream只初始化一次，每个数据包使用前重置（数据包之间互不依赖）
+     */
+    class sf_pkg_compressor : public sf_nocopy<>
+    {
+    private:
+        sf_pkg_compress_option_t option__;
+        z_stream deflate_stream__{};
+        z_stream inflate_stream__{};
+        bool deflate_ready__ = false;
+        bool inflate_ready__ = false;
+        byte_array buffer__;
+        sf_pkg_compress_stat_t stat__;
+        mutable std::mutex mu__;
+
+    public:
+        /**
+         * @param option 压缩选项
+         */
+        explicit sf_pkg_compressor(const sf_pkg_compress_option_t &option);
+
+        ~sf_pkg_compressor();
+
+        /**
+         * 压缩数据包（sf_make_pkg_frame生成），数据长度不小于阈值且压缩后变小时替换为压缩后的数据包
+         * @param frame 数据包
+         * @return 是否已压缩
+         */
+        bool compress_frame(byte_array &frame);
+
+        /**
+         * 解压数据
+         * @param data 压缩数据（不含扩展标志）
+         * @param size 长度
+         * @param out 解压后的数据
+         * @return 是否成功
+         */
+        bool decompress(const char *data, size_t size, byte_array &out);
+
+        /**
+         * 压缩选项
+         */
+        const sf_pkg_compress_option_t &option() const;
+
+        /**
+         * 压缩统计
+         */
+        sf_pkg_compress_stat_t stat() const;
+    };
+
+    /**
+     * 读取数据包的扩展标志，数据已压缩时解压
+     * @param header 包头
+     * @param data 数据
+     * @param ex_flags 扩展标志
+     * @param offset 实际数据在返回的缓冲区中的开始位置
+     * @param buffer 解压缓冲区
+     * @param compressor 压缩上下文（可以为空，为空时不能解压）
+     * @return 实际数据所在的缓冲区（data或buffer），无法解压时为nullptr
+     */
+    inline const byte_array *sf_take_pkg_body(const sf_pkg_header_t &header, const byte_array &data,
+                                              unsigned char &ex_flags, size_t &offset, byte_array &buffer,
+                                              sf_pkg_compressor *compressor);
+}
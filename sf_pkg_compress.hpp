@@ -0,0 +1,164 @@
+/**
+* @version 1.0.0
+* @author skyfire
+* @mail skyfireitdiy@hotmail.com
+* @see http://github.com/skyfireitdiy/sflib
+* @file sf_pkg_compress.hpp
+
+* sflib第一版本发布
+* 版本号1.0.0
+* 发布日期：2018-10-22
+*/
+
+/*
+ * sf_pkg_compress 数据包压缩
+ */
+
+#pragma once
+
+#include "sf_pkg_compress.h"
+
+#include <climits>
+
+namespace skyfire
+{
+    inline double sf_pkg_compress_stat_t::ratio() const {
+        return raw_bytes == 0 ? 1.0 : static_cast<double>(compressed_bytes) / static_cast<double>(raw_bytes);
+    }
+
+    inline sf_pkg_compress_stat_t &sf_pkg_compress_stat_t::operator+=(const sf_pkg_compress_stat_t &other) {
+        compressed_frames += other.compressed_frames;
+        skipped_frames += other.skipped_frames;
+        raw_bytes += other.raw_bytes;
+        compressed_bytes += other.compressed_bytes;
+        compress_ns += other.compress_ns;
+        decompressed_frames += other.decompressed_frames;
+        decompress_ns += other.decompress_ns;
+        return *this;
+    }
+
+    inline sf_pkg_compressor::sf_pkg_compressor(const sf_pkg_compress_option_t &option) : option__(option) {
+    }
+
+    inline sf_pkg_compressor::~sf_pkg_compressor() {
+        if (deflate_ready__) {
+            deflateEnd(&deflate_stream__);
+        }
+        if (inflate_ready__) {
+            inflateEnd(&inflate_stream__);
+        }
+    }
+
+    inline bool sf_pkg_compressor::compress_frame(byte_array &frame) {
+        sf_pkg_header_t header;
+        memcpy(&header, frame.data(), sizeof(header));
+        auto has_ex = (header.type & sf_pkg_ex_type_flag) != 0;
+        auto ex_flags = has_ex ? static_cast<unsigned char>(frame[sizeof(header)]) : static_cast<unsigned char>(0);
+        auto body_pos = sizeof(header) + (has_ex ? 1 : 0);
+        auto size = frame.size() - body_pos;
+        if (size < option__.threshold || size > UINT_MAX) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lck(mu__);
+        auto begin = std::chrono::steady_clock::now();
+        if (deflate_ready__) {
+            deflateReset(&deflate_stream__);
+        } else {
+            if (deflateInit(&deflate_stream__, option__.level) != Z_OK) {
+                return false;
+            }
+            deflate_ready__ = true;
+        }
+        auto raw_len = sf_little_endian(static_cast<unsigned long long>(size));
+        auto head = sizeof(header) + 1 + sizeof(raw_len);
+        buffer__.resize(head + deflateBound(&deflate_stream__, size));
+        deflate_stream__.next_in = reinterpret_cast<Bytef *>(frame.data() + body_pos);
+        deflate_stream__.avail_in = static_cast<uInt>(size);
+        deflate_stream__.next_out = reinterpret_cast<Bytef *>(buffer__.data() + head);
+        deflate_stream__.avail_out = static_cast<uInt>(buffer__.size() - head);
+        auto ret = deflate(&deflate_stream__, Z_FINISH);
+        auto out_size = head + deflate_stream__.total_out;
+        stat__.compress_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - begin).count();
+        if (ret != Z_STREAM_END || out_size >= frame.size()) {
+            ++stat__.skipped_frames;
+            return false;
+        }
+        buffer__.resize(out_size);
+        header.type |= sf_pkg_ex_type_flag;
+        header.length = out_size - sizeof(header);
+        make_header_checksum(header);
+        memcpy(buffer__.data(), &header, sizeof(header));
+        buffer__[sizeof(header)] = static_cast<char>(ex_flags | sf_pkg_ex_compressed);
+        memcpy(buffer__.data() + sizeof(header) + 1, &raw_len, sizeof(raw_len));
+        ++stat__.compressed_frames;
+        stat__.raw_bytes += frame.size();
+        stat__.compressed_bytes += out_size;
+        // NOTE 原数据包的内存留作下次压缩的缓冲区
+        frame.swap(buffer__);
+        return true;
+    }
+
+    inline bool sf_pkg_compressor::decompress(const char *data, size_t size, byte_array &out) {
+        unsigned long long raw_len;
+        if (size < sizeof(raw_len)) {
+            return false;
+        }
+        memcpy(&raw_len, data, sizeof(raw_len));
+        raw_len = sf_little_endian(raw_len);
+        data += sizeof(raw_len);
+        size -= sizeof(raw_len);
+        // NOTE deflate的压缩比不超过1032:1，超出说明数据错误，避免按错误的长度分配内存
+        if (raw_len > UINT_MAX || size > UINT_MAX || raw_len > size * 1032ULL + 64) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lck(mu__);
+        auto begin = std::chrono::steady_clock::now();
+        if (inflate_ready__) {
+            inflateReset(&inflate_stream__);
+        } else {
+            if (inflateInit(&inflate_stream__) != Z_OK) {
+                return false;
+            }
+            inflate_ready__ = true;
+        }
+        out.resize(raw_len);
+        Bytef empty;
+        inflate_stream__.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+        inflate_stream__.avail_in = static_cast<uInt>(size);
+        inflate_stream__.next_out = raw_len == 0 ? &empty : reinterpret_cast<Bytef *>(out.data());
+        inflate_stream__.avail_out = static_cast<uInt>(raw_len);
+        auto ret = inflate(&inflate_stream__, Z_FINISH);
+        if (ret != Z_STREAM_END || inflate_stream__.total_out != raw_len) {
+            return false;
+        }
+        ++stat__.decompressed_frames;
+        stat__.decompress_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - begin).count();
+        return true;
+    }
+
+    inline const sf_pkg_compress_option_t &sf_pkg_compressor::option() const {
+        return option__;
+    }
+
+    inline sf_pkg_compress_stat_t sf_pkg_compressor::stat() const {
+        std::lock_guard<std::mutex> lck(mu__);
+        return stat__;
+    }
+
+    inline const byte_array *sf_take_pkg_body(const sf_pkg_header_t &header, const byte_array &data,
+                                              unsigned char &ex_flags, size_t &offset, byte_array &buffer,
+                                              sf_pkg_compressor *compressor) {
+        offset = sf_take_pkg_ex_flags(header, data, ex_flags);
+        if ((ex_flags & sf_pkg_ex_compressed) == 0) {
+            return &data;
+        }
+        if (compressor == nullptr
+            || !compressor->decompress(data.data() + offset, data.size() - offset, buffer)) {
+            return nullptr;
+        }
+        offset = 0;
+        return &buffer;
+    }
+}
@@ -0,0 +1,92 @@
+
+/**
+* @version 1.0.0
+* @author skyfire
+* @mail skyfireitdiy@hotmail.com
+* @see http://github.com/skyfireitdiy/sflib
+* @file sf_rcu.h
+
+* sflib第一版本发布
+* 版本号1.0.0
+* 发布日期：2018-10-22
+*/
+
+/*
+ * sf_rcu 读-复制-更新容器
+ * 读取无锁（仅修改本线程所在分片的计数），更新时复制数据、原子替换，旧数据在没有读者时回收
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "sf_nocopy.h"
+
+namespace skyfire
+{
+    /**
+     *  @brief 读-复制-更新容器，适用于读多写少的数据（如信号的槽列表）
+     *  @tparam T 数据类型
+     */
+    template<typename T>
+    class sf_rcu : public sf_nocopy<>
+    {
+    private:
+        // 读者计数分片数量，不同线程尽量落在不同分片上，避免读者之间争用同一缓存行
+        static constexpr size_t reader_slot_count__ = 8;
+
+        struct alignas(64) sf_reader_slot_t__
+        {
+            std::atomic<size_t> count{0};
+        };
+
+        std::atomic<const T *> data__;
+        mutable sf_reader_slot_t__ readers__[reader_slot_count__];
+        std::mutex mu_update__;
+        std::vector<const T *> retired__;
+
+        static size_t reader_slot_index__();
+
+        bool has_reader__() const;
+
+    public:
+        /**
+         *  @brief 读取保护，存活期间数据快照不会被回收
+         */
+        class read_guard : public sf_nocopy<>
+        {
+        private:
+            std::atomic<size_t> &count__;
+            const T *data__;
+        public:
+            read_guard(std::atomic<size_t> &count, const std::atomic<const T *> &data);
+
+            ~read_guard();
+
+            const T &operator*() const;
+
+            const T *operator->() const;
+        };
+
+        sf_rcu();
+
+        ~sf_rcu();
+
+        /**
+         * 读取数据快照（可重入，读取期间允许在同一线程中更新）
+         * @return 读取保护
+         */
+        read_guard read() const;
+
+        /**
+         * 复制当前数据，修改后替换（多个更新者之间互斥）
+         * @tparam _Func 修改函数类型，形如 void(T&)
+         * @param func 修改函数
+         */
+        template<typename _Func>
+        void update(_Func func);
+    };
+}
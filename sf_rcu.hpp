@@ -0,0 +1,101 @@
+
+/**
+* @version 1.0.0
+* @author skyfire
+* @mail skyfireitdiy@hotmail.com
+* @see http://github.com/skyfireitdiy/sflib
+* @file sf_rcu.hpp
+
+* sflib第一版本发布
+* 版本号1.0.0
+* 发布日期：2018-10-22
+*/
+
+/*
+ * sf_rcu 读-复制-更新容器
+ * 读取无锁（仅修改本线程所在分片的计数），更新时复制数据、原子替换，旧数据在没有读者时回收
+ */
+
+#pragma once
+
+#include "sf_rcu.h"
+
+namespace skyfire
+{
+    template<typename T>
+    inline size_t sf_rcu<T>::reader_slot_index__() {
+        static std::atomic<size_t> next_index{0};
+        static thread_local size_t index = next_index++ % reader_slot_count__;
+        return index;
+    }
+
+    template<typename T>
+    inline bool sf_rcu<T>::has_reader__() const {
+        // NOTE 替换后扫描：替换前进入的读者在退出前其分片计数一直非0，替换后进入的读者只会读到新数据
+        for (auto &p : readers__)
+        {
+            if (p.count.load() != 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template<typename T>
+    inline sf_rcu<T>::read_guard::read_guard(std::atomic<size_t> &count, const std::atomic<const T *> &data)
+            : count__(count) {
+        count__.fetch_add(1);
+        data__ = data.load();
+    }
+
+    template<typename T>
+    inline sf_rcu<T>::read_guard::~read_guard() {
+        count__.fetch_sub(1, std::memory_order_release);
+    }
+
+    template<typename T>
+    inline const T &sf_rcu<T>::read_guard::operator*() const {
+        return *data__;
+    }
+
+    template<typename T>
+    inline const T *sf_rcu<T>::read_guard::operator->() const {
+        return data__;
+    }
+
+    template<typename T>
+    inline sf_rcu<T>::sf_rcu() : data__(new T()) {
+    }
+
+    template<typename T>
+    inline sf_rcu<T>::~sf_rcu() {
+        delete data__.load();
+        for (auto p : retired__)
+        {
+            delete p;
+        }
+    }
+
+    template<typename T>
+    inline typename sf_rcu<T>::read_guard sf_rcu<T>::read() const {
+        return read_guard(readers__[reader_slot_index__()].count, data__);
+    }
+
+    template<typename T>
+    template<typename _Func>
+    inline void sf_rcu<T>::update(_Func func) {
+        std::lock_guard<std::mutex> lck(mu_update__);
+        std::unique_ptr<T> new_data(new T(*data__.load()));
+        func(*new_data);
+        retired__.push_back(data__.exchange(new_data.release()));
+        if (!has_reader__())
+        {
+            for (auto p : retired__)
+            {
+                delete p;
+            }
+            retired__.clear();
+        }
+    }
+}
@@ -20,9 +20,11 @@
 #include "sf_tcp_client.hpp"
 #include "sf_nocopy.h"
 #include "sf_serialize_binary.hpp"
+#include "sf_pkg_compress.hpp"
 #include "sf_timer.hpp"
 #include "sf_tri_type.hpp"
 #include "sf_define.h"
+#include "sf_rpc_utils.h"
 #include <string>
 #include <functional>
 #include <tuple>
@@ -30,6 +32,7 @@
 #include <mutex>
 #include <condition_variable>
 #include <chrono>
+#include <unordered_map>
 
 
 namespace skyfire {
@@ -39,12 +42,16 @@ namespace skyfire {
      */
     struct sf_rpc_context_t {
         sf_pkg_header_t header;
-        byte_array data;
+        byte_array data;                // 返回值
         std::mutex back_mu;
         std::condition_variable back_cond;
         std::atomic<bool> back_finished;
+        sf_binary_profile profile;
+        sf_rpc_error_code error_code = sf_rpc_error_code::none;   // 服务端返回的错误
         bool is_async;
-        std::function<void(const byte_array &)> async_callback;
+        std::function<void(const byte_array &, sf_binary_profile)> async_callback;
+        std::string func_id;             // 按函数编号调用时的函数id
+        byte_array id_req;               // 按函数编号调用时的请求数据包，编号不存在后从中取出参数按函数id重新发送
     };
 
     /**
@@ -57,11 +64,41 @@ namespace skyfire {
 
         int current_call_id__ = 0;
         unsigned int rpc_timeout__ = 30000;
+        sf_binary_profile serialize_profile__ = sf_binary_profile::native;
+        std::shared_ptr<sf_pkg_compressor> compressor__;
+        std::atomic<bool> peer_accept_compress__{false};
+        // NOTE 连接后从服务端获取的函数表，签名一致的函数按编号调用，获取之前或签名不一致时按函数id调用
+        std::unordered_map<std::string, sf_rpc_method_t> method_table__;
+        mutable std::mutex method_mu__;
 
         int __make_call_id();
 
+        unsigned char __ex_flags() const;
+
+        void __request_compress();
+
+        void __request_method_table();
+
+        int __method_id_of(const std::string &func_id, unsigned long long signature) const;
+
+        template<typename _Param>
+        byte_array __make_req_pkg(int call_id, const std::string &func_id, const _Param &param,
+                                  int method_id = -1) const;
+
+        template<typename _Ret, typename _Param>
+        void __send_req(int call_id, const std::string &func_id, const _Param &param);
+
+        byte_array __make_name_req_pkg(const sf_rpc_context_t &context);
+
+        template<typename _Ret>
+        static bool __take_ret(const byte_array &data, sf_binary_profile profile, _Ret &ret);
+
         void __back_callback(const sf_pkg_header_t &header_t, const byte_array &data_t);
 
+        void __on_error(const sf_pkg_header_t &header_t, sf_binary_cursor &cursor, sf_binary_profile profile);
+
+        void __on_method_table(sf_binary_cursor &cursor);
+
         void __on_closed();
 
         sf_rpc_client();
@@ -80,7 +117,25 @@ namespace skyfire {
         void set_rpc_timeout(unsigned int ms);
 
         /**
-         * @brief connect 连接RPC服务端
+         * @brief set_serialize_profile 设置请求的序列化方式（服务端使用相同的方式返回，不同字节序或字长的主机之间使用portable）
+         * @param profile 序列化方式
+         */
+        void set_serialize_profile(sf_binary_profile profile);
+
+        /**
+         * @brief set_compress_option 设置压缩选项（需要在连接之前设置，连接时与服务端握手，服务端也开启压缩时，双方发送的大数据包都会被压缩）
+         * @param option 压缩选项
+         */
+        void set_compress_option(const sf_pkg_compress_option_t &option);
+
+        /**
+         * @brief compress_stat 压缩统计
+         * @return 统计数据
+         */
+        sf_pkg_compress_stat_t compress_stat() const;
+
+        /**
+         * @brief connect 连接RPC服务端（连接后获取服务端的函数表）
          * @param ip ip
          * @param port 端口
          * @return 是否连接成功
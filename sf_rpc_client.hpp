@@ -27,6 +27,75 @@ namespace skyfire {
         return current_call_id__;
     }
 
+    unsigned char sf_rpc_client::__ex_flags() const {
+        // NOTE 普通数据包只带序列化方式，native方式与旧版本的数据包相同
+        return static_cast<unsigned char>(serialize_profile__);
+    }
+
+    void sf_rpc_client::__request_compress() {
+        __tcp_client__->send(sf_make_pkg_frame(RPC_COMPRESS_REQ_TYPE, __ex_flags() | sf_pkg_ex_accept_compress, 0,
+                                               [](byte_array &) {}));
+    }
+
+    void sf_rpc_client::__request_method_table() {
+        __tcp_client__->send(sf_make_pkg_frame(RPC_TABLE_REQ_TYPE, __ex_flags(), 0, [](byte_array &) {}));
+    }
+
+    int sf_rpc_client::__method_id_of(const std::string &func_id, unsigned long long signature) const {
+        std::lock_guard<std::mutex> lck(method_mu__);
+        auto iter = method_table__.find(func_id);
+        if (iter == method_table__.end() || iter->second.signature != signature) {
+            return -1;
+        }
+        return iter->second.id;
+    }
+
+    template<typename _Param>
+    byte_array sf_rpc_client::__make_req_pkg(int call_id, const std::string &func_id, const _Param &param,
+                                             int method_id) const {
+        // NOTE 包头、请求与参数一次写入准确大小的缓冲区，数据与序列化sf_rpc_req_context_t（按编号时为sf_rpc_req_id_view_t）相同
+        auto by_id = method_id >= 0;
+        auto length = sf_serialized_size(call_id) + (by_id ? sf_serialized_size(method_id) : sf_serialized_size(func_id))
+                      + sizeof(size_t) + sf_serialized_size(param);
+        auto frame = sf_make_pkg_frame(by_id ? RPC_REQ_ID_TYPE : RPC_REQ_TYPE, __ex_flags(), length,
+                                       [&](byte_array &buffer) {
+                                           sf_binary_writer writer(buffer, serialize_profile__);
+                                           sf_serialize_binary_to(writer, call_id);
+                                           if (by_id) {
+                                               sf_serialize_binary_to(writer, method_id);
+                                           } else {
+                                               sf_serialize_binary_to(writer, func_id);
+                                           }
+                                           auto pos = writer.begin_block();
+                                           sf_serialize_binary_to(writer, param);
+                                           writer.end_block(pos);
+                                       });
+        if (compressor__ && peer_accept_compress__) {
+            compressor__->compress_frame(frame);
+        }
+        return frame;
+    }
+
+    template<typename _Ret, typename _Param>
+    void sf_rpc_client::__send_req(int call_id, const std::string &func_id, const _Param &param) {
+        auto method_id = __method_id_of(func_id, sf_rpc_signature<_Ret, _Param>(func_id));
+        if (method_id < 0) {
+            __tcp_client__->send(__make_req_pkg(call_id, func_id, param));
+            return;
+        }
+        // NOTE 保存已生成的数据包，编号不存在时从中取出参数重新生成按函数id的请求（不复制参数）
+        auto context = __rpc_data__[call_id];
+        context->func_id = func_id;
+        context->id_req = __make_req_pkg(call_id, func_id, param, method_id);
+        __tcp_client__->send(context->id_req);
+    }
+
+    template<typename _Ret>
+    bool sf_rpc_client::__take_ret(const byte_array &data, sf_binary_profile profile, _Ret &ret) {
+        sf_binary_cursor cursor(data, 0, profile);
+        return sf_try_deserialize_binary_from(cursor, ret);
+    }
+
     template<typename _Ret, typename... __SF_RPC_ARGS__>
     void sf_rpc_client::async_call(const std::string &func_id, std::function<void(_Ret)> rpc_callback,
                                               __SF_RPC_ARGS__... args) {
@@ -40,18 +109,14 @@ namespace skyfire {
         int call_id = __make_call_id();
         __rpc_data__[call_id] = std::make_shared<sf_rpc_context_t>();
         __rpc_data__[call_id]->is_async = true;
-        __rpc_data__[call_id]->async_callback = [=](const byte_array &data) {
+        __rpc_data__[call_id]->async_callback = [=](const byte_array &data, sf_binary_profile profile) {
             __Ret ret;
-            sf_rpc_res_context_t res;
-            sf_deserialize_binary(data, res, 0);
-            sf_deserialize_binary(res.ret, ret, 0);
-            rpc_callback(ret);
+            // NOTE 返回值无法解析时与调用出错相同，不调用回调
+            if (__take_ret(data, profile, ret)) {
+                rpc_callback(ret);
+            }
         };
-        sf_rpc_req_context_t req;
-        req.call_id = call_id;
-        req.func_id = func_id;
-        req.params = sf_serialize_binary(param);
-        __tcp_client__->send(RPC_REQ_TYPE, sf_serialize_binary(req));
+        __send_req<__Ret>(call_id, func_id, param);
         auto ptimer = std::make_shared<sf_timer>();
         sf_bind_signal(ptimer, timeout, [=]() {
             __rpc_data__.erase(call_id);
@@ -68,14 +133,10 @@ namespace skyfire {
         int call_id = __make_call_id();
         __rpc_data__[call_id] = std::make_shared<sf_rpc_context_t>();
         __rpc_data__[call_id]->is_async = true;
-        __rpc_data__[call_id]->async_callback = [=](const byte_array &data) {
+        __rpc_data__[call_id]->async_callback = [=](const byte_array &, sf_binary_profile) {
             rpc_callback();
         };
-        sf_rpc_req_context_t req;
-        req.call_id = call_id;
-        req.func_id = func_id;
-        req.params =sf_serialize_binary(param);
-        __tcp_client__->send(RPC_REQ_TYPE, sf_serialize_binary(req));
+        __send_req<void>(call_id, func_id, param);
         auto ptimer = std::make_shared<sf_timer>();
         sf_bind_signal(ptimer, timeout, [=]() {
             __rpc_data__.erase(call_id);
@@ -88,14 +149,10 @@ namespace skyfire {
         int call_id = __make_call_id();
         __rpc_data__[call_id] = std::make_shared<sf_rpc_context_t>();
         __rpc_data__[call_id]->is_async = true;
-        __rpc_data__[call_id]->async_callback = [=](const byte_array &data) {
+        __rpc_data__[call_id]->async_callback = [=](const byte_array &, sf_binary_profile) {
             rpc_callback();
         };
-        sf_rpc_req_context_t req;
-        req.call_id = call_id;
-        req.func_id = func_id;
-        req.params =sf_serialize_binary(byte_array());
-        __tcp_client__->send(RPC_REQ_TYPE, sf_serialize_binary(req));
+        __tcp_client__->send(__make_req_pkg(call_id, func_id, byte_array()));
     }
 
     template<typename _Ret, typename... __SF_RPC_ARGS__>
@@ -112,40 +169,36 @@ namespace skyfire {
         __rpc_data__[call_id] = std::make_shared<sf_rpc_context_t>();
         __rpc_data__[call_id]->is_async = false;
 
-        sf_rpc_req_context_t req;
-        req.call_id = call_id;
-        req.func_id = func_id;
-        req.params =sf_serialize_binary(param);
-        __tcp_client__->send(RPC_REQ_TYPE, sf_serialize_binary(req));
-        std::cout<<"1"<<std::endl;
-        if (!__rpc_data__[call_id]->back_finished) {
-            std::cout<<"2"<<std::endl;
+        __send_req<__Ret>(call_id, func_id, param);
+        {
+            // NOTE 在锁内检查是否已返回，响应先于等待到达时不会丢失通知
             std::unique_lock<std::mutex> lck(__rpc_data__[call_id]->back_mu);
-            std::cout<<"3"<<std::endl;
-            if (__rpc_data__[call_id]->back_cond.wait_for(lck, std::chrono::milliseconds(rpc_timeout__)) ==
+            if (!__rpc_data__[call_id]->back_finished &&
+                __rpc_data__[call_id]->back_cond.wait_for(lck, std::chrono::milliseconds(rpc_timeout__)) ==
                 std::cv_status::timeout) {
-                std::cout<<"4"<<std::endl;
+                lck.unlock();
                 __rpc_data__.erase(call_id);
-                std::cout<<"5"<<std::endl;
                 return sf_tri_type<__Ret>();
             }
-            std::cout<<"6"<<std::endl;
         }
         // 连接断开
         if (!__rpc_data__[call_id]->back_finished) {
             return sf_tri_type<__Ret>();
         }
+        // 服务端返回错误（如函数不存在）
+        if (__rpc_data__[call_id]->error_code != sf_rpc_error_code::none) {
+            __rpc_data__.erase(call_id);
+            return sf_tri_type<__Ret>();
+        }
         if constexpr (std::is_same<_Ret, void>::value) {
-                std::cout<<"ok"<<std::endl;
             __rpc_data__.erase(call_id);
             return sf_tri_type<void>(true);
         } else {
             sf_tri_type<__Ret> ret;
             __Ret tmp_ret;
-            sf_rpc_res_context_t res;
-            sf_deserialize_binary(__rpc_data__[call_id]->data, res, 0);
-            sf_deserialize_binary(res.ret, tmp_ret, 0);
-            ret = tmp_ret;
+            if (__take_ret(__rpc_data__[call_id]->data, __rpc_data__[call_id]->profile, tmp_ret)) {
+                ret = tmp_ret;
+            }
             __rpc_data__.erase(call_id);
             return ret;
         }
@@ -155,6 +208,18 @@ namespace skyfire {
         rpc_timeout__ = ms;
     }
 
+    void sf_rpc_client::set_serialize_profile(sf_binary_profile profile) {
+        serialize_profile__ = profile;
+    }
+
+    void sf_rpc_client::set_compress_option(const sf_pkg_compress_option_t &option) {
+        compressor__ = option.enable ? std::make_shared<sf_pkg_compressor>(option) : nullptr;
+    }
+
+    sf_pkg_compress_stat_t sf_rpc_client::compress_stat() const {
+        return compressor__ ? compressor__->stat() : sf_pkg_compress_stat_t();
+    }
+
     sf_rpc_client::sf_rpc_client() {
         sf_bind_signal(__tcp_client__,
                        data_coming,
@@ -175,11 +240,23 @@ namespace skyfire {
 
     void sf_rpc_client::close() {
         __tcp_client__->close();
+        peer_accept_compress__ = false;
+        std::lock_guard<std::mutex> lck(method_mu__);
+        method_table__.clear();
     }
 
 
     bool sf_rpc_client::connect_to_server(const std::string ip, unsigned short port) {
-        return __tcp_client__->connect_to_server(ip, port);
+        if (!__tcp_client__->connect_to_server(ip, port)) {
+            return false;
+        }
+        // NOTE 不等待函数表返回，返回之前的调用按函数id发送（不支持函数表的服务端不返回，始终按函数id调用）
+        __request_method_table();
+        // NOTE 开启压缩时发送握手数据包，收到确认之前（不支持压缩的服务端不确认）发送的数据包都不压缩
+        if (compressor__) {
+            __request_compress();
+        }
+        return true;
     }
 
     std::shared_ptr<sf_rpc_client> sf_rpc_client::make_client() {
@@ -188,21 +265,142 @@ namespace skyfire {
 
     
     void sf_rpc_client::__back_callback(const sf_pkg_header_t &header_t, const byte_array &data_t) {
-        if(header_t.type != RPC_RES_TYPE)
+        auto type = sf_pkg_base_type(header_t.type);
+        if(type != RPC_RES_TYPE && type != RPC_ERR_TYPE && type != RPC_TABLE_RES_TYPE
+           && type != RPC_COMPRESS_ACK_TYPE)
         {
             return;
         }
+        unsigned char ex_flags;
+        size_t offset;
+        byte_array buffer;
+        auto body = sf_take_pkg_body(header_t, data_t, ex_flags, offset, buffer, compressor__.get());
+        if (body == nullptr || !sf_is_binary_profile_supported(ex_flags & sf_pkg_ex_profile_mask)) {
+            return;
+        }
+        // NOTE 服务端确认了压缩握手，之后的请求超过阈值时压缩
+        if (type == RPC_COMPRESS_ACK_TYPE) {
+            peer_accept_compress__ = compressor__ != nullptr && (ex_flags & sf_pkg_ex_accept_compress);
+            return;
+        }
+        auto profile = static_cast<sf_binary_profile>(ex_flags & sf_pkg_ex_profile_mask);
+        sf_binary_cursor cursor(*body, offset, profile);
+        if (type == RPC_ERR_TYPE) {
+            __on_error(header_t, cursor, profile);
+            return;
+        }
+        if (type == RPC_TABLE_RES_TYPE) {
+            __on_method_table(cursor);
+            return;
+        }
+        // NOTE 响应来自网络，解析失败时丢弃（调用方等待超时），不能在IO线程中抛出异常
         sf_rpc_res_context_t res;
-        sf_deserialize_binary(data_t, res, 0);
-        int call_id = res.call_id;
-        if (__rpc_data__[call_id]->is_async) {
-            __rpc_data__[call_id]->async_callback(data_t);
-            __rpc_data__.erase(call_id);
+        if (!sf_try_deserialize_binary_from(cursor, res)) {
+            return;
+        }
+        // NOTE 超时后到达的响应对应的调用已移除，忽略
+        auto iter = __rpc_data__.find(res.call_id);
+        if (iter == __rpc_data__.end()) {
+            return;
+        }
+        auto context = iter->second;
+        if (context->is_async) {
+            context->async_callback(res.ret, profile);
+            __rpc_data__.erase(res.call_id);
         } else {
-            __rpc_data__[call_id]->header = header_t;
-            __rpc_data__[call_id]->data = data_t;
-            __rpc_data__[call_id]->back_finished = true;
-            __rpc_data__[call_id]->back_cond.notify_one();
+            context->header = header_t;
+            context->data = std::move(res.ret);
+            context->profile = profile;
+            {
+                std::lock_guard<std::mutex> lck(context->back_mu);
+                context->back_finished = true;
+            }
+            context->back_cond.notify_one();
+        }
+    }
+
+    void sf_rpc_client::__on_error(const sf_pkg_header_t &header_t, sf_binary_cursor &cursor,
+                                   sf_binary_profile profile) {
+        sf_rpc_err_context_t err;
+        if (!sf_try_deserialize_binary_from(cursor, err)) {
+            return;
+        }
+        auto iter = __rpc_data__.find(err.call_id);
+        if (iter == __rpc_data__.end()) {
+            return;
+        }
+        // NOTE 函数表已过期，重新获取，本次调用按函数id重新发送
+        if (err.code == sf_rpc_error_code::method_id_mismatch && !iter->second->id_req.empty()) {
+            {
+                std::lock_guard<std::mutex> lck(method_mu__);
+                method_table__.clear();
+            }
+            __request_method_table();
+            auto frame = __make_name_req_pkg(*iter->second);
+            iter->second->id_req = byte_array();
+            if (!frame.empty()) {
+                __tcp_client__->send(frame);
+                return;
+            }
+        }
+        // NOTE 异步调用出错时不调用回调
+        if (iter->second->is_async) {
+            __rpc_data__.erase(iter);
+            return;
+        }
+        iter->second->header = header_t;
+        iter->second->profile = profile;
+        iter->second->error_code = err.code;
+        {
+            std::lock_guard<std::mutex> lck(iter->second->back_mu);
+            iter->second->back_finished = true;
+        }
+        iter->second->back_cond.notify_one();
+    }
+
+    byte_array sf_rpc_client::__make_name_req_pkg(const sf_rpc_context_t &context) {
+        sf_pkg_header_t header;
+        memcpy(&header, context.id_req.data(), sizeof(header));
+        byte_array data(context.id_req.begin() + sizeof(header), context.id_req.end());
+        unsigned char ex_flags;
+        size_t offset;
+        byte_array buffer;
+        auto body = sf_take_pkg_body(header, data, ex_flags, offset, buffer, compressor__.get());
+        if (body == nullptr) {
+            return byte_array();
+        }
+        // NOTE 参数块原样写入（与序列化sf_byte_view相同），使用原请求的序列化方式
+        auto profile = static_cast<sf_binary_profile>(ex_flags & sf_pkg_ex_profile_mask);
+        sf_binary_cursor cursor(*body, offset, profile);
+        sf_rpc_req_id_view_t req;
+        if (!sf_try_deserialize_binary_from(cursor, req)) {
+            return byte_array();
+        }
+        auto length = sf_serialized_size(req.call_id) + sf_serialized_size(context.func_id)
+                      + sf_serialized_size(req.params);
+        auto frame = sf_make_pkg_frame(RPC_REQ_TYPE, static_cast<unsigned char>(profile), length,
+                                       [&](byte_array &out) {
+                                           sf_binary_writer writer(out, profile);
+                                           sf_serialize_binary_to(writer, req.call_id);
+                                           sf_serialize_binary_to(writer, context.func_id);
+                                           sf_serialize_binary_to(writer, req.params);
+                                       });
+        if (compressor__ && peer_accept_compress__) {
+            compressor__->compress_frame(frame);
+        }
+        return frame;
+    }
+
+    void sf_rpc_client::__on_method_table(sf_binary_cursor &cursor) {
+        std::vector<sf_rpc_method_t> table;
+        if (!sf_try_deserialize_binary_from(cursor, table)) {
+            return;
+        }
+        std::lock_guard<std::mutex> lck(method_mu__);
+        method_table__.clear();
+        for (auto &p : table) {
+            auto name = p.name;
+            method_table__.emplace(std::move(name), std::move(p));
         }
     }
 
@@ -20,12 +20,17 @@
 #include "sf_tcp_server.hpp"
 #include "sf_nocopy.h"
 #include "sf_serialize_binary.hpp"
+#include "sf_pkg_compress.hpp"
 #include "sf_meta.hpp"
 #include "sf_rpc_utils.h"
 #include <string>
 #include <functional>
 #include <tuple>
 #include <memory>
+#include <mutex>
+#include <deque>
+#include <string_view>
+#include <unordered_map>
 
 namespace skyfire {
 
@@ -46,19 +51,55 @@ namespace skyfire {
 
         std::shared_ptr<sf_tcp_server> __tcp_server__ = sf_tcp_server::make_server();
 
-        std::vector<std::function<void(SOCKET, const sf_rpc_req_context_t &)>> __func__vec__;
+        using __rpc_func_t = std::function<void(SOCKET, const byte_array &, const sf_rpc_req_view_t &,
+                                                sf_binary_profile)>;
+
+        struct __rpc_method_entry_t {
+            sf_rpc_method_t method;
+            __rpc_func_t func;
+        };
+
+        // NOTE 下标为函数编号，deque追加元素时已有元素的地址不变
+        std::deque<__rpc_method_entry_t> __method_table__;
+        // NOTE 按函数id查找编号，键指向__method_table__中的函数id（请求中的函数id是视图，查找时不复制）
+        std::unordered_map<std::string_view, int> __func_map__;
+
+        sf_pkg_compress_option_t __compress_option__;
+        // NOTE 开启了压缩的客户端的压缩上下文，由客户端的压缩握手确定
+        std::map<SOCKET, std::shared_ptr<sf_pkg_compressor>> __compressor_map__;
+        sf_pkg_compress_stat_t __closed_compress_stat__;
+        mutable std::mutex __compress_mu__;
 
         template<typename _Type>
-        void __send_back(SOCKET sock, int id_code, _Type data);
+        void __send_back(SOCKET sock, int id_code, _Type data, sf_binary_profile profile);
 
+        template<typename _Type>
+        void __send_pkg(SOCKET sock, int type, const _Type &data, sf_binary_profile profile);
 
-        void __on_data_coming(SOCKET sock, const sf_pkg_header_t &header, const byte_array &data);
+        void __send_error(SOCKET sock, int id_code, sf_rpc_error_code code, const std::string &message,
+                          sf_binary_profile profile);
+
+        void __send_method_table(SOCKET sock, sf_binary_profile profile);
+
+        void __add_func(const std::string &id, unsigned long long signature, __rpc_func_t func);
+
+        std::shared_ptr<sf_pkg_compressor> __compressor_of(SOCKET sock, bool create);
+
+        void __on_closed(SOCKET sock);
 
         sf_rpc_server();
     public:
 
         /**
-         * @brief reg_rpc_func 注册远程调用函数
+         * @brief __on_data_coming 处理一个数据包（由tcp服务器的data_coming信号调用，基准测试中直接调用），返回写入sock
+         * @param sock 连接
+         * @param header 包头
+         * @param data 数据
+         */
+        void __on_data_coming(SOCKET sock, const sf_pkg_header_t &header, const byte_array &data);
+
+        /**
+         * @brief reg_rpc_func 注册远程调用函数（需要在listen之前注册，函数编号为注册顺序，重复注册同一个标识时替换之前的函数，编号不变）
          * @param id 标识
          * @param func 函数
          */
@@ -81,6 +122,18 @@ namespace skyfire {
          */
         bool listen(const std::string &ip, unsigned short port);
 
+        /**
+         * @brief set_compress_option 设置压缩选项（只对开启了压缩的客户端压缩，需要在listen之前设置）
+         * @param option 压缩选项
+         */
+        void set_compress_option(const sf_pkg_compress_option_t &option);
+
+        /**
+         * @brief compress_stat 压缩统计（所有连接之和，包括已断开的连接）
+         * @return 统计数据
+         */
+        sf_pkg_compress_stat_t compress_stat() const;
+
         /**
          * @brief close 关闭RPC服务器
          */
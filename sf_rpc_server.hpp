@@ -24,26 +24,147 @@ namespace skyfire {
 
     
     template<typename _Type>
-    void sf_rpc_server::__send_back(SOCKET sock, int id_code, _Type data) {
-        sf_rpc_res_context_t res;
-        res.call_id = id_code;
-        res.ret = sf_serialize_binary(data);
-        __tcp_server__->send(sock, RPC_RES_TYPE, sf_serialize_binary(res));
+    void sf_rpc_server::__send_back(SOCKET sock, int id_code, _Type data, sf_binary_profile profile) {
+        // NOTE 包头、响应与返回值一次写入准确大小的缓冲区，数据与序列化sf_rpc_res_context_t相同
+        auto length = sf_serialized_size(id_code) + sizeof(size_t) + sf_serialized_size(data);
+        // NOTE 只在客户端使用了扩展标志时（非native方式）带扩展标志，旧版本客户端收到的数据包不变
+        auto ex_flags = static_cast<unsigned char>(profile);
+        auto frame = sf_make_pkg_frame(RPC_RES_TYPE, ex_flags, length, [&](byte_array &buffer) {
+            sf_binary_writer writer(buffer, profile);
+            sf_serialize_binary_to(writer, id_code);
+            auto pos = writer.begin_block();
+            sf_serialize_binary_to(writer, data);
+            writer.end_block(pos);
+        });
+        if (auto compressor = __compressor_of(sock, false)) {
+            compressor->compress_frame(frame);
+        }
+        __tcp_server__->send(sock, frame);
+    }
+
+    template<typename _Type>
+    void sf_rpc_server::__send_pkg(SOCKET sock, int type, const _Type &data, sf_binary_profile profile) {
+        // NOTE 只在客户端使用了扩展标志时（非native方式）带扩展标志，旧版本客户端收到的数据包不变
+        auto ex_flags = static_cast<unsigned char>(profile);
+        auto frame = sf_make_pkg_frame(type, ex_flags, sf_serialized_size(data), [&](byte_array &buffer) {
+            sf_binary_writer writer(buffer, profile);
+            sf_serialize_binary_to(writer, data);
+        });
+        if (auto compressor = __compressor_of(sock, false)) {
+            compressor->compress_frame(frame);
+        }
+        __tcp_server__->send(sock, frame);
+    }
+
+    void sf_rpc_server::__send_error(SOCKET sock, int id_code, sf_rpc_error_code code, const std::string &message,
+                                     sf_binary_profile profile) {
+        __send_pkg(sock, RPC_ERR_TYPE, sf_rpc_err_context_t{id_code, code, message}, profile);
+    }
+
+    void sf_rpc_server::__send_method_table(SOCKET sock, sf_binary_profile profile) {
+        std::vector<sf_rpc_method_t> table;
+        table.reserve(__method_table__.size());
+        for (auto &p : __method_table__) {
+            table.push_back(p.method);
+        }
+        __send_pkg(sock, RPC_TABLE_RES_TYPE, table, profile);
+    }
+
+    void sf_rpc_server::__add_func(const std::string &id, unsigned long long signature, __rpc_func_t func) {
+        // NOTE 重复注册时保留原来的编号，已获取函数表的客户端仍然可以按编号调用
+        auto iter = __func_map__.find(id);
+        if (iter != __func_map__.end()) {
+            auto &entry = __method_table__[iter->second];
+            entry.method.signature = signature;
+            entry.func = std::move(func);
+            return;
+        }
+        auto method_id = static_cast<int>(__method_table__.size());
+        __method_table__.push_back(__rpc_method_entry_t{sf_rpc_method_t{id, method_id, signature}, std::move(func)});
+        __func_map__.emplace(__method_table__.back().method.name, method_id);
+    }
+
+    std::shared_ptr<sf_pkg_compressor> sf_rpc_server::__compressor_of(SOCKET sock, bool create) {
+        std::lock_guard<std::mutex> lck(__compress_mu__);
+        auto iter = __compressor_map__.find(sock);
+        if (iter != __compressor_map__.end()) {
+            return iter->second;
+        }
+        if (!create) {
+            return nullptr;
+        }
+        return __compressor_map__[sock] = std::make_shared<sf_pkg_compressor>(__compress_option__);
+    }
+
+    void sf_rpc_server::__on_closed(SOCKET sock) {
+        std::lock_guard<std::mutex> lck(__compress_mu__);
+        auto iter = __compressor_map__.find(sock);
+        if (iter != __compressor_map__.end()) {
+            __closed_compress_stat__ += iter->second->stat();
+            __compressor_map__.erase(iter);
+        }
     }
 
     
     void sf_rpc_server::__on_data_coming(SOCKET sock, const sf_pkg_header_t &header, const byte_array &data) {
-        if(header.type != RPC_REQ_TYPE)
+        auto type = sf_pkg_base_type(header.type);
+        if(type != RPC_REQ_TYPE && type != RPC_REQ_ID_TYPE && type != RPC_TABLE_REQ_TYPE
+           && type != RPC_COMPRESS_REQ_TYPE)
         {
             return;
         }
-        std::string id;
-        byte_array param;
-        sf_rpc_req_context_t req;
-        sf_deserialize_binary(data, req, 0);
-        for (auto &p : __func__vec__) {
-            p(sock, req);
+        // NOTE 按请求的序列化方式解析与返回
+        unsigned char ex_flags;
+        sf_take_pkg_ex_flags(header, data, ex_flags);
+        // NOTE 双方都开启压缩时（握手数据包中设置了sf_pkg_ex_accept_compress）才创建压缩上下文，之后的返回超过阈值时压缩
+        auto compressor = __compressor_of(sock, __compress_option__.enable && (ex_flags & sf_pkg_ex_accept_compress));
+        if (type == RPC_COMPRESS_REQ_TYPE) {
+            if (compressor) {
+                __tcp_server__->send(sock, sf_make_pkg_frame(RPC_COMPRESS_ACK_TYPE, sf_pkg_ex_accept_compress, 0,
+                                                             [](byte_array &) {}));
+            }
+            return;
+        }
+        size_t offset;
+        byte_array buffer;
+        auto body = sf_take_pkg_body(header, data, ex_flags, offset, buffer, compressor.get());
+        // NOTE 客户端选择的方式即协商结果：支持的方式原样返回，不支持的方式无法解析，丢弃请求
+        if (body == nullptr || !sf_is_binary_profile_supported(ex_flags & sf_pkg_ex_profile_mask)) {
+            return;
+        }
+        auto profile = static_cast<sf_binary_profile>(ex_flags & sf_pkg_ex_profile_mask);
+        if (type == RPC_TABLE_REQ_TYPE) {
+            __send_method_table(sock, profile);
+            return;
+        }
+        // NOTE 使用视图解析，函数id与参数不复制，由匹配的函数直接从数据中反序列化参数
+        // NOTE 请求来自网络，解析失败（数据不完整或格式错误）时丢弃，不能在IO线程中抛出异常
+        sf_binary_cursor cursor(*body, offset, profile);
+        if (type == RPC_REQ_ID_TYPE) {
+            sf_rpc_req_id_view_t req;
+            if (!sf_try_deserialize_binary_from(cursor, req)) {
+                return;
+            }
+            if (req.method_id < 0 || static_cast<size_t>(req.method_id) >= __method_table__.size()) {
+                __send_error(sock, req.call_id, sf_rpc_error_code::method_id_mismatch,
+                             "method id not found: " + std::to_string(req.method_id), profile);
+                return;
+            }
+            auto &entry = __method_table__[req.method_id];
+            entry.func(sock, *body, sf_rpc_req_view_t{req.call_id, entry.method.name, req.params}, profile);
+            return;
+        }
+        sf_rpc_req_view_t req;
+        if (!sf_try_deserialize_binary_from(cursor, req)) {
+            return;
+        }
+        auto iter = __func_map__.find(req.func_id);
+        if (iter == __func_map__.end()) {
+            __send_error(sock, req.call_id, sf_rpc_error_code::method_not_found,
+                         "method not found: " + std::string(req.func_id), profile);
+            return;
         }
+        __method_table__[iter->second].func(sock, *body, req, profile);
     }
 
     
@@ -59,15 +180,18 @@ namespace skyfire {
             using _Ret = typename sf_function_type_helper<_Func>::return_type;
             using _Param = typename sf_function_type_helper<_Func>::param_type;
 
-            auto f = [=](SOCKET s, const sf_rpc_req_context_t& req) {
-                if (req.func_id == id) {
-                    _Param param;
-                    sf_deserialize_binary(req.params, param, 0);
-                    _Ret ret = sf_invoke(func, param);
-                    __send_back(s, req.call_id, ret);
+            auto f = [=](SOCKET s, const byte_array &data, const sf_rpc_req_view_t &req, sf_binary_profile profile) {
+                _Param param;
+                sf_binary_cursor cursor(data, req.params.data() - data.data(), profile);
+                if (!sf_try_deserialize_binary_from(cursor, param)) {
+                    __send_error(s, req.call_id, sf_rpc_error_code::bad_params,
+                                 "bad params: " + std::string(req.func_id), profile);
+                    return;
                 }
+                _Ret ret = sf_invoke(func, param);
+                __send_back(s, req.call_id, ret, profile);
             };
-            __func__vec__.push_back(f);
+            __add_func(id, sf_rpc_signature<_Ret, _Param>(id), f);
 
         } else {
             static_assert(!sf_check_param_reference<decltype(std::function(func))>::value,
@@ -82,20 +206,23 @@ namespace skyfire {
             using _Ret = typename sf_function_type_helper<decltype(std::function(func))>::return_type;
             using _Param = typename sf_function_type_helper<decltype(std::function(func))>::param_type;
 
-            auto f = [=](SOCKET s, const sf_rpc_req_context_t& req ) {
-                if (req.func_id == id) {
-                    _Param param;
-                    sf_deserialize_binary(req.params, param, 0);
-                    if constexpr (std::is_same<_Ret, void>::value) {
-                        sf_invoke(func, param);
-                        __send_back(s, req.call_id, '\0');
-                    } else {
-                        _Ret ret = sf_invoke(func, param);
-                        __send_back(s, req.call_id, ret);
-                    }
+            auto f = [=](SOCKET s, const byte_array &data, const sf_rpc_req_view_t &req, sf_binary_profile profile) {
+                _Param param;
+                sf_binary_cursor cursor(data, req.params.data() - data.data(), profile);
+                if (!sf_try_deserialize_binary_from(cursor, param)) {
+                    __send_error(s, req.call_id, sf_rpc_error_code::bad_params,
+                                 "bad params: " + std::string(req.func_id), profile);
+                    return;
+                }
+                if constexpr (std::is_same<_Ret, void>::value) {
+                    sf_invoke(func, param);
+                    __send_back(s, req.call_id, '\0', profile);
+                } else {
+                    _Ret ret = sf_invoke(func, param);
+                    __send_back(s, req.call_id, ret, profile);
                 }
             };
-            __func__vec__.push_back(f);
+            __add_func(id, sf_rpc_signature<_Ret, _Param>(id), f);
         }
 
     }
@@ -117,6 +244,7 @@ namespace skyfire {
             client_connected(sock);
         },true);
         sf_bind_signal(sf_rpc_server::__tcp_server__,closed,[=](SOCKET sock){
+            __on_closed(sock);
             client_disconnected(sock);
         },true);
     }
@@ -130,4 +258,17 @@ namespace skyfire {
     void sf_rpc_server::close() {
         __tcp_server__->close();
     }
+
+    void sf_rpc_server::set_compress_option(const sf_pkg_compress_option_t &option) {
+        __compress_option__ = option;
+    }
+
+    sf_pkg_compress_stat_t sf_rpc_server::compress_stat() const {
+        std::lock_guard<std::mutex> lck(__compress_mu__);
+        auto ret = __closed_compress_stat__;
+        for (auto &p : __compressor_map__) {
+            ret += p.second->stat();
+        }
+        return ret;
+    }
 }
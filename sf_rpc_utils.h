@@ -16,6 +16,8 @@
 #include "sf_serialize_binary.hpp"
 #include "sf_type.h"
 #include <string>
+#include <string_view>
+#include <typeinfo>
 
 namespace skyfire
 {
@@ -31,6 +33,18 @@ namespace skyfire
 
     SF_MAKE_SERIALIZABLE_BINARY(sf_rpc_req_context_t, call_id, func_id, params)
 
+    /**
+     *  @brief rpc请求上下文视图（与sf_rpc_req_context_t序列化结果相同，反序列化时不复制函数id与参数）
+     */
+    struct sf_rpc_req_view_t
+    {
+        int call_id;                    // 调用id
+        std::string_view func_id;       // 函数id（指向接收缓冲区）
+        sf_byte_view params;            // 参数（指向接收缓冲区）
+    };
+
+    SF_MAKE_SERIALIZABLE_BINARY(sf_rpc_req_view_t, call_id, func_id, params)
+
     /**
      *  @brief rpc响应上下文
      */
@@ -41,4 +55,71 @@ namespace skyfire
     };
 
     SF_MAKE_SERIALIZABLE_BINARY(sf_rpc_res_context_t, call_id, ret)
+
+    /**
+     *  @brief rpc错误码
+     */
+    enum class sf_rpc_error_code : int
+    {
+        none = 0,                       // 没有错误
+        method_not_found = 1,           // 函数id没有注册
+        method_id_mismatch = 2,         // 函数编号不存在（客户端的函数表已过期）
+        bad_params = 3                  // 参数无法解析（数据不完整或格式错误）
+    };
+
+    /**
+     *  @brief rpc错误响应上下文
+     */
+    struct sf_rpc_err_context_t
+    {
+        int call_id;                    // 调用id
+        sf_rpc_error_code code;         // 错误码
+        std::string message;            // 错误信息
+    };
+
+    SF_MAKE_SERIALIZABLE_BINARY(sf_rpc_err_context_t, call_id, code, message)
+
+    /**
+     *  @brief rpc函数表项（连接后客户端获取服务端的函数表，之后按编号调用）
+     */
+    struct sf_rpc_method_t
+    {
+        std::string name;               // 函数id
+        int id;                         // 函数编号（注册顺序）
+        unsigned long long signature;   // 签名（函数id、参数与返回值类型的hash）
+    };
+
+    SF_MAKE_SERIALIZABLE_BINARY(sf_rpc_method_t, name, id, signature)
+
+    /**
+     *  @brief rpc按函数编号请求的上下文视图（反序列化时不复制参数）
+     */
+    struct sf_rpc_req_id_view_t
+    {
+        int call_id;                    // 调用id
+        int method_id;                  // 函数编号
+        sf_byte_view params;            // 参数（指向接收缓冲区）
+    };
+
+    SF_MAKE_SERIALIZABLE_BINARY(sf_rpc_req_id_view_t, call_id, method_id, params)
+
+    /**
+     * 计算rpc函数签名（FNV-1a），参数类型为std::tuple<参数...>
+     * NOTE 类型名称来自typeid，不同编译器的结果不同，此时签名不一致，客户端按函数id调用
+     * @param name 函数id
+     * @return 签名
+     */
+    template<typename _Ret, typename _Param>
+    unsigned long long sf_rpc_signature(std::string_view name)
+    {
+        auto fnv1a = [](std::string_view str, unsigned long long hash) {
+            for (auto c : str)
+            {
+                hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3ULL;
+            }
+            return (hash ^ 0xffU) * 0x100000001b3ULL;
+        };
+        static const auto type_hash = fnv1a(typeid(_Ret).name(), fnv1a(typeid(_Param).name(), 0xcbf29ce484222325ULL));
+        return fnv1a(name, type_hash);
+    }
 }
\ No newline at end of file
@@ -21,6 +21,7 @@
 #include <vector>
 #include <exception>
 #include <string>
+#include <string_view>
 #include <cstring>
 #include <list>
 #include <deque>
@@ -29,11 +30,780 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <tuple>
+#include <array>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <limits>
+#include <algorithm>
 #include "sf_type.hpp"
 #include "sf_define.h"
+#include "sf_byte_order.hpp"
 
 namespace skyfire
 {
+    /**
+     *  @brief 序列化方式（写入与读取必须使用相同的方式）
+     */
+    enum class sf_binary_profile : unsigned char
+    {
+        native = 0,         // 内存原样：长度为size_t，整数为本机定长（默认，与之前的版本兼容）
+        compact = 1,        // 紧凑：长度与多字节整数（含枚举）使用LEB128变长编码，有符号整数先进行zigzag编码
+        portable = 2        // 可移植：长度固定为64位，多字节数值（整数、枚举、浮点数）固定为小端字节序
+                            // NOTE 小端64位主机上与native相同；结构成员应使用定宽类型（std::int32_t等），
+                            // 特化sf_is_trivially_serializable的结构按内存原样写入
+    };
+
+    /**
+     * 是否为已知的序列化方式（对端使用未知的方式时数据无法解析）
+     */
+    constexpr bool sf_is_binary_profile_supported(unsigned char profile);
+
+    /**
+     * zigzag编码（绝对值小的有符号数编码后数值也小）
+     */
+    constexpr unsigned long long sf_zigzag_encode(long long value);
+
+    /**
+     * zigzag解码
+     */
+    constexpr long long sf_zigzag_decode(unsigned long long value);
+
+    /**
+     * LEB128变长编码的字节数
+     */
+    constexpr size_t sf_varint_size(unsigned long long value);
+
+    /**
+     *  @brief compact方式下使用变长编码的类型（多字节整数、枚举及其std::array），单字节整数与bool保持原样
+     */
+    template<typename _Type, typename = void>
+    struct sf_is_varint_serializable : std::false_type
+    {
+    };
+
+    template<typename _Type>
+    struct sf_is_varint_serializable<_Type, typename std::enable_if<
+            (std::is_integral<_Type>::value || std::is_enum<_Type>::value) && (sizeof(_Type) > 1)>::type>
+            : std::true_type
+    {
+    };
+
+    template<typename _Type, size_t N>
+    struct sf_is_varint_serializable<std::array<_Type, N>> : sf_is_varint_serializable<_Type>
+    {
+    };
+
+    /**
+     *  @brief 二进制序列化输出，所有数据直接追加到同一个可增长的缓冲区中
+     *  @tparam _Buffer 缓冲区类型（连续存储的char容器，如byte_array、std::pmr::vector<char>）
+     */
+    template<typename _Buffer = byte_array>
+    class sf_basic_binary_writer
+    {
+    private:
+        _Buffer own_buffer__;
+        _Buffer *buffer__;
+        sf_binary_profile profile__;
+
+        void write_varint__(unsigned long long value);
+
+    public:
+        /**
+         * 写入内部缓冲区
+         * @param profile 序列化方式
+         */
+        explicit sf_basic_binary_writer(sf_binary_profile profile = sf_binary_profile::native);
+
+        /**
+         * 追加写入调用者提供的缓冲区（已有内容保留，内存由缓冲区自身的分配器分配）
+         * @param buffer 缓冲区
+         * @param profile 序列化方式
+         */
+        explicit sf_basic_binary_writer(_Buffer &buffer, sf_binary_profile profile = sf_binary_profile::native);
+
+        /**
+         * 序列化方式
+         */
+        sf_binary_profile profile() const;
+
+        sf_basic_binary_writer(const sf_basic_binary_writer &) = delete;
+
+        sf_basic_binary_writer &operator=(const sf_basic_binary_writer &) = delete;
+
+        /**
+         * 预留空间
+         * @param size 在当前长度之后预留的字节数
+         */
+        void reserve(size_t size);
+
+        /**
+         * 写入原始字节
+         * @param data 数据
+         * @param size 长度
+         */
+        void write(const void *data, size_t size);
+
+        /**
+         * 写入pod类型的内存内容
+         * @param value 值
+         */
+        template<typename _Pod_Type>
+        void write_pod(const _Pod_Type &value);
+
+        /**
+         * 写入pod数组（portable方式下在大端主机上转换字节序，其他情况直接复制）
+         * @param data 数组
+         * @param count 元素个数
+         */
+        template<typename _Pod_Type>
+        void write_array(const _Pod_Type *data, size_t count);
+
+        /**
+         * 写入pod类型的值（compact方式下整数使用变长编码，portable方式下数值为小端字节序）
+         * @param value 值
+         */
+        template<typename _Pod_Type>
+        void write_scalar(const _Pod_Type &value);
+
+        /**
+         * 写入长度
+         * @param size 长度
+         */
+        void write_size(size_t size);
+
+        /**
+         * 开始一个带长度的数据块（先写入长度占位，布局与byte_array的序列化结果相同）
+         * @return 长度所在位置，传给end_block
+         */
+        size_t begin_block();
+
+        /**
+         * 结束数据块，回填长度
+         * @param pos begin_block的返回值
+         */
+        void end_block(size_t pos);
+
+        /**
+         * 已写入的长度
+         */
+        size_t size() const;
+
+        /**
+         * 获取缓冲区
+         */
+        _Buffer &buffer();
+    };
+
+    /**
+     *  @brief 写入byte_array的序列化输出
+     */
+    using sf_binary_writer = sf_basic_binary_writer<byte_array>;
+
+    /**
+     *  @brief 写入pmr缓冲区的序列化输出（如使用栈上的monotonic_buffer_resource）
+     */
+    using sf_pmr_binary_writer = sf_basic_binary_writer<std::pmr::vector<char>>;
+
+    /**
+     *  @brief 序列化结果与内存内容完全相同的类型（连续存储的此类元素整体memcpy，不逐个序列化）
+     *  默认为算术类型与枚举（及其std::array），内存布局与逐成员序列化相同的自定义pod类型可以特化为true
+     *  （使用SF_MAKE_SERIALIZABLE_BINARY逐成员序列化、且包含填充字节的结构不能特化）
+     */
+    template<typename _Type>
+    struct sf_is_trivially_serializable
+            : std::integral_constant<bool, std::is_arithmetic<_Type>::value || std::is_enum<_Type>::value>
+    {
+    };
+
+    template<typename _Type, size_t N>
+    struct sf_is_trivially_serializable<std::array<_Type, N>> : sf_is_trivially_serializable<_Type>
+    {
+    };
+
+    /**
+     *  @brief 字节数组视图，反序列化时指向源缓冲区，不复制数据（生命周期不能超过源缓冲区）
+     *  序列化结果与byte_array相同
+     */
+    class sf_byte_view
+    {
+    private:
+        const char *data__ = nullptr;
+        size_t size__ = 0;
+
+    public:
+        sf_byte_view() = default;
+
+        /**
+         * @param data 数据
+         * @param size 长度
+         */
+        sf_byte_view(const char *data, size_t size);
+
+        /**
+         * @param data 字节数组
+         */
+        sf_byte_view(const byte_array &data);
+
+        const char *data() const;
+
+        size_t size() const;
+
+        bool empty() const;
+
+        const char *begin() const;
+
+        const char *end() const;
+
+        char operator[](size_t index) const;
+
+        /**
+         * 复制为字节数组
+         */
+        byte_array to_byte_array() const;
+    };
+
+    /**
+     *  @brief vector视图，反序列化时指向源缓冲区，访问元素时才解码（生命周期不能超过源缓冲区）
+     *  序列化结果与std::vector<_Type>相同
+     *  @tparam _Type 元素类型，必须满足sf_is_trivially_serializable（定长，可以随机访问）
+     */
+    template<typename _Type>
+    class sf_vector_view
+    {
+        static_assert(sf_is_trivially_serializable<_Type>::value, "Element must be trivially serializable");
+
+    private:
+        const char *data__ = nullptr;
+        size_t size__ = 0;
+
+    public:
+        /**
+         *  @brief 迭代器，解引用时解码元素
+         */
+        class const_iterator
+        {
+        private:
+            const char *pos__;
+
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = _Type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const _Type *;
+            using reference = _Type;
+
+            explicit const_iterator(const char *pos);
+
+            _Type operator*() const;
+
+            const_iterator &operator++();
+
+            bool operator==(const const_iterator &other) const;
+
+            bool operator!=(const const_iterator &other) const;
+        };
+
+        sf_vector_view() = default;
+
+        /**
+         * @param data 第一个元素的位置（不要求对齐）
+         * @param size 元素个数
+         */
+        sf_vector_view(const char *data, size_t size);
+
+        size_t size() const;
+
+        bool empty() const;
+
+        /**
+         * 解码第index个元素
+         */
+        _Type operator[](size_t index) const;
+
+        const_iterator begin() const;
+
+        const_iterator end() const;
+
+        /**
+         * 原始字节
+         */
+        sf_byte_view bytes() const;
+
+        /**
+         * 解码为vector
+         */
+        std::vector<_Type> to_vector() const;
+    };
+
+    /**
+     * 解码LEB128变长编码
+     * @param data 数据
+     * @param size 数据长度
+     * @param value 解码结果
+     * @return 读取的字节数，0表示数据不足，-1表示数据错误（超过64位）
+     */
+    inline int sf_decode_varint__(const char *data, size_t size, unsigned long long &value);
+
+    /**
+     * 将解码后的变长编码整数转换为目标类型（有符号整数进行zigzag解码）
+     * @return 是否在目标类型的范围内
+     */
+    template<typename _Type>
+    bool sf_varint_to_scalar__(unsigned long long raw, _Type &value);
+
+    /**
+     *  @brief 二进制反序列化输入，从字节数组的指定位置开始依次读取
+     *  数据不足时抛出sf_serialize_binary_size_mismatch_exception
+     */
+    class sf_binary_cursor
+    {
+    private:
+        const byte_array *data__;
+        size_t pos__;
+        sf_binary_profile profile__;
+
+    public:
+        /**
+         * @param data 数据（读取期间不能释放或修改，视图类型的结果指向其内部）
+         * @param pos 开始位置
+         * @param profile 序列化方式
+         */
+        explicit sf_binary_cursor(const byte_array &data, size_t pos = 0,
+                                  sf_binary_profile profile = sf_binary_profile::native);
+
+        /**
+         * 数据
+         */
+        const byte_array &data() const;
+
+        /**
+         * 当前位置
+         */
+        size_t pos() const;
+
+        /**
+         * 设置当前位置
+         */
+        void seek(size_t pos);
+
+        /**
+         * 剩余字节数
+         */
+        size_t remaining() const;
+
+        /**
+         * 序列化方式
+         */
+        sf_binary_profile profile() const;
+
+        /**
+         * 读取count个size字节的元素
+         * @return 第一个元素的位置
+         */
+        const char *read(size_t count, size_t size);
+
+        /**
+         * 读取pod类型的内存内容
+         */
+        template<typename _Pod_Type>
+        void read_pod(_Pod_Type &value);
+
+        /**
+         * 读取pod数组（与write_array对应）
+         */
+        template<typename _Pod_Type>
+        void read_array(_Pod_Type *data, size_t count);
+
+        /**
+         * 读取pod类型的值（与write_scalar对应）
+         */
+        template<typename _Pod_Type>
+        void read_scalar(_Pod_Type &value);
+
+        /**
+         * 读取长度
+         */
+        size_t read_size();
+
+        /**
+         * 读取LEB128变长编码的整数
+         */
+        unsigned long long read_varint();
+    };
+
+    /**
+     *  @brief 增量反序列化的结果
+     */
+    enum class sf_binary_read_status : unsigned char
+    {
+        done = 0,           // 读取完成
+        need_more = 1,      // 数据不足，继续输入数据后使用同一个对象再次读取
+        error = 2           // 数据错误（变长编码超出范围等），需要reset后才能继续使用
+    };
+
+    /**
+     *  @brief 增量反序列化中一层容器（或结构）的读取进度
+     */
+    struct sf_binary_reader_frame_t
+    {
+        size_t index = 0;                   // 已读取完成的元素（成员）数量
+        size_t size = 0;                    // 容器长度
+        bool has_size = false;              // 是否已读取容器长度
+        std::shared_ptr<void> element;      // 暂停时未读取完成的元素（不能直接在容器中读取的元素）
+    };
+
+    /**
+     *  @brief 增量二进制反序列化，数据可以分段输入（如从socket中陆续收到的数据）
+     *  数据不足时返回need_more并记录在嵌套容器中的读取进度，继续输入数据后使用同一个对象再次读取即可从中断处继续，
+     *  已读取的数据从缓冲区中丢弃，缓冲区只保留未读取的数据（大型容器不需要等待全部数据到达）
+     *  NOTE 不支持视图类型（缓冲区中的数据读取后即被丢弃）
+     */
+    class sf_binary_reader
+    {
+    private:
+        byte_array buffer__;
+        size_t pos__ = 0;
+        sf_binary_profile profile__;
+        std::vector<sf_binary_reader_frame_t> frames__;
+        size_t depth__ = 0;
+
+    public:
+        /**
+         * @param profile 序列化方式
+         */
+        explicit sf_binary_reader(sf_binary_profile profile = sf_binary_profile::native);
+
+        /**
+         * 输入数据
+         * @param data 数据
+         * @param size 长度
+         */
+        void feed(const char *data, size_t size);
+
+        /**
+         * 输入数据
+         * @param data 数据
+         */
+        void feed(const byte_array &data);
+
+        /**
+         * 读取对象
+         * @param obj 对象（返回need_more时，再次读取必须使用同一个对象，已读取的部分保留在对象中）
+         * @return 读取结果
+         */
+        template<typename _Type>
+        sf_binary_read_status read(_Type &obj);
+
+        /**
+         * 缓冲区中未读取的字节数
+         */
+        size_t buffered() const;
+
+        /**
+         * 序列化方式
+         */
+        sf_binary_profile profile() const;
+
+        /**
+         * 丢弃缓冲区中的数据与读取进度
+         */
+        void reset();
+
+        // 以下接口用于实现自定义类型的sf_deserialize_binary_step
+
+        /**
+         * 当前可以读取的数据
+         */
+        const char *peek() const;
+
+        /**
+         * 跳过已读取的数据
+         * @param size 字节数
+         */
+        void skip(size_t size);
+
+        /**
+         * 读取pod类型的值（数据不足时不读取）
+         */
+        template<typename _Pod_Type>
+        sf_binary_read_status read_scalar(_Pod_Type &value);
+
+        /**
+         * 读取长度（数据不足时不读取）
+         */
+        sf_binary_read_status read_size(size_t &size);
+
+        /**
+         * 进入一层容器（或结构），从中断处继续时返回原来的层
+         * @return 层号
+         */
+        size_t enter();
+
+        /**
+         * 读取进度
+         * @param level 层号（嵌套读取可能导致之前返回的引用失效，每次使用前重新获取）
+         */
+        sf_binary_reader_frame_t &frame(size_t level);
+
+        /**
+         * 当前层读取完成
+         * @param level 层号
+         */
+        void leave(size_t level);
+    };
+
+    // sf_serialize_binary_to 将对象序列化后追加到writer中，结果与sf_serialize_binary相同
+    // NOTE 只提供sf_serialize_binary的自定义类型也可以使用（先序列化为byte_array再追加）
+
+    template<typename _Buffer, typename _Type>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer, const _Type &value);
+
+    template<typename _Buffer, typename _Type>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer, const std::vector<_Type> &value);
+
+    template<typename _Buffer, typename _Type, size_t N>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer, const std::array<_Type, N> &value);
+
+    template<typename _Buffer, typename _Type>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer, const std::list<_Type> &value);
+
+    template<typename _Buffer, typename _Type>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer, const std::deque<_Type> &value);
+
+    template<typename _Buffer, typename _Type>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer, const std::set<_Type> &value);
+
+    template<typename _Buffer, typename _Type>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer, const std::unordered_set<_Type> &value);
+
+    template<typename _Buffer, typename _Type>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer, const std::multiset<_Type> &value);
+
+    template<typename _Buffer, typename _Type>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer, const std::basic_string<_Type> &value);
+
+    template<typename _Buffer, typename _Type>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer, const std::unordered_multiset<_Type> &value);
+
+    template<typename _Buffer, typename _TypeKey, typename _TypeValue>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer,
+                                const std::unordered_multimap<_TypeKey, _TypeValue> &obj);
+
+    template<typename _Buffer, typename _TypeKey, typename _TypeValue>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer,
+                                const std::unordered_map<_TypeKey, _TypeValue> &obj);
+
+    template<typename _Buffer, typename _TypeKey, typename _TypeValue>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer,
+                                const std::multimap<_TypeKey, _TypeValue> &obj);
+
+    template<typename _Buffer, typename _TypeKey, typename _TypeValue>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer, const std::map<_TypeKey, _TypeValue> &obj);
+
+    template<typename _Buffer, typename... _Types>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer, const std::tuple<_Types...> &obj);
+
+    template<typename _Buffer>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer, const std::string_view &value);
+
+    template<typename _Buffer>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer, const sf_byte_view &value);
+
+    template<typename _Buffer, typename _Type>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer, const sf_vector_view<_Type> &value);
+
+    template<typename _Buffer, typename... _Type>
+    void sf_serialize_binary_obj_to_helper(sf_basic_binary_writer<_Buffer> &writer, const _Type &... obj);
+
+    // sf_deserialize_binary_from 从cursor中读取对象，与sf_serialize_binary_to对应
+    // NOTE 只提供sf_deserialize_binary的自定义类型也可以使用（只支持native方式）
+
+    template<typename _Type>
+    void sf_deserialize_binary_from(sf_binary_cursor &cursor, _Type &obj);
+
+    template<typename _Type>
+    void sf_deserialize_binary_from(sf_binary_cursor &cursor, std::vector<_Type> &obj);
+
+    template<typename _Type, size_t N>
+    void sf_deserialize_binary_from(sf_binary_cursor &cursor, std::array<_Type, N> &obj);
+
+    template<typename _Type>
+    void sf_deserialize_binary_from(sf_binary_cursor &cursor, std::list<_Type> &obj);
+
+    template<typename _Type>
+    void sf_deserialize_binary_from(sf_binary_cursor &cursor, std::deque<_Type> &obj);
+
+    template<typename _Type>
+    void sf_deserialize_binary_from(sf_binary_cursor &cursor, std::set<_Type> &obj);
+
+    template<typename _Type>
+    void sf_deserialize_binary_from(sf_binary_cursor &cursor, std::unordered_set<_Type> &obj);
+
+    template<typename _Type>
+    void sf_deserialize_binary_from(sf_binary_cursor &cursor, std::multiset<_Type> &obj);
+
+    template<typename _Type>
+    void sf_deserialize_binary_from(sf_binary_cursor &cursor, std::basic_string<_Type> &obj);
+
+    template<typename _Type>
+    void sf_deserialize_binary_from(sf_binary_cursor &cursor, std::unordered_multiset<_Type> &obj);
+
+    template<typename _TypeKey, typename _TypeValue>
+    void sf_deserialize_binary_from(sf_binary_cursor &cursor, std::unordered_multimap<_TypeKey, _TypeValue> &obj);
+
+    template<typename _TypeKey, typename _TypeValue>
+    void sf_deserialize_binary_from(sf_binary_cursor &cursor, std::unordered_map<_TypeKey, _TypeValue> &obj);
+
+    template<typename _TypeKey, typename _TypeValue>
+    void sf_deserialize_binary_from(sf_binary_cursor &cursor, std::multimap<_TypeKey, _TypeValue> &obj);
+
+    template<typename _TypeKey, typename _TypeValue>
+    void sf_deserialize_binary_from(sf_binary_cursor &cursor, std::map<_TypeKey, _TypeValue> &obj);
+
+    template<typename... _Types>
+    void sf_deserialize_binary_from(sf_binary_cursor &cursor, std::tuple<_Types...> &obj);
+
+    inline void sf_deserialize_binary_from(sf_binary_cursor &cursor, std::string_view &obj);
+
+    inline void sf_deserialize_binary_from(sf_binary_cursor &cursor, sf_byte_view &obj);
+
+    template<typename _Type>
+    void sf_deserialize_binary_from(sf_binary_cursor &cursor, sf_vector_view<_Type> &obj);
+
+    template<typename... _Type>
+    void sf_deserialize_binary_obj_from_helper(sf_binary_cursor &cursor, _Type &... obj);
+
+    /**
+     * 从游标中反序列化不可信的数据（如网络数据包），数据不足或格式错误时返回false，不抛出异常
+     * @param cursor 游标
+     * @param obj 对象
+     * @return 是否成功
+     */
+    template<typename _Type>
+    bool sf_try_deserialize_binary_from(sf_binary_cursor &cursor, _Type &obj);
+
+    // sf_deserialize_binary_step 从reader中增量读取对象（数据不足时返回need_more，再次调用时从中断处继续）
+    // NOTE pod类型作为整体读取，其他类型需要提供对应的重载（SF_MAKE_SERIALIZABLE_BINARY会生成）
+
+    template<typename _Type>
+    sf_binary_read_status sf_deserialize_binary_step(sf_binary_reader &reader, _Type &obj);
+
+    template<typename _Type>
+    sf_binary_read_status sf_deserialize_binary_step(sf_binary_reader &reader, std::vector<_Type> &obj);
+
+    template<typename _Type, size_t N>
+    sf_binary_read_status sf_deserialize_binary_step(sf_binary_reader &reader, std::array<_Type, N> &obj);
+
+    template<typename _Type>
+    sf_binary_read_status sf_deserialize_binary_step(sf_binary_reader &reader, std::list<_Type> &obj);
+
+    template<typename _Type>
+    sf_binary_read_status sf_deserialize_binary_step(sf_binary_reader &reader, std::deque<_Type> &obj);
+
+    template<typename _Type>
+    sf_binary_read_status sf_deserialize_binary_step(sf_binary_reader &reader, std::set<_Type> &obj);
+
+    template<typename _Type>
+    sf_binary_read_status sf_deserialize_binary_step(sf_binary_reader &reader, std::unordered_set<_Type> &obj);
+
+    template<typename _Type>
+    sf_binary_read_status sf_deserialize_binary_step(sf_binary_reader &reader, std::multiset<_Type> &obj);
+
+    template<typename _Type>
+    sf_binary_read_status sf_deserialize_binary_step(sf_binary_reader &reader, std::basic_string<_Type> &obj);
+
+    template<typename _Type>
+    sf_binary_read_status sf_deserialize_binary_step(sf_binary_reader &reader, std::unordered_multiset<_Type> &obj);
+
+    template<typename _TypeKey, typename _TypeValue>
+    sf_binary_read_status
+    sf_deserialize_binary_step(sf_binary_reader &reader, std::unordered_multimap<_TypeKey, _TypeValue> &obj);
+
+    template<typename _TypeKey, typename _TypeValue>
+    sf_binary_read_status
+    sf_deserialize_binary_step(sf_binary_reader &reader, std::unordered_map<_TypeKey, _TypeValue> &obj);
+
+    template<typename _TypeKey, typename _TypeValue>
+    sf_binary_read_status
+    sf_deserialize_binary_step(sf_binary_reader &reader, std::multimap<_TypeKey, _TypeValue> &obj);
+
+    template<typename _TypeKey, typename _TypeValue>
+    sf_binary_read_status sf_deserialize_binary_step(sf_binary_reader &reader, std::map<_TypeKey, _TypeValue> &obj);
+
+    template<typename... _Types>
+    sf_binary_read_status sf_deserialize_binary_step(sf_binary_reader &reader, std::tuple<_Types...> &obj);
+
+    // NOTE 视图类型指向的数据读取后即被丢弃，不支持增量读取（返回error）
+
+    inline sf_binary_read_status sf_deserialize_binary_step(sf_binary_reader &reader, std::string_view &obj);
+
+    inline sf_binary_read_status sf_deserialize_binary_step(sf_binary_reader &reader, sf_byte_view &obj);
+
+    template<typename _Type>
+    sf_binary_read_status sf_deserialize_binary_step(sf_binary_reader &reader, sf_vector_view<_Type> &obj);
+
+    template<typename... _Type>
+    sf_binary_read_status sf_deserialize_binary_obj_step_helper(sf_binary_reader &reader, _Type &... obj);
+
+    // sf_serialized_size 计算序列化结果的长度（不进行序列化），可用于一次分配准确大小的缓冲区
+    // NOTE 按native方式计算（compact方式的结果通常更短），pod类型、pod数组与只包含pod的tuple可以在编译期计算
+
+    template<typename _Type>
+    constexpr size_t sf_serialized_size(const _Type &value);
+
+    template<typename _Type>
+    size_t sf_serialized_size(const std::vector<_Type> &value);
+
+    template<typename _Type, size_t N>
+    constexpr size_t sf_serialized_size(const std::array<_Type, N> &value);
+
+    template<typename _Type>
+    size_t sf_serialized_size(const std::list<_Type> &value);
+
+    template<typename _Type>
+    size_t sf_serialized_size(const std::deque<_Type> &value);
+
+    template<typename _Type>
+    size_t sf_serialized_size(const std::set<_Type> &value);
+
+    template<typename _Type>
+    size_t sf_serialized_size(const std::unordered_set<_Type> &value);
+
+    template<typename _Type>
+    size_t sf_serialized_size(const std::multiset<_Type> &value);
+
+    template<typename _Type>
+    size_t sf_serialized_size(const std::basic_string<_Type> &value);
+
+    template<typename _Type>
+    size_t sf_serialized_size(const std::unordered_multiset<_Type> &value);
+
+    template<typename _TypeKey, typename _TypeValue>
+    size_t sf_serialized_size(const std::unordered_multimap<_TypeKey, _TypeValue> &obj);
+
+    template<typename _TypeKey, typename _TypeValue>
+    size_t sf_serialized_size(const std::unordered_map<_TypeKey, _TypeValue> &obj);
+
+    template<typename _TypeKey, typename _TypeValue>
+    size_t sf_serialized_size(const std::multimap<_TypeKey, _TypeValue> &obj);
+
+    template<typename _TypeKey, typename _TypeValue>
+    size_t sf_serialized_size(const std::map<_TypeKey, _TypeValue> &obj);
+
+    template<typename... _Types>
+    constexpr size_t sf_serialized_size(const std::tuple<_Types...> &obj);
+
+    inline size_t sf_serialized_size(const std::string_view &value);
+
+    inline size_t sf_serialized_size(const sf_byte_view &value);
+
+    template<typename _Type>
+    size_t sf_serialized_size(const sf_vector_view<_Type> &value);
+
+    template<typename... _Type>
+    constexpr size_t sf_serialized_size_obj_helper(const _Type &... obj);
+
     template<typename _Pod_Type>
     typename std::enable_if<std::is_pod<_Pod_Type>::value, byte_array>::type sf_serialize_binary(const _Pod_Type &value);
 
@@ -47,6 +817,12 @@ namespace skyfire
     template<typename _Type>
     size_t sf_deserialize_binary(const byte_array &data, std::vector <_Type> &obj, size_t begin_pos);
 
+    template<typename _Type, size_t N>
+    byte_array sf_serialize_binary(const std::array<_Type, N> &value);
+
+    template<typename _Type, size_t N>
+    size_t sf_deserialize_binary(const byte_array &data, std::array<_Type, N> &obj, size_t begin_pos);
+
     template<typename _Type>
     byte_array sf_serialize_binary(const std::list <_Type> &value);
 
@@ -145,6 +921,22 @@ namespace skyfire
     template<typename... _Types>
     size_t sf_deserialize_binary(const byte_array &data, std::tuple<_Types...> &obj, size_t begin_pos);
 
+    // 视图类型的反序列化不复制数据，结果指向data内部
+
+    inline byte_array sf_serialize_binary(const std::string_view &value);
+
+    inline size_t sf_deserialize_binary(const byte_array &data, std::string_view &obj, size_t begin_pos);
+
+    inline byte_array sf_serialize_binary(const sf_byte_view &value);
+
+    inline size_t sf_deserialize_binary(const byte_array &data, sf_byte_view &obj, size_t begin_pos);
+
+    template<typename _Type>
+    byte_array sf_serialize_binary(const sf_vector_view<_Type> &value);
+
+    template<typename _Type>
+    size_t sf_deserialize_binary(const byte_array &data, sf_vector_view<_Type> &obj, size_t begin_pos);
+
     class sf_serialize_binary_size_mismatch_exception : public std::exception
     {
     public:
@@ -161,16 +953,35 @@ namespace skyfire
     template<typename T, typename ... _Type>
     size_t sf_deserialize_binary_obj_helper(const byte_array &data, size_t begin_pos, T &obj, _Type &... other);
 
+    /**
+     * 使用sf_binary_cursor（native方式）反序列化
+     */
+    template<typename _Type>
+    size_t sf_deserialize_binary_by_cursor__(const byte_array &data, _Type &obj, size_t begin_pos);
+
 
     //使一个结构变成可序列化的结构（需保证内部的每个成员都可以序列化，使用时需要注入到skyfire命名空间内部）
 
 #define SF_MAKE_SERIALIZABLE_BINARY(className, ...)                                                                            \
+    template<typename _Buffer>                                                                                          \
+    inline void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer, const className &obj){                 \
+        sf_serialize_binary_obj_to_helper(writer, SF_EXPAND_OBJ_MEM(obj, __VA_ARGS__));                                  \
+    }                                                                                                                   \
+    inline size_t sf_serialized_size(const className &obj){                                                             \
+        return sf_serialized_size_obj_helper(SF_EXPAND_OBJ_MEM(obj, __VA_ARGS__));                                       \
+    }                                                                                                                   \
 inline byte_array sf_serialize_binary(const className& obj){                                                                  \
         return sf_serialize_binary_obj_helper(SF_EXPAND_OBJ_MEM(obj, __VA_ARGS__));                                            \
     }                                                                                                                   \
+    inline void sf_deserialize_binary_from(sf_binary_cursor &cursor, className &obj){                                   \
+        sf_deserialize_binary_obj_from_helper(cursor, SF_EXPAND_OBJ_MEM(obj, __VA_ARGS__));                              \
+    }                                                                                                                   \
+    inline sf_binary_read_status sf_deserialize_binary_step(sf_binary_reader &reader, className &obj){                \
+        return sf_deserialize_binary_obj_step_helper(reader, SF_EXPAND_OBJ_MEM(obj, __VA_ARGS__));                       \
+    }                                                                                                                   \
     inline size_t                                                                                                       \
     sf_deserialize_binary(const byte_array &data, className &obj, size_t begin_pos){                                           \
-        return sf_deserialize_binary_obj_helper(data, begin_pos, SF_EXPAND_OBJ_MEM(obj, __VA_ARGS__));                         \
+        return sf_deserialize_binary_by_cursor__(data, obj, begin_pos);                                                 \
     }                                                                                                                   \
 
 
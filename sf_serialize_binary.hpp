@@ -30,243 +30,1508 @@ namespace skyfire {
         return _message.c_str();
     }
 
+    inline sf_byte_view::sf_byte_view(const char *data, size_t size) : data__(data), size__(size) {
+    }
+
+    inline sf_byte_view::sf_byte_view(const byte_array &data) : data__(data.data()), size__(data.size()) {
+    }
+
+    inline const char *sf_byte_view::data() const {
+        return data__;
+    }
+
+    inline size_t sf_byte_view::size() const {
+        return size__;
+    }
+
+    inline bool sf_byte_view::empty() const {
+        return size__ == 0;
+    }
+
+    inline const char *sf_byte_view::begin() const {
+        return data__;
+    }
+
+    inline const char *sf_byte_view::end() const {
+        return data__ + size__;
+    }
+
+    inline char sf_byte_view::operator[](size_t index) const {
+        return data__[index];
+    }
+
+    inline byte_array sf_byte_view::to_byte_array() const {
+        return byte_array(begin(), end());
+    }
+
+    template<typename _Type>
+    inline sf_vector_view<_Type>::const_iterator::const_iterator(const char *pos) : pos__(pos) {
+    }
+
+    template<typename _Type>
+    inline _Type sf_vector_view<_Type>::const_iterator::operator*() const {
+        _Type ret;
+        memcpy(&ret, pos__, sizeof(_Type));
+        return ret;
+    }
+
+    template<typename _Type>
+    inline typename sf_vector_view<_Type>::const_iterator &sf_vector_view<_Type>::const_iterator::operator++() {
+        pos__ += sizeof(_Type);
+        return *this;
+    }
+
+    template<typename _Type>
+    inline bool sf_vector_view<_Type>::const_iterator::operator==(const const_iterator &other) const {
+        return pos__ == other.pos__;
+    }
+
+    template<typename _Type>
+    inline bool sf_vector_view<_Type>::const_iterator::operator!=(const const_iterator &other) const {
+        return pos__ != other.pos__;
+    }
+
+    template<typename _Type>
+    inline sf_vector_view<_Type>::sf_vector_view(const char *data, size_t size) : data__(data), size__(size) {
+    }
+
+    template<typename _Type>
+    inline size_t sf_vector_view<_Type>::size() const {
+        return size__;
+    }
+
+    template<typename _Type>
+    inline bool sf_vector_view<_Type>::empty() const {
+        return size__ == 0;
+    }
+
+    template<typename _Type>
+    inline _Type sf_vector_view<_Type>::operator[](size_t index) const {
+        return *const_iterator(data__ + index * sizeof(_Type));
+    }
+
+    template<typename _Type>
+    inline typename sf_vector_view<_Type>::const_iterator sf_vector_view<_Type>::begin() const {
+        return const_iterator(data__);
+    }
+
+    template<typename _Type>
+    inline typename sf_vector_view<_Type>::const_iterator sf_vector_view<_Type>::end() const {
+        return const_iterator(data__ + size__ * sizeof(_Type));
+    }
+
+    template<typename _Type>
+    inline sf_byte_view sf_vector_view<_Type>::bytes() const {
+        return sf_byte_view(data__, size__ * sizeof(_Type));
+    }
+
+    template<typename _Type>
+    inline std::vector<_Type> sf_vector_view<_Type>::to_vector() const {
+        std::vector<_Type> ret(size__);
+        if (size__ != 0) {
+            memcpy(ret.data(), data__, size__ * sizeof(_Type));
+        }
+        return ret;
+    }
+
     inline byte_array sf_serialize_binary() {
         return byte_array();
     }
 
+    constexpr unsigned long long sf_zigzag_encode(long long value) {
+        return (static_cast<unsigned long long>(value) << 1) ^ static_cast<unsigned long long>(value >> 63);
+    }
+
+    constexpr long long sf_zigzag_decode(unsigned long long value) {
+        return static_cast<long long>(value >> 1) ^ -static_cast<long long>(value & 1);
+    }
+
+    constexpr size_t sf_varint_size(unsigned long long value) {
+        size_t ret = 1;
+        while (value >= 0x80) {
+            value >>= 7;
+            ++ret;
+        }
+        return ret;
+    }
+
+    constexpr bool sf_is_binary_profile_supported(unsigned char profile) {
+        return profile <= static_cast<unsigned char>(sf_binary_profile::portable);
+    }
+
+    /**
+     * portable方式下转换字节序的单位（数值类型为其大小，std::array为元素的单位，其他类型为1，即按内存原样）
+     */
+    template<typename _Type>
+    struct sf_byte_order_unit__ : std::integral_constant<size_t,
+            (std::is_arithmetic<_Type>::value || std::is_enum<_Type>::value) ? sizeof(_Type) : 1>
+    {
+    };
+
+    template<typename _Type, size_t N>
+    struct sf_byte_order_unit__<std::array<_Type, N>> : sf_byte_order_unit__<_Type>
+    {
+    };
+
+    /**
+     * portable方式下单个值是否需要转换字节序（只有大端主机上的多字节数值类型需要）
+     */
+    template<typename _Type>
+    constexpr bool sf_is_byte_order_scalar__() {
+        return !sf_host_little_endian && (std::is_arithmetic<_Type>::value || std::is_enum<_Type>::value)
+               && sizeof(_Type) > 1;
+    }
+
+    /**
+     * 指定方式下数组的内存内容与序列化结果是否相同（相同时可以直接复制或使用视图）
+     */
+    template<typename _Type>
+    bool sf_is_binary_raw__(sf_binary_profile profile) {
+        switch (profile) {
+            case sf_binary_profile::compact:
+                return !sf_is_varint_serializable<_Type>::value;
+            case sf_binary_profile::portable:
+                return sf_host_little_endian || sf_byte_order_unit__<_Type>::value == 1;
+            default:
+                return true;
+        }
+    }
+
+    /**
+     * 复制数组（portable方式下在大端主机上转换字节序）
+     */
+    template<typename _Type>
+    void sf_copy_binary_array__(void *dst, const void *src, size_t count, sf_binary_profile profile) {
+        if constexpr (!sf_host_little_endian && sf_byte_order_unit__<_Type>::value > 1) {
+            if (profile == sf_binary_profile::portable) {
+                constexpr auto unit = sf_byte_order_unit__<_Type>::value;
+                sf_byte_swap_copy(dst, src, count * sizeof(_Type) / unit, unit);
+                return;
+            }
+        }
+        memcpy(dst, src, count * sizeof(_Type));
+    }
+
+    /**
+     * compact方式下是否使用变长编码（不含std::array）
+     */
+    template<typename _Type>
+    constexpr bool sf_is_varint_scalar__() {
+        return (std::is_integral<_Type>::value || std::is_enum<_Type>::value) && sizeof(_Type) > 1;
+    }
+
+    template<typename _Buffer>
+    inline sf_basic_binary_writer<_Buffer>::sf_basic_binary_writer(sf_binary_profile profile)
+            : buffer__(&own_buffer__), profile__(profile) {
+    }
+
+    template<typename _Buffer>
+    inline sf_basic_binary_writer<_Buffer>::sf_basic_binary_writer(_Buffer &buffer, sf_binary_profile profile)
+            : buffer__(&buffer), profile__(profile) {
+    }
+
+    template<typename _Buffer>
+    inline sf_binary_profile sf_basic_binary_writer<_Buffer>::profile() const {
+        return profile__;
+    }
+
+    template<typename _Buffer>
+    inline void sf_basic_binary_writer<_Buffer>::write_varint__(unsigned long long value) {
+        char buffer[10];
+        size_t len = 0;
+        while (value >= 0x80) {
+            buffer[len++] = static_cast<char>(value | 0x80);
+            value >>= 7;
+        }
+        buffer[len++] = static_cast<char>(value);
+        write(buffer, len);
+    }
+
+    template<typename _Buffer>
+    inline void sf_basic_binary_writer<_Buffer>::reserve(size_t size) {
+        buffer__->reserve(buffer__->size() + size);
+    }
+
+    template<typename _Buffer>
+    inline void sf_basic_binary_writer<_Buffer>::write(const void *data, size_t size) {
+        auto p = static_cast<const char *>(data);
+        buffer__->insert(buffer__->end(), p, p + size);
+    }
+
+    template<typename _Buffer>
+    template<typename _Pod_Type>
+    inline void sf_basic_binary_writer<_Buffer>::write_pod(const _Pod_Type &value) {
+        write(&value, sizeof(_Pod_Type));
+    }
+
+    template<typename _Buffer>
+    template<typename _Pod_Type>
+    inline void sf_basic_binary_writer<_Buffer>::write_array(const _Pod_Type *data, size_t count) {
+        if constexpr (!sf_host_little_endian && sf_byte_order_unit__<_Pod_Type>::value > 1) {
+            if (profile__ == sf_binary_profile::portable) {
+                auto pos = buffer__->size();
+                buffer__->resize(pos + count * sizeof(_Pod_Type));
+                sf_copy_binary_array__<_Pod_Type>(buffer__->data() + pos, data, count, profile__);
+                return;
+            }
+        }
+        write(data, count * sizeof(_Pod_Type));
+    }
+
+    template<typename _Buffer>
+    template<typename _Pod_Type>
+    inline void sf_basic_binary_writer<_Buffer>::write_scalar(const _Pod_Type &value) {
+        if constexpr (sf_is_varint_scalar__<_Pod_Type>()) {
+            if (profile__ == sf_binary_profile::compact) {
+                if constexpr (std::is_enum<_Pod_Type>::value) {
+                    write_scalar(static_cast<typename std::underlying_type<_Pod_Type>::type>(value));
+                } else if constexpr (std::is_signed<_Pod_Type>::value) {
+                    write_varint__(sf_zigzag_encode(value));
+                } else {
+                    write_varint__(value);
+                }
+                return;
+            }
+        }
+        if constexpr (sf_is_byte_order_scalar__<_Pod_Type>()) {
+            if (profile__ == sf_binary_profile::portable) {
+                write_pod(sf_byte_swap(value));
+                return;
+            }
+        }
+        write_pod(value);
+    }
+
+    template<typename _Buffer>
+    inline void sf_basic_binary_writer<_Buffer>::write_size(size_t size) {
+        if (profile__ == sf_binary_profile::compact) {
+            write_varint__(size);
+        } else if (profile__ == sf_binary_profile::portable) {
+            write_pod(sf_little_endian(static_cast<unsigned long long>(size)));
+        } else {
+            write_pod(size);
+        }
+    }
+
+    // NOTE compact方式的长度占位为最大的变长编码长度，结束时写入实际长度并将数据前移
+    constexpr size_t sf_compact_block_reserved__ = 10;
+
+    template<typename _Buffer>
+    inline size_t sf_basic_binary_writer<_Buffer>::begin_block() {
+        auto pos = buffer__->size();
+        if (profile__ == sf_binary_profile::compact) {
+            buffer__->resize(pos + sf_compact_block_reserved__);
+        } else if (profile__ == sf_binary_profile::portable) {
+            write_pod(0ULL);
+        } else {
+            write_pod(size_t{0});
+        }
+        return pos;
+    }
+
+    template<typename _Buffer>
+    inline void sf_basic_binary_writer<_Buffer>::end_block(size_t pos) {
+        if (profile__ == sf_binary_profile::compact) {
+            size_t len = buffer__->size() - pos - sf_compact_block_reserved__;
+            auto p = buffer__->data() + pos;
+            size_t n = 0;
+            while (len >= 0x80) {
+                p[n++] = static_cast<char>(len | 0x80);
+                len >>= 7;
+            }
+            p[n++] = static_cast<char>(len);
+            buffer__->erase(buffer__->begin() + pos + n, buffer__->begin() + pos + sf_compact_block_reserved__);
+        } else if (profile__ == sf_binary_profile::portable) {
+            auto len = sf_little_endian(static_cast<unsigned long long>(buffer__->size() - pos - sizeof(len)));
+            memcpy(buffer__->data() + pos, &len, sizeof(len));
+        } else {
+            size_t len = buffer__->size() - pos - sizeof(size_t);
+            memcpy(buffer__->data() + pos, &len, sizeof(len));
+        }
+    }
+
+    template<typename _Buffer>
+    inline size_t sf_basic_binary_writer<_Buffer>::size() const {
+        return buffer__->size();
+    }
+
+    template<typename _Buffer>
+    inline _Buffer &sf_basic_binary_writer<_Buffer>::buffer() {
+        return *buffer__;
+    }
+
+    inline int sf_decode_varint__(const char *data, size_t size, unsigned long long &value) {
+        auto p = reinterpret_cast<const unsigned char *>(data);
+        // NOTE 边界只在开始时检查一次
+        auto max_len = size < 10 ? size : 10;
+        value = 0;
+        for (size_t i = 0; i < max_len; ++i) {
+            value |= static_cast<unsigned long long>(p[i] & 0x7f) << (7 * i);
+            if (p[i] < 0x80) {
+                return i == 9 && p[i] > 1 ? -1 : static_cast<int>(i + 1);
+            }
+        }
+        return size < 10 ? 0 : -1;
+    }
+
+    template<typename _Type>
+    inline bool sf_varint_to_scalar__(unsigned long long raw, _Type &value) {
+        if constexpr (std::is_enum<_Type>::value) {
+            typename std::underlying_type<_Type>::type tmp;
+            if (!sf_varint_to_scalar__(raw, tmp)) {
+                return false;
+            }
+            value = static_cast<_Type>(tmp);
+        } else if constexpr (std::is_signed<_Type>::value) {
+            auto tmp = sf_zigzag_decode(raw);
+            if (tmp < std::numeric_limits<_Type>::min() || tmp > std::numeric_limits<_Type>::max()) {
+                return false;
+            }
+            value = static_cast<_Type>(tmp);
+        } else {
+            if (raw > std::numeric_limits<_Type>::max()) {
+                return false;
+            }
+            value = static_cast<_Type>(raw);
+        }
+        return true;
+    }
+
+    inline sf_binary_cursor::sf_binary_cursor(const byte_array &data, size_t pos, sf_binary_profile profile)
+            : data__(&data), pos__(pos), profile__(profile) {
+    }
+
+    inline const byte_array &sf_binary_cursor::data() const {
+        return *data__;
+    }
+
+    inline size_t sf_binary_cursor::pos() const {
+        return pos__;
+    }
+
+    inline void sf_binary_cursor::seek(size_t pos) {
+        pos__ = pos;
+    }
+
+    inline size_t sf_binary_cursor::remaining() const {
+        return pos__ < data__->size() ? data__->size() - pos__ : 0;
+    }
+
+    inline sf_binary_profile sf_binary_cursor::profile() const {
+        return profile__;
+    }
+
+    inline const char *sf_binary_cursor::read(size_t count, size_t size) {
+        if (pos__ > data__->size() || count > (data__->size() - pos__) / size) {
+            throw sf_serialize_binary_size_mismatch_exception("Data size is to small");
+        }
+        auto ret = data__->data() + pos__;
+        pos__ += count * size;
+        return ret;
+    }
+
+    template<typename _Pod_Type>
+    inline void sf_binary_cursor::read_pod(_Pod_Type &value) {
+        memcpy(&value, read(1, sizeof(_Pod_Type)), sizeof(_Pod_Type));
+    }
+
+    template<typename _Pod_Type>
+    inline void sf_binary_cursor::read_array(_Pod_Type *data, size_t count) {
+        sf_copy_binary_array__<_Pod_Type>(data, read(count, sizeof(_Pod_Type)), count, profile__);
+    }
+
+    template<typename _Pod_Type>
+    inline void sf_binary_cursor::read_scalar(_Pod_Type &value) {
+        if constexpr (sf_is_varint_scalar__<_Pod_Type>()) {
+            if (profile__ == sf_binary_profile::compact) {
+                if (!sf_varint_to_scalar__(read_varint(), value)) {
+                    throw sf_serialize_binary_size_mismatch_exception("Varint out of range");
+                }
+                return;
+            }
+        }
+        read_pod(value);
+        if constexpr (sf_is_byte_order_scalar__<_Pod_Type>()) {
+            if (profile__ == sf_binary_profile::portable) {
+                value = sf_byte_swap(value);
+            }
+        }
+    }
+
+    inline size_t sf_binary_cursor::read_size() {
+        if (profile__ == sf_binary_profile::portable) {
+            unsigned long long len;
+            read_scalar(len);
+            if (len > std::numeric_limits<size_t>::max()) {
+                throw sf_serialize_binary_size_mismatch_exception("Size out of range");
+            }
+            return static_cast<size_t>(len);
+        }
+        size_t ret;
+        read_scalar(ret);
+        return ret;
+    }
+
+    inline unsigned long long sf_binary_cursor::read_varint() {
+        auto p = data__->data() + pos__;
+        auto left = remaining();
+        // NOTE 大部分长度与小整数只有一个字节
+        if (left != 0 && static_cast<unsigned char>(p[0]) < 0x80) {
+            ++pos__;
+            return static_cast<unsigned char>(p[0]);
+        }
+        unsigned long long ret;
+        auto len = sf_decode_varint__(p, left, ret);
+        if (len <= 0) {
+            throw sf_serialize_binary_size_mismatch_exception(len == 0 ? "Data size is to small" : "Varint overflow");
+        }
+        pos__ += len;
+        return ret;
+    }
+
+    inline sf_binary_reader::sf_binary_reader(sf_binary_profile profile) : profile__(profile) {
+    }
+
+    inline void sf_binary_reader::feed(const char *data, size_t size) {
+        // NOTE 已读取的数据不少于一半时才丢弃，丢弃的次数与数据总量成对数关系
+        if (pos__ != 0 && pos__ * 2 >= buffer__.size()) {
+            buffer__.erase(buffer__.begin(), buffer__.begin() + pos__);
+            pos__ = 0;
+        }
+        buffer__.insert(buffer__.end(), data, data + size);
+    }
+
+    inline void sf_binary_reader::feed(const byte_array &data) {
+        feed(data.data(), data.size());
+    }
+
+    template<typename _Type>
+    inline sf_binary_read_status sf_binary_reader::read(_Type &obj) {
+        depth__ = 0;
+        auto ret = sf_deserialize_binary_step(*this, obj);
+        if (ret != sf_binary_read_status::need_more) {
+            frames__.clear();
+        }
+        return ret;
+    }
+
+    inline size_t sf_binary_reader::buffered() const {
+        return buffer__.size() - pos__;
+    }
+
+    inline sf_binary_profile sf_binary_reader::profile() const {
+        return profile__;
+    }
+
+    inline void sf_binary_reader::reset() {
+        buffer__.clear();
+        pos__ = 0;
+        frames__.clear();
+        depth__ = 0;
+    }
+
+    inline const char *sf_binary_reader::peek() const {
+        return buffer__.data() + pos__;
+    }
+
+    inline void sf_binary_reader::skip(size_t size) {
+        pos__ += size;
+    }
+
+    template<typename _Pod_Type>
+    inline sf_binary_read_status sf_binary_reader::read_scalar(_Pod_Type &value) {
+        if constexpr (sf_is_varint_scalar__<_Pod_Type>()) {
+            if (profile__ == sf_binary_profile::compact) {
+                unsigned long long raw;
+                auto len = sf_decode_varint__(peek(), buffered(), raw);
+                if (len == 0) {
+                    return sf_binary_read_status::need_more;
+                }
+                if (len < 0 || !sf_varint_to_scalar__(raw, value)) {
+                    return sf_binary_read_status::error;
+                }
+                pos__ += len;
+                return sf_binary_read_status::done;
+            }
+        }
+        if (buffered() < sizeof(_Pod_Type)) {
+            return sf_binary_read_status::need_more;
+        }
+        memcpy(&value, peek(), sizeof(_Pod_Type));
+        pos__ += sizeof(_Pod_Type);
+        if constexpr (sf_is_byte_order_scalar__<_Pod_Type>()) {
+            if (profile__ == sf_binary_profile::portable) {
+                value = sf_byte_swap(value);
+            }
+        }
+        return sf_binary_read_status::done;
+    }
+
+    inline sf_binary_read_status sf_binary_reader::read_size(size_t &size) {
+        if (profile__ == sf_binary_profile::portable) {
+            unsigned long long len;
+            auto status = read_scalar(len);
+            if (status == sf_binary_read_status::done && len > std::numeric_limits<size_t>::max()) {
+                return sf_binary_read_status::error;
+            }
+            size = static_cast<size_t>(len);
+            return status;
+        }
+        return read_scalar(size);
+    }
+
+    inline size_t sf_binary_reader::enter() {
+        if (depth__ == frames__.size()) {
+            frames__.emplace_back();
+        }
+        return depth__++;
+    }
+
+    inline sf_binary_reader_frame_t &sf_binary_reader::frame(size_t level) {
+        return frames__[level];
+    }
+
+    inline void sf_binary_reader::leave(size_t level) {
+        frames__.resize(level);
+        depth__ = level;
+    }
+
+    /**
+     * 使用sf_binary_writer序列化为byte_array（一次序列化只使用一个缓冲区）
+     */
+    template<typename... _Type>
+    inline byte_array sf_serialize_binary_by_writer__(const _Type &... value) {
+        sf_binary_writer writer;
+        (sf_serialize_binary_to(writer, value), ...);
+        return std::move(writer.buffer());
+    }
+
+    template<typename _Buffer, typename _Type>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer, const _Type &value) {
+        if constexpr (std::is_pod<_Type>::value) {
+            writer.write_scalar(value);
+        } else {
+            auto data = sf_serialize_binary(value);
+            writer.write(data.data(), data.size());
+        }
+    }
+
+    /**
+     * 序列化长度与区间内的每个元素
+     */
+    template<typename _Buffer, typename _Iter>
+    void sf_serialize_binary_range_to__(sf_basic_binary_writer<_Buffer> &writer, size_t len, _Iter begin, _Iter end) {
+        writer.write_size(len);
+        for (; begin != end; ++begin) {
+            sf_serialize_binary_to(writer, *begin);
+        }
+    }
+
+    template<typename _Buffer, typename _Type>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer, const std::vector<_Type> &value) {
+        if constexpr (sf_is_trivially_serializable<_Type>::value && !std::is_same<_Type, bool>::value) {
+            if (writer.profile() != sf_binary_profile::compact || !sf_is_varint_serializable<_Type>::value) {
+                writer.write_size(value.size());
+                writer.write_array(value.data(), value.size());
+                return;
+            }
+        }
+        sf_serialize_binary_range_to__(writer, value.size(), value.begin(), value.end());
+    }
+
+    template<typename _Buffer, typename _Type, size_t N>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer, const std::array<_Type, N> &value) {
+        // NOTE pod数组与其他pod类型相同，直接写入内存内容（没有长度），其他数组依次写入每个元素
+        if constexpr (std::is_pod<std::array<_Type, N>>::value) {
+            if (writer.profile() != sf_binary_profile::compact || !sf_is_varint_serializable<_Type>::value) {
+                writer.write_array(value.data(), N);
+                return;
+            }
+        }
+        for (auto &p : value) {
+            sf_serialize_binary_to(writer, p);
+        }
+    }
+
+    template<typename _Buffer, typename _Type>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer, const std::list<_Type> &value) {
+        sf_serialize_binary_range_to__(writer, value.size(), value.begin(), value.end());
+    }
+
+    template<typename _Buffer, typename _Type>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer, const std::deque<_Type> &value) {
+        sf_serialize_binary_range_to__(writer, value.size(), value.begin(), value.end());
+    }
+
+    template<typename _Buffer, typename _Type>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer, const std::set<_Type> &value) {
+        sf_serialize_binary_range_to__(writer, value.size(), value.begin(), value.end());
+    }
+
+    template<typename _Buffer, typename _Type>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer, const std::unordered_set<_Type> &value) {
+        sf_serialize_binary_range_to__(writer, value.size(), value.begin(), value.end());
+    }
+
+    template<typename _Buffer, typename _Type>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer, const std::multiset<_Type> &value) {
+        sf_serialize_binary_range_to__(writer, value.size(), value.begin(), value.end());
+    }
+
+    template<typename _Buffer, typename _Type>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer, const std::basic_string<_Type> &value) {
+        // NOTE 与byte_array布局相同，每个字符按char写入
+        writer.write_size(value.size());
+        if constexpr (sizeof(_Type) == 1) {
+            writer.write(value.data(), value.size());
+        } else {
+            for (auto c : value) {
+                writer.write_pod(static_cast<char>(c));
+            }
+        }
+    }
+
+    template<typename _Buffer, typename _Type>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer, const std::unordered_multiset<_Type> &value) {
+        sf_serialize_binary_range_to__(writer, value.size(), value.begin(), value.end());
+    }
+
+    /**
+     * 序列化长度与区间内的每个键值对
+     */
+    template<typename _Buffer, typename _Iter>
+    void sf_serialize_binary_pair_range_to__(sf_basic_binary_writer<_Buffer> &writer, size_t len, _Iter begin,
+                                             _Iter end) {
+        writer.write_size(len);
+        for (; begin != end; ++begin) {
+            sf_serialize_binary_to(writer, begin->first);
+            sf_serialize_binary_to(writer, begin->second);
+        }
+    }
+
+    template<typename _Buffer, typename _TypeKey, typename _TypeValue>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer,
+                                const std::unordered_multimap<_TypeKey, _TypeValue> &obj) {
+        sf_serialize_binary_pair_range_to__(writer, obj.size(), obj.begin(), obj.end());
+    }
+
+    template<typename _Buffer, typename _TypeKey, typename _TypeValue>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer,
+                                const std::unordered_map<_TypeKey, _TypeValue> &obj) {
+        sf_serialize_binary_pair_range_to__(writer, obj.size(), obj.begin(), obj.end());
+    }
+
+    template<typename _Buffer, typename _TypeKey, typename _TypeValue>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer,
+                                const std::multimap<_TypeKey, _TypeValue> &obj) {
+        sf_serialize_binary_pair_range_to__(writer, obj.size(), obj.begin(), obj.end());
+    }
+
+    template<typename _Buffer, typename _TypeKey, typename _TypeValue>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer, const std::map<_TypeKey, _TypeValue> &obj) {
+        sf_serialize_binary_pair_range_to__(writer, obj.size(), obj.begin(), obj.end());
+    }
+
+    template<typename _Buffer, typename... _Types>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer, const std::tuple<_Types...> &obj) {
+        std::apply([&writer](const _Types &... value) {
+            (sf_serialize_binary_to(writer, value), ...);
+        }, obj);
+    }
+
+    template<typename _Buffer>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer, const std::string_view &value) {
+        writer.write_size(value.size());
+        writer.write(value.data(), value.size());
+    }
+
+    template<typename _Buffer>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer, const sf_byte_view &value) {
+        writer.write_size(value.size());
+        writer.write(value.data(), value.size());
+    }
+
+    template<typename _Buffer, typename _Type>
+    void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer, const sf_vector_view<_Type> &value) {
+        if (!sf_is_binary_raw__<_Type>(writer.profile())) {
+            sf_serialize_binary_range_to__(writer, value.size(), value.begin(), value.end());
+            return;
+        }
+        auto bytes = value.bytes();
+        writer.write_size(value.size());
+        writer.write(bytes.data(), bytes.size());
+    }
+
+    template<typename _Buffer, typename... _Type>
+    void sf_serialize_binary_obj_to_helper(sf_basic_binary_writer<_Buffer> &writer, const _Type &... obj) {
+        (sf_serialize_binary_to(writer, obj), ...);
+    }
+
+    template<typename _Type>
+    constexpr size_t sf_serialized_size(const _Type &value) {
+        if constexpr (std::is_pod<_Type>::value) {
+            return sizeof(_Type);
+        } else {
+            return sf_serialize_binary(value).size();
+        }
+    }
+
+    /**
+     * 长度与区间内每个元素的序列化长度之和
+     */
+    template<typename _Iter>
+    size_t sf_serialized_range_size__(size_t len, _Iter begin, _Iter end) {
+        using value_type = typename std::iterator_traits<_Iter>::value_type;
+        if constexpr (sf_is_trivially_serializable<value_type>::value) {
+            return sizeof(size_t) + len * sizeof(value_type);
+        } else {
+            size_t size = sizeof(size_t);
+            for (; begin != end; ++begin) {
+                size += sf_serialized_size(*begin);
+            }
+            return size;
+        }
+    }
+
+    template<typename _Type>
+    size_t sf_serialized_size(const std::vector<_Type> &value) {
+        return sf_serialized_range_size__(value.size(), value.begin(), value.end());
+    }
+
+    template<typename _Type, size_t N>
+    constexpr size_t sf_serialized_size(const std::array<_Type, N> &value) {
+        if constexpr (std::is_pod<std::array<_Type, N>>::value) {
+            return sizeof(value);
+        } else {
+            size_t size = 0;
+            for (auto &p : value) {
+                size += sf_serialized_size(p);
+            }
+            return size;
+        }
+    }
+
+    template<typename _Type>
+    size_t sf_serialized_size(const std::list<_Type> &value) {
+        return sf_serialized_range_size__(value.size(), value.begin(), value.end());
+    }
+
+    template<typename _Type>
+    size_t sf_serialized_size(const std::deque<_Type> &value) {
+        return sf_serialized_range_size__(value.size(), value.begin(), value.end());
+    }
+
+    template<typename _Type>
+    size_t sf_serialized_size(const std::set<_Type> &value) {
+        return sf_serialized_range_size__(value.size(), value.begin(), value.end());
+    }
+
+    template<typename _Type>
+    size_t sf_serialized_size(const std::unordered_set<_Type> &value) {
+        return sf_serialized_range_size__(value.size(), value.begin(), value.end());
+    }
+
+    template<typename _Type>
+    size_t sf_serialized_size(const std::multiset<_Type> &value) {
+        return sf_serialized_range_size__(value.size(), value.begin(), value.end());
+    }
+
+    template<typename _Type>
+    size_t sf_serialized_size(const std::basic_string<_Type> &value) {
+        // NOTE 每个字符按char写入
+        return sizeof(size_t) + value.size();
+    }
+
+    template<typename _Type>
+    size_t sf_serialized_size(const std::unordered_multiset<_Type> &value) {
+        return sf_serialized_range_size__(value.size(), value.begin(), value.end());
+    }
+
+    /**
+     * 长度与区间内每个键值对的序列化长度之和
+     */
+    template<typename _Iter>
+    size_t sf_serialized_pair_range_size__(_Iter begin, _Iter end) {
+        size_t size = sizeof(size_t);
+        for (; begin != end; ++begin) {
+            size += sf_serialized_size(begin->first) + sf_serialized_size(begin->second);
+        }
+        return size;
+    }
+
+    template<typename _TypeKey, typename _TypeValue>
+    size_t sf_serialized_size(const std::unordered_multimap<_TypeKey, _TypeValue> &obj) {
+        return sf_serialized_pair_range_size__(obj.begin(), obj.end());
+    }
+
+    template<typename _TypeKey, typename _TypeValue>
+    size_t sf_serialized_size(const std::unordered_map<_TypeKey, _TypeValue> &obj) {
+        return sf_serialized_pair_range_size__(obj.begin(), obj.end());
+    }
+
+    template<typename _TypeKey, typename _TypeValue>
+    size_t sf_serialized_size(const std::multimap<_TypeKey, _TypeValue> &obj) {
+        return sf_serialized_pair_range_size__(obj.begin(), obj.end());
+    }
+
+    template<typename _TypeKey, typename _TypeValue>
+    size_t sf_serialized_size(const std::map<_TypeKey, _TypeValue> &obj) {
+        return sf_serialized_pair_range_size__(obj.begin(), obj.end());
+    }
+
+    template<typename... _Types>
+    constexpr size_t sf_serialized_size(const std::tuple<_Types...> &obj) {
+        return std::apply([](const _Types &... value) {
+            return sf_serialized_size_obj_helper(value...);
+        }, obj);
+    }
+
+    inline size_t sf_serialized_size(const std::string_view &value) {
+        return sizeof(size_t) + value.size();
+    }
+
+    inline size_t sf_serialized_size(const sf_byte_view &value) {
+        return sizeof(size_t) + value.size();
+    }
+
+    template<typename _Type>
+    size_t sf_serialized_size(const sf_vector_view<_Type> &value) {
+        return sizeof(size_t) + value.size() * sizeof(_Type);
+    }
+
+    template<typename... _Type>
+    constexpr size_t sf_serialized_size_obj_helper(const _Type &... obj) {
+        return (size_t{0} + ... + sf_serialized_size(obj));
+    }
+
     template<typename _Pod_Type>
     typename std::enable_if<std::is_pod<_Pod_Type>::value, byte_array>::type
     sf_serialize_binary(const _Pod_Type &value) {
         byte_array ret(sizeof(_Pod_Type));
-        auto p = reinterpret_cast<const char *>(&value);
         memcpy(ret.data(), &value, sizeof(_Pod_Type));
         return ret;
     }
 
+    /**
+     * 检查从指定位置开始是否还有count个size大小的元素
+     */
+    inline void sf_check_binary_size__(const byte_array &data, size_t begin_pos, size_t count, size_t size) {
+        if (begin_pos > data.size() || count > (data.size() - begin_pos) / size) {
+            throw sf_serialize_binary_size_mismatch_exception("Data size is to small");
+        }
+    }
+
     template<typename _Pod_Type>
     typename std::enable_if<std::is_pod<_Pod_Type>::value, size_t>::type
     sf_deserialize_binary(const byte_array &data, _Pod_Type &obj, size_t begin_pos) {
-        if (sizeof(_Pod_Type) > data.size() - begin_pos) {
-            throw sf_serialize_binary_size_mismatch_exception("Data size is to small");
-        }
+        sf_check_binary_size__(data, begin_pos, 1, sizeof(_Pod_Type));
         memcpy(&obj, data.data() + begin_pos, sizeof(_Pod_Type));
         return begin_pos + sizeof(_Pod_Type);
     }
 
     template<typename _Type>
-    byte_array sf_serialize_binary(const std::vector<_Type> &value) {
-        byte_array ret;
-        size_t len = value.size();
-        auto tmp_ret = sf_serialize_binary(len);
-        ret.insert(ret.end(), tmp_ret.begin(), tmp_ret.end());
-        for (auto const &p : value) {
-            tmp_ret = sf_serialize_binary(p);
-            ret.insert(ret.end(), tmp_ret.begin(), tmp_ret.end());
+    size_t sf_deserialize_binary_by_cursor__(const byte_array &data, _Type &obj, size_t begin_pos) {
+        sf_binary_cursor cursor(data, begin_pos);
+        sf_deserialize_binary_from(cursor, obj);
+        return cursor.pos();
+    }
+
+    template<typename _Type>
+    void sf_deserialize_binary_from(sf_binary_cursor &cursor, _Type &obj) {
+        if constexpr (std::is_pod<_Type>::value) {
+            cursor.read_scalar(obj);
+        } else {
+            // NOTE 只提供sf_deserialize_binary的类型，序列化时也是按native方式写入的
+            cursor.seek(sf_deserialize_binary(cursor.data(), obj, cursor.pos()));
+        }
+    }
+
+    /**
+     * 读取长度与每个元素，依次插入到容器末尾
+     */
+    template<typename _Container>
+    void sf_deserialize_binary_range_from__(sf_binary_cursor &cursor, _Container &obj) {
+        obj.clear();
+        auto len = cursor.read_size();
+        for (size_t i = 0; i < len; ++i) {
+            typename _Container::value_type tmp;
+            sf_deserialize_binary_from(cursor, tmp);
+            obj.insert(obj.end(), std::move(tmp));
+        }
+    }
+
+    /**
+     * 读取长度与每个键值对
+     */
+    template<typename _TypeKey, typename _TypeValue, typename _Container>
+    void sf_deserialize_binary_pair_range_from__(sf_binary_cursor &cursor, _Container &obj) {
+        obj.clear();
+        auto len = cursor.read_size();
+        for (size_t i = 0; i < len; ++i) {
+            _TypeKey key;
+            _TypeValue value;
+            sf_deserialize_binary_from(cursor, key);
+            sf_deserialize_binary_from(cursor, value);
+            obj.emplace_hint(obj.end(), std::move(key), std::move(value));
         }
-        return ret;
     }
 
     template<typename _Type>
-    size_t sf_deserialize_binary(const byte_array &data, std::vector<_Type> &obj,
-                                 size_t begin_pos) {
+    void sf_deserialize_binary_from(sf_binary_cursor &cursor, std::vector<_Type> &obj) {
+        auto len = cursor.read_size();
+        if constexpr (sf_is_trivially_serializable<_Type>::value && !std::is_same<_Type, bool>::value) {
+            if (cursor.profile() != sf_binary_profile::compact || !sf_is_varint_serializable<_Type>::value) {
+                auto p = cursor.read(len, sizeof(_Type));
+                obj.resize(len);
+                if (len != 0) {
+                    sf_copy_binary_array__<_Type>(obj.data(), p, len, cursor.profile());
+                }
+                return;
+            }
+        }
         obj.clear();
+        // NOTE 长度来自数据，预分配不超过剩余字节数，避免错误数据导致过大的分配
+        obj.reserve(std::min(len, cursor.remaining()));
+        for (size_t i = 0; i < len; ++i) {
+            _Type tmp;
+            sf_deserialize_binary_from(cursor, tmp);
+            obj.push_back(std::move(tmp));
+        }
+    }
+
+    template<typename _Type, size_t N>
+    void sf_deserialize_binary_from(sf_binary_cursor &cursor, std::array<_Type, N> &obj) {
+        if constexpr (std::is_pod<std::array<_Type, N>>::value) {
+            if (cursor.profile() != sf_binary_profile::compact || !sf_is_varint_serializable<_Type>::value) {
+                cursor.read_array(obj.data(), N);
+                return;
+            }
+        }
+        for (auto &p : obj) {
+            sf_deserialize_binary_from(cursor, p);
+        }
+    }
+
+    template<typename _Type>
+    void sf_deserialize_binary_from(sf_binary_cursor &cursor, std::list<_Type> &obj) {
+        sf_deserialize_binary_range_from__(cursor, obj);
+    }
+
+    template<typename _Type>
+    void sf_deserialize_binary_from(sf_binary_cursor &cursor, std::deque<_Type> &obj) {
+        sf_deserialize_binary_range_from__(cursor, obj);
+    }
+
+    template<typename _Type>
+    void sf_deserialize_binary_from(sf_binary_cursor &cursor, std::set<_Type> &obj) {
+        sf_deserialize_binary_range_from__(cursor, obj);
+    }
+
+    template<typename _Type>
+    void sf_deserialize_binary_from(sf_binary_cursor &cursor, std::unordered_set<_Type> &obj) {
+        sf_deserialize_binary_range_from__(cursor, obj);
+    }
+
+    template<typename _Type>
+    void sf_deserialize_binary_from(sf_binary_cursor &cursor, std::multiset<_Type> &obj) {
+        sf_deserialize_binary_range_from__(cursor, obj);
+    }
+
+    template<typename _Type>
+    void sf_deserialize_binary_from(sf_binary_cursor &cursor, std::basic_string<_Type> &obj) {
+        auto len = cursor.read_size();
+        auto p = cursor.read(len, 1);
+        if constexpr (sizeof(_Type) == 1) {
+            obj.assign(reinterpret_cast<const _Type *>(p), len);
+        } else {
+            obj.assign(p, p + len);
+        }
+    }
+
+    template<typename _Type>
+    void sf_deserialize_binary_from(sf_binary_cursor &cursor, std::unordered_multiset<_Type> &obj) {
+        sf_deserialize_binary_range_from__(cursor, obj);
+    }
+
+    template<typename _TypeKey, typename _TypeValue>
+    void sf_deserialize_binary_from(sf_binary_cursor &cursor, std::unordered_multimap<_TypeKey, _TypeValue> &obj) {
+        sf_deserialize_binary_pair_range_from__<_TypeKey, _TypeValue>(cursor, obj);
+    }
+
+    template<typename _TypeKey, typename _TypeValue>
+    void sf_deserialize_binary_from(sf_binary_cursor &cursor, std::unordered_map<_TypeKey, _TypeValue> &obj) {
+        sf_deserialize_binary_pair_range_from__<_TypeKey, _TypeValue>(cursor, obj);
+    }
+
+    template<typename _TypeKey, typename _TypeValue>
+    void sf_deserialize_binary_from(sf_binary_cursor &cursor, std::multimap<_TypeKey, _TypeValue> &obj) {
+        sf_deserialize_binary_pair_range_from__<_TypeKey, _TypeValue>(cursor, obj);
+    }
+
+    template<typename _TypeKey, typename _TypeValue>
+    void sf_deserialize_binary_from(sf_binary_cursor &cursor, std::map<_TypeKey, _TypeValue> &obj) {
+        sf_deserialize_binary_pair_range_from__<_TypeKey, _TypeValue>(cursor, obj);
+    }
+
+    template<typename... _Types>
+    void sf_deserialize_binary_from(sf_binary_cursor &cursor, std::tuple<_Types...> &obj) {
+        std::apply([&cursor](_Types &... value) {
+            (sf_deserialize_binary_from(cursor, value), ...);
+        }, obj);
+    }
+
+    inline void sf_deserialize_binary_from(sf_binary_cursor &cursor, std::string_view &obj) {
+        auto len = cursor.read_size();
+        obj = std::string_view(cursor.read(len, 1), len);
+    }
+
+    inline void sf_deserialize_binary_from(sf_binary_cursor &cursor, sf_byte_view &obj) {
+        auto len = cursor.read_size();
+        obj = sf_byte_view(cursor.read(len, 1), len);
+    }
+
+    template<typename _Type>
+    void sf_deserialize_binary_from(sf_binary_cursor &cursor, sf_vector_view<_Type> &obj) {
+        if (!sf_is_binary_raw__<_Type>(cursor.profile())) {
+            throw sf_serialize_binary_size_mismatch_exception("Elements can not be viewed in this profile");
+        }
+        auto len = cursor.read_size();
+        obj = sf_vector_view<_Type>(cursor.read(len, sizeof(_Type)), len);
+    }
+
+    template<typename... _Type>
+    void sf_deserialize_binary_obj_from_helper(sf_binary_cursor &cursor, _Type &... obj) {
+        (sf_deserialize_binary_from(cursor, obj), ...);
+    }
+
+    template<typename _Type>
+    bool sf_try_deserialize_binary_from(sf_binary_cursor &cursor, _Type &obj) {
+        try {
+            sf_deserialize_binary_from(cursor, obj);
+        } catch (const sf_serialize_binary_size_mismatch_exception &) {
+            return false;
+        }
+        return true;
+    }
+
+    template<typename _Type>
+    sf_binary_read_status sf_deserialize_binary_step(sf_binary_reader &reader, _Type &obj) {
+        static_assert(std::is_pod<_Type>::value, "Type does not support incremental deserialization");
+        return reader.read_scalar(obj);
+    }
+
+    /**
+     * 读取当前层的容器长度（已读取时直接返回）
+     */
+    template<typename _Container>
+    sf_binary_read_status sf_deserialize_binary_size_step__(sf_binary_reader &reader, size_t level, _Container &obj) {
+        if (reader.frame(level).has_size) {
+            return sf_binary_read_status::done;
+        }
         size_t len;
-        auto offset = sf_deserialize_binary(data, len, begin_pos);
-        obj.resize(len);
-        for (auto i = 0; i < len; ++i) {
-            offset = sf_deserialize_binary(data, obj[i], offset);
+        auto status = reader.read_size(len);
+        if (status != sf_binary_read_status::done) {
+            return status;
+        }
+        obj.clear();
+        reader.frame(level).size = len;
+        reader.frame(level).has_size = true;
+        return sf_binary_read_status::done;
+    }
+
+    /**
+     * 依次读取元组（或std::pair、结构成员）中从当前进度开始的元素
+     */
+    template<size_t I, typename _Tuple>
+    sf_binary_read_status sf_deserialize_binary_members_step__(sf_binary_reader &reader, size_t level, _Tuple &obj) {
+        if constexpr (I == std::tuple_size<_Tuple>::value) {
+            return sf_binary_read_status::done;
+        } else {
+            if (reader.frame(level).index == I) {
+                auto status = sf_deserialize_binary_step(reader, std::get<I>(obj));
+                if (status != sf_binary_read_status::done) {
+                    return status;
+                }
+                ++reader.frame(level).index;
+            }
+            return sf_deserialize_binary_members_step__<I + 1>(reader, level, obj);
+        }
+    }
+
+    template<typename _Tuple>
+    sf_binary_read_status sf_deserialize_binary_tuple_step__(sf_binary_reader &reader, _Tuple &obj) {
+        auto level = reader.enter();
+        auto status = sf_deserialize_binary_members_step__<0>(reader, level, obj);
+        if (status == sf_binary_read_status::done) {
+            reader.leave(level);
+        }
+        return status;
+    }
+
+    /**
+     * 读取不能在容器中直接修改的元素（先读取到临时对象再插入，暂停时临时对象保存在读取进度中）
+     */
+    template<typename _Value, typename _Container, typename _Insert, typename _Step>
+    sf_binary_read_status sf_deserialize_binary_range_step__(sf_binary_reader &reader, _Container &obj,
+                                                             _Insert insert, _Step step) {
+        auto level = reader.enter();
+        auto status = sf_deserialize_binary_size_step__(reader, level, obj);
+        if (status != sf_binary_read_status::done) {
+            return status;
+        }
+        while (reader.frame(level).index < reader.frame(level).size) {
+            _Value value;
+            auto &element = reader.frame(level).element;
+            if (element) {
+                value = std::move(*static_cast<_Value *>(element.get()));
+                element.reset();
+            }
+            status = step(reader, value);
+            if (status != sf_binary_read_status::done) {
+                reader.frame(level).element = std::make_shared<_Value>(std::move(value));
+                return status;
+            }
+            insert(std::move(value));
+            ++reader.frame(level).index;
+        }
+        reader.leave(level);
+        return sf_binary_read_status::done;
+    }
+
+    template<typename _Container>
+    sf_binary_read_status sf_deserialize_binary_insert_step__(sf_binary_reader &reader, _Container &obj) {
+        using value_type = typename _Container::value_type;
+        return sf_deserialize_binary_range_step__<value_type>(reader, obj, [&obj](value_type &&value) {
+            obj.insert(obj.end(), std::move(value));
+        }, [](sf_binary_reader &r, value_type &value) {
+            return sf_deserialize_binary_step(r, value);
+        });
+    }
+
+    template<typename _TypeKey, typename _TypeValue, typename _Container>
+    sf_binary_read_status sf_deserialize_binary_map_step__(sf_binary_reader &reader, _Container &obj) {
+        using value_type = std::pair<_TypeKey, _TypeValue>;
+        return sf_deserialize_binary_range_step__<value_type>(reader, obj, [&obj](value_type &&value) {
+            obj.emplace_hint(obj.end(), std::move(value.first), std::move(value.second));
+        }, [](sf_binary_reader &r, value_type &value) {
+            return sf_deserialize_binary_tuple_step__(r, value);
+        });
+    }
+
+    template<typename _Type>
+    sf_binary_read_status sf_deserialize_binary_step(sf_binary_reader &reader, std::vector<_Type> &obj) {
+        if constexpr (std::is_same<_Type, bool>::value) {
+            return sf_deserialize_binary_insert_step__(reader, obj);
+        } else {
+            auto level = reader.enter();
+            auto status = sf_deserialize_binary_size_step__(reader, level, obj);
+            if (status != sf_binary_read_status::done) {
+                return status;
+            }
+            if constexpr (sf_is_trivially_serializable<_Type>::value) {
+                if (reader.profile() != sf_binary_profile::compact || !sf_is_varint_serializable<_Type>::value) {
+                    // NOTE 每次复制当前已到达的所有完整元素
+                    auto &frame = reader.frame(level);
+                    auto count = std::min(frame.size - frame.index, reader.buffered() / sizeof(_Type));
+                    obj.resize(frame.index + count);
+                    if (count != 0) {
+                        sf_copy_binary_array__<_Type>(obj.data() + frame.index, reader.peek(), count, reader.profile());
+                    }
+                    reader.skip(count * sizeof(_Type));
+                    frame.index += count;
+                    if (frame.index < frame.size) {
+                        return sf_binary_read_status::need_more;
+                    }
+                    reader.leave(level);
+                    return sf_binary_read_status::done;
+                }
+            }
+            // NOTE 元素直接在容器中读取，暂停时未完成的元素保留在容器末尾
+            while (reader.frame(level).index < reader.frame(level).size) {
+                if (obj.size() == reader.frame(level).index) {
+                    obj.emplace_back();
+                }
+                status = sf_deserialize_binary_step(reader, obj.back());
+                if (status != sf_binary_read_status::done) {
+                    return status;
+                }
+                ++reader.frame(level).index;
+            }
+            reader.leave(level);
+            return sf_binary_read_status::done;
+        }
+    }
+
+    template<typename _Type, size_t N>
+    sf_binary_read_status sf_deserialize_binary_step(sf_binary_reader &reader, std::array<_Type, N> &obj) {
+        if constexpr (std::is_pod<std::array<_Type, N>>::value) {
+            if (reader.profile() != sf_binary_profile::compact || !sf_is_varint_serializable<_Type>::value) {
+                if (reader.buffered() < sizeof(obj)) {
+                    return sf_binary_read_status::need_more;
+                }
+                sf_copy_binary_array__<_Type>(obj.data(), reader.peek(), N, reader.profile());
+                reader.skip(sizeof(obj));
+                return sf_binary_read_status::done;
+            }
         }
-        return offset;
+        auto level = reader.enter();
+        while (reader.frame(level).index < N) {
+            auto status = sf_deserialize_binary_step(reader, obj[reader.frame(level).index]);
+            if (status != sf_binary_read_status::done) {
+                return status;
+            }
+            ++reader.frame(level).index;
+        }
+        reader.leave(level);
+        return sf_binary_read_status::done;
+    }
+
+    template<typename _Type>
+    sf_binary_read_status sf_deserialize_binary_step(sf_binary_reader &reader, std::list<_Type> &obj) {
+        return sf_deserialize_binary_insert_step__(reader, obj);
+    }
+
+    template<typename _Type>
+    sf_binary_read_status sf_deserialize_binary_step(sf_binary_reader &reader, std::deque<_Type> &obj) {
+        return sf_deserialize_binary_insert_step__(reader, obj);
+    }
+
+    template<typename _Type>
+    sf_binary_read_status sf_deserialize_binary_step(sf_binary_reader &reader, std::set<_Type> &obj) {
+        return sf_deserialize_binary_insert_step__(reader, obj);
+    }
+
+    template<typename _Type>
+    sf_binary_read_status sf_deserialize_binary_step(sf_binary_reader &reader, std::unordered_set<_Type> &obj) {
+        return sf_deserialize_binary_insert_step__(reader, obj);
+    }
+
+    template<typename _Type>
+    sf_binary_read_status sf_deserialize_binary_step(sf_binary_reader &reader, std::multiset<_Type> &obj) {
+        return sf_deserialize_binary_insert_step__(reader, obj);
+    }
+
+    template<typename _Type>
+    sf_binary_read_status sf_deserialize_binary_step(sf_binary_reader &reader, std::basic_string<_Type> &obj) {
+        auto level = reader.enter();
+        auto status = sf_deserialize_binary_size_step__(reader, level, obj);
+        if (status != sf_binary_read_status::done) {
+            return status;
+        }
+        auto &frame = reader.frame(level);
+        auto count = std::min(frame.size - frame.index, reader.buffered());
+        obj.append(reader.peek(), reader.peek() + count);
+        reader.skip(count);
+        frame.index += count;
+        if (frame.index < frame.size) {
+            return sf_binary_read_status::need_more;
+        }
+        reader.leave(level);
+        return sf_binary_read_status::done;
+    }
+
+    template<typename _Type>
+    sf_binary_read_status sf_deserialize_binary_step(sf_binary_reader &reader, std::unordered_multiset<_Type> &obj) {
+        return sf_deserialize_binary_insert_step__(reader, obj);
+    }
+
+    template<typename _TypeKey, typename _TypeValue>
+    sf_binary_read_status
+    sf_deserialize_binary_step(sf_binary_reader &reader, std::unordered_multimap<_TypeKey, _TypeValue> &obj) {
+        return sf_deserialize_binary_map_step__<_TypeKey, _TypeValue>(reader, obj);
+    }
+
+    template<typename _TypeKey, typename _TypeValue>
+    sf_binary_read_status
+    sf_deserialize_binary_step(sf_binary_reader &reader, std::unordered_map<_TypeKey, _TypeValue> &obj) {
+        return sf_deserialize_binary_map_step__<_TypeKey, _TypeValue>(reader, obj);
+    }
+
+    template<typename _TypeKey, typename _TypeValue>
+    sf_binary_read_status
+    sf_deserialize_binary_step(sf_binary_reader &reader, std::multimap<_TypeKey, _TypeValue> &obj) {
+        return sf_deserialize_binary_map_step__<_TypeKey, _TypeValue>(reader, obj);
+    }
+
+    template<typename _TypeKey, typename _TypeValue>
+    sf_binary_read_status sf_deserialize_binary_step(sf_binary_reader &reader, std::map<_TypeKey, _TypeValue> &obj) {
+        return sf_deserialize_binary_map_step__<_TypeKey, _TypeValue>(reader, obj);
+    }
+
+    template<typename... _Types>
+    sf_binary_read_status sf_deserialize_binary_step(sf_binary_reader &reader, std::tuple<_Types...> &obj) {
+        return sf_deserialize_binary_tuple_step__(reader, obj);
+    }
+
+    // NOTE 视图指向的数据在sf_binary_reader的缓冲区中，继续输入后会失效，增量反序列化不支持视图
+    inline sf_binary_read_status sf_deserialize_binary_step(sf_binary_reader &, std::string_view &) {
+        return sf_binary_read_status::error;
+    }
+
+    inline sf_binary_read_status sf_deserialize_binary_step(sf_binary_reader &, sf_byte_view &) {
+        return sf_binary_read_status::error;
+    }
+
+    template<typename _Type>
+    sf_binary_read_status sf_deserialize_binary_step(sf_binary_reader &, sf_vector_view<_Type> &) {
+        return sf_binary_read_status::error;
+    }
+
+    template<typename... _Type>
+    sf_binary_read_status sf_deserialize_binary_obj_step_helper(sf_binary_reader &reader, _Type &... obj) {
+        auto members = std::tie(obj...);
+        return sf_deserialize_binary_tuple_step__(reader, members);
+    }
+
+    template<typename _Type>
+    byte_array sf_serialize_binary(const std::vector<_Type> &value) {
+        return sf_serialize_binary_by_writer__(value);
+    }
+
+    template<typename _Type>
+    size_t sf_deserialize_binary(const byte_array &data, std::vector<_Type> &obj,
+                                 size_t begin_pos) {
+        return sf_deserialize_binary_by_cursor__(data, obj, begin_pos);
+    }
+
+    template<typename _Type, size_t N>
+    byte_array sf_serialize_binary(const std::array<_Type, N> &value) {
+        return sf_serialize_binary_by_writer__(value);
+    }
+
+    template<typename _Type, size_t N>
+    size_t sf_deserialize_binary(const byte_array &data, std::array<_Type, N> &obj, size_t begin_pos) {
+        return sf_deserialize_binary_by_cursor__(data, obj, begin_pos);
     }
 
     template<typename _Type>
     byte_array sf_serialize_binary(const std::list<_Type> &value) {
-        std::vector<_Type> tmp_obj(value.begin(), value.end());
-        return sf_serialize_binary(tmp_obj);
+        return sf_serialize_binary_by_writer__(value);
     }
 
     template<typename _Type>
     size_t sf_deserialize_binary(const byte_array &data, std::list<_Type> &obj,
                                  size_t begin_pos) {
-        std::vector<_Type> tmp_obj;
-        auto ret = sf_deserialize_binary(data, tmp_obj, begin_pos);
-        obj = std::list<_Type>(tmp_obj.begin(), tmp_obj.end());
-        return ret;
+        return sf_deserialize_binary_by_cursor__(data, obj, begin_pos);
     }
 
     template<typename _Type>
     byte_array sf_serialize_binary(const std::deque<_Type> &value) {
-        std::vector<_Type> tmp_obj(value.begin(), value.end());
-        return sf_serialize_binary(tmp_obj);
+        return sf_serialize_binary_by_writer__(value);
     }
 
     template<typename _Type>
     size_t sf_deserialize_binary(const byte_array &data, std::deque<_Type> &obj,
                                  size_t begin_pos) {
-        std::vector<_Type> tmp_obj;
-        auto ret = sf_deserialize_binary(data, tmp_obj, begin_pos);
-        obj = std::deque<_Type>(tmp_obj.begin(), tmp_obj.end());
-        return ret;
+        return sf_deserialize_binary_by_cursor__(data, obj, begin_pos);
     }
 
     template<typename _Type>
     byte_array sf_serialize_binary(const std::set<_Type> &value) {
-        std::vector<_Type> tmp_obj(value.begin(), value.end());
-        return sf_serialize_binary(tmp_obj);
+        return sf_serialize_binary_by_writer__(value);
     }
 
     template<typename _Type>
     size_t sf_deserialize_binary(const byte_array &data, std::set<_Type> &obj,
                                  size_t begin_pos) {
-        std::vector<_Type> tmp_obj;
-        auto ret = sf_deserialize_binary(data, tmp_obj, begin_pos);
-        obj = std::set<_Type>(tmp_obj.begin(), tmp_obj.end());
-        return ret;
+        return sf_deserialize_binary_by_cursor__(data, obj, begin_pos);
     }
 
     template<typename _Type>
     byte_array sf_serialize_binary(const std::unordered_set<_Type> &value) {
-        std::vector<_Type> tmp_obj(value.begin(), value.end());
-        return sf_serialize_binary(tmp_obj);
+        return sf_serialize_binary_by_writer__(value);
     }
 
     template<typename _Type>
     size_t sf_deserialize_binary(const byte_array &data, std::unordered_set<_Type> &obj,
                                  size_t begin_pos) {
-        std::vector<_Type> tmp_obj;
-        auto ret = sf_deserialize_binary(data, tmp_obj, begin_pos);
-        obj = std::unordered_set<_Type>(tmp_obj.begin(), tmp_obj.end());
-        return ret;
+        return sf_deserialize_binary_by_cursor__(data, obj, begin_pos);
     }
 
     template<typename _Type>
     byte_array sf_serialize_binary(const std::multiset<_Type> &value) {
-        std::vector<_Type> tmp_obj(value.begin(), value.end());
-        return sf_serialize_binary(tmp_obj);
+        return sf_serialize_binary_by_writer__(value);
     }
 
     template<typename _Type>
     size_t sf_deserialize_binary(const byte_array &data, std::multiset<_Type> &obj,
                                  size_t begin_pos) {
-        std::vector<_Type> tmp_obj;
-        auto ret = sf_deserialize_binary(data, tmp_obj, begin_pos);
-        obj = std::multiset<_Type>(tmp_obj.begin(), tmp_obj.end());
-        return ret;
+        return sf_deserialize_binary_by_cursor__(data, obj, begin_pos);
     }
 
     template<typename _Type>
     byte_array sf_serialize_binary(const std::basic_string<_Type> &value) {
-        std::vector<char> tmp_obj(value.begin(), value.end());
-        return sf_serialize_binary(tmp_obj);
+        return sf_serialize_binary_by_writer__(value);
     }
 
     template<typename _Type>
     size_t sf_deserialize_binary(const byte_array &data, std::basic_string<_Type> &obj,
                                  size_t begin_pos) {
-        std::vector<char> tmp_obj;
-        auto ret = sf_deserialize_binary(data, tmp_obj, begin_pos);
-        obj = std::basic_string<_Type>(tmp_obj.begin(), tmp_obj.end());
-        return ret;
+        return sf_deserialize_binary_by_cursor__(data, obj, begin_pos);
     }
 
     template<typename _Type>
     byte_array sf_serialize_binary(const std::unordered_multiset<_Type> &value) {
-        std::vector<_Type> tmp_obj(value.begin(), value.end());
-        return sf_serialize_binary(tmp_obj);
+        return sf_serialize_binary_by_writer__(value);
     }
 
     template<typename _Type>
     size_t sf_deserialize_binary(const byte_array &data, std::unordered_multiset<_Type> &obj,
                                  size_t begin_pos) {
-        std::vector<_Type> tmp_obj;
-        auto ret = sf_deserialize_binary(data, tmp_obj, begin_pos);
-        obj = std::unordered_multiset<_Type>(tmp_obj.begin(), tmp_obj.end());
-        return ret;
+        return sf_deserialize_binary_by_cursor__(data, obj, begin_pos);
     }
 
     template<typename _TypeKey, typename _TypeValue>
     byte_array sf_serialize_binary(const std::unordered_multimap<_TypeKey, _TypeValue> &obj) {
-        byte_array ret;
-        size_t len = obj.size();
-        auto tmp_ret = sf_serialize_binary(len);
-        ret.insert(ret.end(), tmp_ret.begin(), tmp_ret.end());
-        for (auto const &p : obj) {
-            tmp_ret = sf_serialize_binary(p.first);
-            ret.insert(ret.end(), tmp_ret.begin(), tmp_ret.end());
-            tmp_ret = sf_serialize_binary(p.second);
-            ret.insert(ret.end(), tmp_ret.begin(), tmp_ret.end());
-        }
-        return ret;
+        return sf_serialize_binary_by_writer__(obj);
     }
 
     template<typename _TypeKey, typename _TypeValue>
     size_t
     sf_deserialize_binary(const byte_array &data, std::unordered_multimap<_TypeKey, _TypeValue> &obj,
                           size_t begin_pos) {
-        obj.clear();
-        size_t len;
-        auto offset = sf_deserialize_binary(data, len, begin_pos);
-        _TypeKey key;
-        _TypeValue value;
-        for (auto i = 0; i < len; ++i) {
-            offset = sf_deserialize_binary(data, key, offset);
-            offset = sf_deserialize_binary(data, value, offset);
-            obj.insert({key, value});
-        }
-        return offset;
+        return sf_deserialize_binary_by_cursor__(data, obj, begin_pos);
     }
 
     template<typename _TypeKey, typename _TypeValue>
     byte_array sf_serialize_binary(const std::unordered_map<_TypeKey, _TypeValue> &obj) {
-        std::unordered_multimap<_TypeKey, _TypeValue> tmp_obj(obj.begin(), obj.end());
-        return sf_serialize_binary(tmp_obj);
+        return sf_serialize_binary_by_writer__(obj);
     }
 
     template<typename _TypeKey, typename _TypeValue>
     size_t
     sf_deserialize_binary(const byte_array &data, std::unordered_map<_TypeKey, _TypeValue> &obj,
                           size_t begin_pos) {
-        std::unordered_multimap<_TypeKey, _TypeValue> tmp_obj;
-        auto ret = sf_deserialize_binary(data, tmp_obj, begin_pos);
-        obj = std::unordered_map<_TypeKey, _TypeValue>(tmp_obj.begin(), tmp_obj.end());
-        return ret;
+        return sf_deserialize_binary_by_cursor__(data, obj, begin_pos);
     }
 
     template<typename _TypeKey, typename _TypeValue>
     byte_array sf_serialize_binary(const std::multimap<_TypeKey, _TypeValue> &obj) {
-        std::unordered_multimap<_TypeKey, _TypeValue> tmp_obj(obj.begin(), obj.end());
-        return sf_serialize_binary(tmp_obj);
+        return sf_serialize_binary_by_writer__(obj);
     }
 
     template<typename _TypeKey, typename _TypeValue>
     size_t
     sf_deserialize_binary(const byte_array &data, std::multimap<_TypeKey, _TypeValue> &obj,
                           size_t begin_pos) {
-        std::unordered_multimap<_TypeKey, _TypeValue> tmp_obj;
-        auto ret = sf_deserialize_binary(data, tmp_obj, begin_pos);
-        obj = std::multimap<_TypeKey, _TypeValue>(tmp_obj.begin(), tmp_obj.end());
-        return ret;
+        return sf_deserialize_binary_by_cursor__(data, obj, begin_pos);
     }
 
     template<typename _TypeKey, typename _TypeValue>
     byte_array sf_serialize_binary(const std::map<_TypeKey, _TypeValue> &obj) {
-        std::unordered_multimap<_TypeKey, _TypeValue> tmp_obj(obj.begin(), obj.end());
-        return sf_serialize_binary(tmp_obj);
+        return sf_serialize_binary_by_writer__(obj);
     }
 
     template<typename _TypeKey, typename _TypeValue>
     size_t
     sf_deserialize_binary(const byte_array &data, std::map<_TypeKey, _TypeValue> &obj,
                           size_t begin_pos) {
-        std::unordered_multimap<_TypeKey, _TypeValue> tmp_obj;
-        auto ret = sf_deserialize_binary(data, tmp_obj, begin_pos);
-        obj = std::map<_TypeKey, _TypeValue>(tmp_obj.begin(), tmp_obj.end());
-        return ret;
+        return sf_deserialize_binary_by_cursor__(data, obj, begin_pos);
     }
 
     template<typename _First_Type, typename... _Types>
     byte_array sf_serialize_binary(const _First_Type &first, const _Types &... value) {
-        return sf_serialize_binary(first) + sf_serialize_binary(value...);
+        return sf_serialize_binary_by_writer__(first, value...);
     }
 
     template<int N, typename... _Types>
@@ -283,7 +1548,7 @@ namespace skyfire {
 
     template<typename... _Types>
     byte_array sf_serialize_binary(const std::tuple<_Types...> &obj) {
-        return sf_serialize_binary_tuple<0, _Types...>(obj);
+        return sf_serialize_binary_by_writer__(obj);
     }
 
     template<int N, typename _Tuple_Type, typename... _Types>
@@ -312,16 +1577,38 @@ namespace skyfire {
 
     template<typename... _Types>
     size_t sf_deserialize_binary(const byte_array &data, std::tuple<_Types...> &obj, size_t begin_pos) {
-        if constexpr (sizeof...(_Types) == 0) {
-            return begin_pos;
-        } else {
-            return sf_deserialize_binary_tuple(begin_pos, data, obj);
-        }
+        return sf_deserialize_binary_by_cursor__(data, obj, begin_pos);
+    }
+
+    inline byte_array sf_serialize_binary(const std::string_view &value) {
+        return sf_serialize_binary_by_writer__(value);
+    }
+
+    inline size_t sf_deserialize_binary(const byte_array &data, std::string_view &obj, size_t begin_pos) {
+        return sf_deserialize_binary_by_cursor__(data, obj, begin_pos);
+    }
+
+    inline byte_array sf_serialize_binary(const sf_byte_view &value) {
+        return sf_serialize_binary_by_writer__(value);
+    }
+
+    inline size_t sf_deserialize_binary(const byte_array &data, sf_byte_view &obj, size_t begin_pos) {
+        return sf_deserialize_binary_by_cursor__(data, obj, begin_pos);
+    }
+
+    template<typename _Type>
+    byte_array sf_serialize_binary(const sf_vector_view<_Type> &value) {
+        return sf_serialize_binary_by_writer__(value);
+    }
+
+    template<typename _Type>
+    size_t sf_deserialize_binary(const byte_array &data, sf_vector_view<_Type> &obj, size_t begin_pos) {
+        return sf_deserialize_binary_by_cursor__(data, obj, begin_pos);
     }
 
     template<typename ... _Type>
     byte_array sf_serialize_binary_obj_helper(const _Type &... obj) {
-        return (sf_serialize_binary(obj) + ...);
+        return sf_serialize_binary_by_writer__(obj...);
     }
 
     template<typename T>
@@ -339,12 +1626,25 @@ namespace skyfire {
     //使一个结构变成可序列化的结构（需保证内部的每个成员都可以序列化，使用时需要注入到skyfire命名空间内部）
 
 #define SF_MAKE_SERIALIZABLE_BINARY(className, ...)                                                                            \
+    template<typename _Buffer>                                                                                          \
+    inline void sf_serialize_binary_to(sf_basic_binary_writer<_Buffer> &writer, const className &obj){                 \
+        sf_serialize_binary_obj_to_helper(writer, SF_EXPAND_OBJ_MEM(obj, __VA_ARGS__));                                  \
+    }                                                                                                                   \
+    inline size_t sf_serialized_size(const className &obj){                                                             \
+        return sf_serialized_size_obj_helper(SF_EXPAND_OBJ_MEM(obj, __VA_ARGS__));                                       \
+    }                                                                                                                   \
 inline byte_array sf_serialize_binary(const className& obj){                                                                  \
         return sf_serialize_binary_obj_helper(SF_EXPAND_OBJ_MEM(obj, __VA_ARGS__));                                            \
     }                                                                                                                   \
+    inline void sf_deserialize_binary_from(sf_binary_cursor &cursor, className &obj){                                   \
+        sf_deserialize_binary_obj_from_helper(cursor, SF_EXPAND_OBJ_MEM(obj, __VA_ARGS__));                              \
+    }                                                                                                                   \
+    inline sf_binary_read_status sf_deserialize_binary_step(sf_binary_reader &reader, className &obj){                \
+        return sf_deserialize_binary_obj_step_helper(reader, SF_EXPAND_OBJ_MEM(obj, __VA_ARGS__));                       \
+    }                                                                                                                   \
     inline size_t                                                                                                       \
     sf_deserialize_binary(const byte_array &data, className &obj, size_t begin_pos){                                           \
-        return sf_deserialize_binary_obj_helper(data, begin_pos, SF_EXPAND_OBJ_MEM(obj, __VA_ARGS__));                         \
+        return sf_deserialize_binary_by_cursor__(data, obj, begin_pos);                                                 \
     }                                                                                                                   \
 
 
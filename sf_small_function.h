@@ -0,0 +1,117 @@
+
+/**
+* @version 1.0.0
+* @author skyfire
+* @mail skyfireitdiy@hotmail.com
+* @see http://github.com/skyfireitdiy/sflib
+* @file sf_small_function.h
+
+* sflib第一版本发布
+* 版本号1.0.0
+* 发布日期：2018-10-22
+*/
+
+/*
+ * sf_small_function 小对象优化的只可移动函数对象
+ * 可调用对象不超过内联容量时直接存放在对象内部，不分配堆内存
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace skyfire
+{
+    /**
+     * 默认内联容量，可容纳一个shared_ptr加上（SOCKET, sf_pkg_header_t, byte_array）参数
+     */
+    constexpr size_t sf_small_function_inline_size = 64;
+
+    template<typename _Signature, size_t _InlineSize = sf_small_function_inline_size>
+    class sf_small_function;
+
+    /**
+     *  @brief 小对象优化的只可移动函数对象
+     *  @tparam _Ret 返回值类型
+     *  @tparam _Args 参数类型
+     *  @tparam _InlineSize 内联容量
+     */
+    template<typename _Ret, typename... _Args, size_t _InlineSize>
+    class sf_small_function<_Ret(_Args...), _InlineSize>
+    {
+    private:
+        struct sf_ops_t__
+        {
+            _Ret (*call)(void *, _Args &&...);
+            void (*move)(void *dst, void *src) noexcept;
+            void (*destroy)(void *) noexcept;
+        };
+
+        template<typename _Func>
+        static constexpr bool is_inline__ = sizeof(_Func) <= _InlineSize
+                                            && alignof(_Func) <= alignof(std::max_align_t)
+                                            && std::is_nothrow_move_constructible<_Func>::value;
+
+        template<typename _Func>
+        static _Ret call_inline__(void *storage, _Args &&... args);
+
+        template<typename _Func>
+        static void move_inline__(void *dst, void *src) noexcept;
+
+        template<typename _Func>
+        static void destroy_inline__(void *storage) noexcept;
+
+        template<typename _Func>
+        static _Ret call_heap__(void *storage, _Args &&... args);
+
+        static void move_heap__(void *dst, void *src) noexcept;
+
+        template<typename _Func>
+        static void destroy_heap__(void *storage) noexcept;
+
+        template<typename _Func>
+        static const sf_ops_t__ *get_ops__();
+
+        alignas(std::max_align_t) unsigned char storage__[_InlineSize];
+        const sf_ops_t__ *ops__ = nullptr;
+
+        void reset__() noexcept;
+
+    public:
+        sf_small_function() noexcept = default;
+
+        sf_small_function(std::nullptr_t) noexcept;
+
+        template<typename _Func, typename = std::enable_if_t<
+                !std::is_same<std::decay_t<_Func>, sf_small_function>::value
+                && !std::is_same<std::decay_t<_Func>, std::nullptr_t>::value>>
+        sf_small_function(_Func &&func);
+
+        sf_small_function(sf_small_function &&other) noexcept;
+
+        sf_small_function &operator=(sf_small_function &&other) noexcept;
+
+        sf_small_function &operator=(std::nullptr_t) noexcept;
+
+        sf_small_function(const sf_small_function &) = delete;
+
+        sf_small_function &operator=(const sf_small_function &) = delete;
+
+        ~sf_small_function();
+
+        /**
+         * 是否持有可调用对象
+         */
+        explicit operator bool() const noexcept;
+
+        /**
+         * 可调用对象是否内联存放（未分配堆内存）
+         */
+        bool is_inline() const noexcept;
+
+        _Ret operator()(_Args... args);
+    };
+}
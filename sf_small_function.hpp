@@ -0,0 +1,165 @@
+
+/**
+* @version 1.0.0
+* @author skyfire
+* @mail skyfireitdiy@hotmail.com
+* @see http://github.com/skyfireitdiy/sflib
+* @file sf_small_function.hpp
+
+* sflib第一版本发布
+* 版本号1.0.0
+* 发布日期：2018-10-22
+*/
+
+/*
+ * sf_small_function 小对象优化的只可移动函数对象
+ * 可调用对象不超过内联容量时直接存放在对象内部，不分配堆内存
+ */
+
+#pragma once
+
+#include "sf_small_function.h"
+
+namespace skyfire
+{
+    template<typename _Ret, typename... _Args, size_t _InlineSize>
+    template<typename _Func>
+    inline _Ret sf_small_function<_Ret(_Args...), _InlineSize>::call_inline__(void *storage, _Args &&... args) {
+        return (*static_cast<_Func *>(storage))(std::forward<_Args>(args)...);
+    }
+
+    template<typename _Ret, typename... _Args, size_t _InlineSize>
+    template<typename _Func>
+    inline void sf_small_function<_Ret(_Args...), _InlineSize>::move_inline__(void *dst, void *src) noexcept {
+        new(dst) _Func(std::move(*static_cast<_Func *>(src)));
+        static_cast<_Func *>(src)->~_Func();
+    }
+
+    template<typename _Ret, typename... _Args, size_t _InlineSize>
+    template<typename _Func>
+    inline void sf_small_function<_Ret(_Args...), _InlineSize>::destroy_inline__(void *storage) noexcept {
+        static_cast<_Func *>(storage)->~_Func();
+    }
+
+    template<typename _Ret, typename... _Args, size_t _InlineSize>
+    template<typename _Func>
+    inline _Ret sf_small_function<_Ret(_Args...), _InlineSize>::call_heap__(void *storage, _Args &&... args) {
+        return (**static_cast<_Func **>(storage))(std::forward<_Args>(args)...);
+    }
+
+    template<typename _Ret, typename... _Args, size_t _InlineSize>
+    inline void sf_small_function<_Ret(_Args...), _InlineSize>::move_heap__(void *dst, void *src) noexcept {
+        *static_cast<void **>(dst) = *static_cast<void **>(src);
+    }
+
+    template<typename _Ret, typename... _Args, size_t _InlineSize>
+    template<typename _Func>
+    inline void sf_small_function<_Ret(_Args...), _InlineSize>::destroy_heap__(void *storage) noexcept {
+        delete *static_cast<_Func **>(storage);
+    }
+
+    template<typename _Ret, typename... _Args, size_t _InlineSize>
+    template<typename _Func>
+    inline const typename sf_small_function<_Ret(_Args...), _InlineSize>::sf_ops_t__ *
+    sf_small_function<_Ret(_Args...), _InlineSize>::get_ops__() {
+        if constexpr (is_inline__<_Func>)
+        {
+            static constexpr sf_ops_t__ ops{&call_inline__<_Func>, &move_inline__<_Func>, &destroy_inline__<_Func>};
+            return &ops;
+        }
+        else
+        {
+            static constexpr sf_ops_t__ ops{&call_heap__<_Func>, &move_heap__, &destroy_heap__<_Func>};
+            return &ops;
+        }
+    }
+
+    template<typename _Ret, typename... _Args, size_t _InlineSize>
+    inline void sf_small_function<_Ret(_Args...), _InlineSize>::reset__() noexcept {
+        if (ops__ != nullptr)
+        {
+            ops__->destroy(storage__);
+            ops__ = nullptr;
+        }
+    }
+
+    template<typename _Ret, typename... _Args, size_t _InlineSize>
+    inline sf_small_function<_Ret(_Args...), _InlineSize>::sf_small_function(std::nullptr_t) noexcept {
+    }
+
+    template<typename _Ret, typename... _Args, size_t _InlineSize>
+    template<typename _Func, typename>
+    inline sf_small_function<_Ret(_Args...), _InlineSize>::sf_small_function(_Func &&func) {
+        using func_type = std::decay_t<_Func>;
+        if constexpr (std::is_constructible<bool, const func_type &>::value)
+        {
+            // NOTE 空的函数指针/std::function构造为空对象
+            if (!static_cast<bool>(func))
+            {
+                return;
+            }
+        }
+        if constexpr (is_inline__<func_type>)
+        {
+            new(storage__) func_type(std::forward<_Func>(func));
+        }
+        else
+        {
+            *reinterpret_cast<func_type **>(storage__) = new func_type(std::forward<_Func>(func));
+        }
+        ops__ = get_ops__<func_type>();
+    }
+
+    template<typename _Ret, typename... _Args, size_t _InlineSize>
+    inline sf_small_function<_Ret(_Args...), _InlineSize>::sf_small_function(sf_small_function &&other) noexcept {
+        if (other.ops__ != nullptr)
+        {
+            other.ops__->move(storage__, other.storage__);
+            ops__ = other.ops__;
+            other.ops__ = nullptr;
+        }
+    }
+
+    template<typename _Ret, typename... _Args, size_t _InlineSize>
+    inline sf_small_function<_Ret(_Args...), _InlineSize> &
+    sf_small_function<_Ret(_Args...), _InlineSize>::operator=(sf_small_function &&other) noexcept {
+        if (this != &other)
+        {
+            reset__();
+            if (other.ops__ != nullptr)
+            {
+                other.ops__->move(storage__, other.storage__);
+                ops__ = other.ops__;
+                other.ops__ = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    template<typename _Ret, typename... _Args, size_t _InlineSize>
+    inline sf_small_function<_Ret(_Args...), _InlineSize> &
+    sf_small_function<_Ret(_Args...), _InlineSize>::operator=(std::nullptr_t) noexcept {
+        reset__();
+        return *this;
+    }
+
+    template<typename _Ret, typename... _Args, size_t _InlineSize>
+    inline sf_small_function<_Ret(_Args...), _InlineSize>::~sf_small_function() {
+        reset__();
+    }
+
+    template<typename _Ret, typename... _Args, size_t _InlineSize>
+    inline sf_small_function<_Ret(_Args...), _InlineSize>::operator bool() const noexcept {
+        return ops__ != nullptr;
+    }
+
+    template<typename _Ret, typename... _Args, size_t _InlineSize>
+    inline bool sf_small_function<_Ret(_Args...), _InlineSize>::is_inline() const noexcept {
+        return ops__ != nullptr && ops__->move != &move_heap__;
+    }
+
+    template<typename _Ret, typename... _Args, size_t _InlineSize>
+    inline _Ret sf_small_function<_Ret(_Args...), _InlineSize>::operator()(_Args... args) {
+        return ops__->call(storage__, std::forward<_Args>(args)...);
+    }
+}
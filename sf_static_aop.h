@@ -0,0 +1,111 @@
+
+/**
+* @version 1.0.0
+* @author skyfire
+* @mail skyfireitdiy@hotmail.com
+* @see http://github.com/skyfireitdiy/sflib
+* @file sf_static_aop.h
+
+* sflib第一版本发布
+* 版本号1.0.0
+* 发布日期：2018-10-22
+*/
+
+/*
+ * sf_static_aop 编译期AOP
+ * 切面在编译期确定，调用完全内联，空切面链等同于直接调用；运行期注入仍使用SF_REG_AOP
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/*
+ * SF_REG_STATIC_AOP 注册编译期AOP的宏，生成aop_xxx函数（同一个成员函数不能同时使用SF_REG_AOP）
+ * 参数为成员函数名称与切面类型列表
+ */
+#define SF_REG_STATIC_AOP(name, ...)                                                                                    \
+public:                                                                                                                 \
+    skyfire::sf_aspect_chain<__VA_ARGS__> __##name##_aspect_chain__;                                                    \
+    template<typename...__SF_OBJECT_ARGS__>                                                                            \
+    decltype(auto) aop_##name(__SF_OBJECT_ARGS__&& ... args)                                                            \
+    {                                                                                                                   \
+        return __##name##_aspect_chain__.invoke([this](auto &&... call_args) -> decltype(auto) {                        \
+            return name(std::forward<decltype(call_args)>(call_args)...);                                               \
+        }, std::forward<__SF_OBJECT_ARGS__>(args)...);                                                                  \
+    }                                                                                                                   \
+
+/*
+ * sf_static_aop_get 获取编译期AOP的切面对象（如读取计数）
+ */
+#define sf_static_aop_get(objptr, name, aspect)                                                                         \
+(objptr)->__##name##_aspect_chain__.template get<aspect>()                                                              \
+
+
+namespace skyfire
+{
+    /**
+     *  @brief 切面链
+     *  切面类型需提供 before(const Args&...) 与 after(...)：
+     *  before的返回值（非void时）会传给after，用于保存单次调用的状态（如开始时间）；
+     *  before按切面顺序调用，after按相反顺序调用
+     *  @tparam _Aspects 切面类型列表
+     */
+    template<typename... _Aspects>
+    class sf_aspect_chain
+    {
+    private:
+        std::tuple<_Aspects...> aspects__;
+
+        template<size_t _Index, typename _Func, typename... _Args>
+        auto invoke__(_Func &func, _Args &&... args) -> decltype(func(std::forward<_Args>(args)...));
+
+    public:
+        /**
+         * 在切面中调用函数
+         * @param func 函数
+         * @param args 参数
+         * @return 函数返回值
+         */
+        template<typename _Func, typename... _Args>
+        decltype(auto) invoke(_Func &&func, _Args &&... args);
+
+        /**
+         * 获取切面对象
+         * @tparam _Aspect 切面类型
+         * @return 切面对象
+         */
+        template<typename _Aspect>
+        _Aspect &get();
+    };
+
+    /**
+     *  @brief 计数切面，统计调用次数
+     */
+    struct sf_counting_aspect
+    {
+        std::atomic<unsigned long long> count{0};
+
+        template<typename... _Args>
+        void before(const _Args &...);
+
+        void after();
+    };
+
+    /**
+     *  @brief 计时切面，统计累计耗时（纳秒）
+     */
+    struct sf_timing_aspect
+    {
+        std::atomic<long long> total_ns{0};
+
+        template<typename... _Args>
+        std::chrono::steady_clock::time_point before(const _Args &...);
+
+        void after(std::chrono::steady_clock::time_point begin);
+    };
+}
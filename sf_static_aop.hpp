@@ -0,0 +1,106 @@
+
+/**
+* @version 1.0.0
+* @author skyfire
+* @mail skyfireitdiy@hotmail.com
+* @see http://github.com/skyfireitdiy/sflib
+* @file sf_static_aop.hpp
+
+* sflib第一版本发布
+* 版本号1.0.0
+* 发布日期：2018-10-22
+*/
+
+/*
+ * sf_static_aop 编译期AOP
+ * 切面在编译期确定，调用完全内联，空切面链等同于直接调用；运行期注入仍使用SF_REG_AOP
+ */
+
+#pragma once
+
+#include "sf_static_aop.h"
+
+namespace skyfire
+{
+    template<typename... _Aspects>
+    template<size_t _Index, typename _Func, typename... _Args>
+    inline auto sf_aspect_chain<_Aspects...>::invoke__(_Func &func, _Args &&... args)
+    -> decltype(func(std::forward<_Args>(args)...)) {
+        if constexpr (_Index == sizeof...(_Aspects))
+        {
+            return func(std::forward<_Args>(args)...);
+        }
+        else
+        {
+            using ret_type = decltype(func(std::forward<_Args>(args)...));
+            auto &aspect = std::get<_Index>(aspects__);
+            if constexpr (std::is_void<decltype(aspect.before(args...))>::value)
+            {
+                aspect.before(std::as_const(args)...);
+                if constexpr (std::is_void<ret_type>::value)
+                {
+                    invoke__<_Index + 1>(func, std::forward<_Args>(args)...);
+                    aspect.after();
+                }
+                else
+                {
+                    ret_type ret = invoke__<_Index + 1>(func, std::forward<_Args>(args)...);
+                    aspect.after();
+                    return std::forward<ret_type>(ret);
+                }
+            }
+            else
+            {
+                auto context = aspect.before(std::as_const(args)...);
+                if constexpr (std::is_void<ret_type>::value)
+                {
+                    invoke__<_Index + 1>(func, std::forward<_Args>(args)...);
+                    aspect.after(std::move(context));
+                }
+                else
+                {
+                    ret_type ret = invoke__<_Index + 1>(func, std::forward<_Args>(args)...);
+                    aspect.after(std::move(context));
+                    return std::forward<ret_type>(ret);
+                }
+            }
+        }
+    }
+
+    template<typename... _Aspects>
+    template<typename _Func, typename... _Args>
+    inline decltype(auto) sf_aspect_chain<_Aspects...>::invoke(_Func &&func, _Args &&... args) {
+        if constexpr (sizeof...(_Aspects) == 0)
+        {
+            return std::forward<_Func>(func)(std::forward<_Args>(args)...);
+        }
+        else
+        {
+            return invoke__<0>(func, std::forward<_Args>(args)...);
+        }
+    }
+
+    template<typename... _Aspects>
+    template<typename _Aspect>
+    inline _Aspect &sf_aspect_chain<_Aspects...>::get() {
+        return std::get<_Aspect>(aspects__);
+    }
+
+    template<typename... _Args>
+    inline void sf_counting_aspect::before(const _Args &...) {
+        count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    inline void sf_counting_aspect::after() {
+    }
+
+    template<typename... _Args>
+    inline std::chrono::steady_clock::time_point sf_timing_aspect::before(const _Args &...) {
+        return std::chrono::steady_clock::now();
+    }
+
+    inline void sf_timing_aspect::after(std::chrono::steady_clock::time_point begin) {
+        total_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - begin).count(), std::memory_order_relaxed);
+    }
+}
@@ -20,6 +20,7 @@
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#include <sys/epoll.h>
 
 
 #include <string>
@@ -39,6 +40,13 @@ namespace skyfire
         bool inited__ = false;
         bool raw__ = false;
         int sock__ = -1;
+        // 所在的反应堆事件循环（为nullptr时使用独立的读线程）
+        sf_eventloop *reactor__ = nullptr;
+        byte_array data_buffer__;
+
+        bool on_data__(const byte_array &recv_data);
+
+        void on_readable__();
     public:
         sf_tcp_client(bool raw = false);
 
@@ -19,6 +19,7 @@
 #include "sf_nocopy.h"
 #include "sf_type.hpp"
 #include "sf_tcp_client_interface.hpp"
+#include "sf_eventloop.hpp"
 
 namespace skyfire
 {
@@ -70,11 +71,21 @@ namespace skyfire
         {
             return false;
         }
+
+        // 对象已移动到反应堆事件循环：在事件循环线程中读取数据
+        auto loop = get_eventloop();
+        if (loop != nullptr && loop->is_reactor())
+        {
+            reactor__ = loop;
+            return reactor__->add_fd(sock__, EPOLLIN | EPOLLET, [=](unsigned int)
+            {
+                on_readable__();
+            });
+        }
+
         std::thread([=]
                     {
                         byte_array recv_buffer(SF_NET_BUFFER_SIZE);
-                        byte_array data;
-                        sf_pkg_header_t header;
                         while (true)
                         {
                             auto len = read(sock__, recv_buffer.data(), SF_NET_BUFFER_SIZE);
@@ -84,47 +95,83 @@ namespace skyfire
                                 closed();
                                 break;
                             }
-                            if(raw__)
-                            {
-                                raw_data_coming(byte_array(recv_buffer.begin(),recv_buffer.begin() + len));
-                            }
-                            else
+                            if (!on_data__(byte_array(recv_buffer.begin(), recv_buffer.begin() + len)))
                             {
-                                data.insert(data.end(), recv_buffer.begin(), recv_buffer.begin() + len);
-                                size_t read_pos = 0;
-                                while (data.size() - read_pos >= sizeof(sf_pkg_header_t))
-                                {
-                                    std::memmove(&header, data.data() + read_pos, sizeof(header));
-                                    if (!check_header_checksum(header))
-                                    {
-                                        close();
-                                        return;
-                                    }
-                                    if (data.size() - read_pos - sizeof(header) >= header.length)
-                                    {
-                                        data_coming(
-                                                header,
-                                                byte_array(
-                                                        data.begin() + static_cast<long>(read_pos) + sizeof(header),
-                                                        data.begin() + static_cast<long>(read_pos) + sizeof(header)
-                                                        + static_cast<long>(header.length)));
-                                        read_pos += sizeof(header) + header.length;
-                                    }
-                                    else
-                                    {
-                                        break;
-                                    }
-                                }
-                                if (read_pos != 0)
-                                {
-                                    data.erase(data.begin(), data.begin() + static_cast<long>(read_pos));
-                                }
+                                return;
                             }
                         }
                     }).detach();
         return true;
     }
 
+    inline bool sf_tcp_client::on_data__(const byte_array &recv_data)
+    {
+        if(raw__)
+        {
+            raw_data_coming(recv_data);
+            return true;
+        }
+        sf_pkg_header_t header;
+        auto &data = data_buffer__;
+        data.insert(data.end(), recv_data.begin(), recv_data.end());
+        size_t read_pos = 0;
+        while (data.size() - read_pos >= sizeof(sf_pkg_header_t))
+        {
+            std::memmove(&header, data.data() + read_pos, sizeof(header));
+            if (!check_header_checksum(header))
+            {
+                close();
+                return false;
+            }
+            if (data.size() - read_pos - sizeof(header) >= header.length)
+            {
+                data_coming(
+                        header,
+                        byte_array(
+                                data.begin() + static_cast<long>(read_pos) + sizeof(header),
+                                data.begin() + static_cast<long>(read_pos) + sizeof(header)
+                                + static_cast<long>(header.length)));
+                read_pos += sizeof(header) + header.length;
+            }
+            else
+            {
+                break;
+            }
+        }
+        if (read_pos != 0)
+        {
+            data.erase(data.begin(), data.begin() + static_cast<long>(read_pos));
+        }
+        return true;
+    }
+
+    inline void sf_tcp_client::on_readable__()
+    {
+        byte_array recv_buffer(SF_NET_BUFFER_SIZE);
+        while (sock__ != -1)
+        {
+            auto len = recv(sock__, recv_buffer.data(), SF_NET_BUFFER_SIZE, MSG_DONTWAIT);
+            if (len < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (len < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            {
+                break;
+            }
+            if (len <= 0)
+            {
+                reactor__->remove_fd(sock__);
+                closed();
+                break;
+            }
+            if (!on_data__(byte_array(recv_buffer.begin(), recv_buffer.begin() + len)))
+            {
+                break;
+            }
+        }
+    }
+
     inline bool sf_tcp_client::send(int type, const byte_array &data) {
         if (!inited__)
             return false;
@@ -147,6 +194,10 @@ namespace skyfire
     inline void sf_tcp_client::close() {
         if (!inited__)
             return;
+        if (reactor__ != nullptr && sock__ != -1)
+        {
+            reactor__->remove_fd(sock__);
+        }
         shutdown(sock__,SHUT_RDWR);
         ::close(sock__);
         sock__ = -1;
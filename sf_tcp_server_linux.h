@@ -44,9 +44,18 @@ namespace skyfire
         int cur_fd_count__ = -1;
         int epoll_fd__ = -1;
         bool raw__ = false;
+        // 所在的反应堆事件循环（为nullptr时使用独立的IO线程）
+        sf_eventloop *reactor__ = nullptr;
+        byte_array recv_buf__ = byte_array(SF_NET_BUFFER_SIZE);
         epoll_event evs[SOMAXCONN];
         epoll_event ev;
 
+        void accept_connections__();
+
+        void on_readable__(int fd);
+
+        void close_connection__(int fd);
+
     public:
         sf_tcp_server(bool raw = false);
 
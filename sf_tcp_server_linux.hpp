@@ -17,6 +17,7 @@
 #include "sf_tcp_server_linux.h"
 #include "sf_define.h"
 #include "sf_tcp_client_interface.hpp"
+#include "sf_eventloop.hpp"
 
 namespace skyfire
 {
@@ -32,8 +33,8 @@ namespace skyfire
 
     inline bool sf_tcp_server::send(int sock, const byte_array &data)
     {
-        auto send_data = data;
-        return write(sock, send_data.data(), send_data.size()) == send_data.size();
+        auto n = write(sock, data.data(), data.size());
+        return n >= 0 && static_cast<size_t>(n) == data.size();
     }
 
     inline bool sf_tcp_server::send(int sock, int type, const byte_array &data)
@@ -43,23 +44,155 @@ namespace skyfire
         header.length = data.size();
         make_header_checksum(header);
         auto send_data = make_pkg(header) + data;
-        return write(sock, send_data.data(), send_data.size()) == send_data.size();
+        auto n = write(sock, send_data.data(), send_data.size());
+        return n >= 0 && static_cast<size_t>(n) == send_data.size();
     }
 
     inline void sf_tcp_server::close(SOCKET sock)
     {
+        if (reactor__ != nullptr)
+        {
+            reactor__->remove_fd(sock);
+        }
         ::shutdown(sock, SHUT_RDWR);
         ::close(sock);
     }
 
     inline void sf_tcp_server::close()
     {
+        if (reactor__ != nullptr && listen_fd__ != -1)
+        {
+            reactor__->remove_fd(listen_fd__);
+        }
         shutdown(listen_fd__, SHUT_RDWR);
         ::close(listen_fd__);
         listen_fd__ = -1;
         sock_data_buffer__.clear();
     }
 
+    inline void sf_tcp_server::accept_connections__()
+    {
+        // NOTE 边沿触发，需要一次性接受所有等待的连接
+        while (cur_fd_count__ < SOMAXCONN)
+        {
+            sockaddr_in client_addr{};
+            socklen_t len = sizeof(client_addr);
+            int conn_fd = accept(listen_fd__, (struct sockaddr *) &client_addr, &len);
+            if (conn_fd == -1)
+            {
+                break;
+            }
+            bool ok;
+            if (reactor__ != nullptr)
+            {
+                ok = reactor__->add_fd(conn_fd, EPOLLIN | EPOLLET, [=](unsigned int)
+                {
+                    on_readable__(conn_fd);
+                });
+            }
+            else
+            {
+                ev.events = EPOLLIN | EPOLLET;
+                ev.data.fd = conn_fd;
+                ok = epoll_ctl(epoll_fd__, EPOLL_CTL_ADD, conn_fd, &ev) == 0;
+            }
+            if (!ok)
+            {
+                ::close(conn_fd);
+                continue;
+            }
+            ++cur_fd_count__;
+
+            sf_debug("new connection");
+            new_connection(conn_fd);
+        }
+    }
+
+    inline void sf_tcp_server::close_connection__(int fd)
+    {
+        if (reactor__ != nullptr)
+        {
+            reactor__->remove_fd(fd);
+        }
+        else
+        {
+            epoll_ctl(epoll_fd__, EPOLL_CTL_DEL, fd, &ev);
+        }
+        sock_data_buffer__.erase(fd);
+        --cur_fd_count__;
+        sf_debug("close connection");
+        closed(static_cast<SOCKET>(fd));
+        ::close(fd);
+    }
+
+    inline void sf_tcp_server::on_readable__(int fd)
+    {
+        sf_pkg_header_t header{};
+        while (true)
+        {
+            recv_buf__.resize(SF_NET_BUFFER_SIZE);
+            // NOTE 读取使用MSG_DONTWAIT，socket本身保持阻塞，保证send能完整写出
+            auto count_read = static_cast<int>(recv(fd, recv_buf__.data(), SF_NET_BUFFER_SIZE, MSG_DONTWAIT));
+            if (count_read < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                {
+                    sf_debug("read finish");
+                    break;
+                }
+                close_connection__(fd);
+                break;
+            }
+            if (count_read == 0)
+            {
+                close_connection__(fd);
+                break;
+            }
+
+            recv_buf__.resize(static_cast<unsigned long>(count_read));
+            if (raw__)
+            {
+                sf_debug_every_ms(1000, "raw data", recv_buf__.size());
+                raw_data_coming(static_cast<SOCKET>(fd), recv_buf__);
+            } else
+            {
+                auto &buffer = sock_data_buffer__[fd];
+                buffer.insert(buffer.end(), recv_buf__.begin(), recv_buf__.end());
+                size_t read_pos = 0;
+                while (buffer.size() - read_pos >= sizeof(sf_pkg_header_t))
+                {
+                    memmove(&header, buffer.data() + read_pos, sizeof(header));
+                    if (!check_header_checksum(header))
+                    {
+                        close_connection__(fd);
+                        return;
+                    }
+                    if (buffer.size() - read_pos - sizeof(header) >= header.length)
+                    {
+                        data_coming(
+                                static_cast<SOCKET>(fd), header,
+                                byte_array(buffer.begin() + read_pos + sizeof(header),
+                                           buffer.begin() + read_pos + sizeof(header) + header.length)
+                        );
+                        read_pos += sizeof(header) + header.length;
+                    }
+                    else
+                    {
+                        break;
+                    }
+                }
+                if (read_pos != 0)
+                {
+                    buffer.erase(buffer.begin(), buffer.begin() + read_pos);
+                }
+            }
+        }
+    }
+
     inline bool sf_tcp_server::listen(const std::string &ip, unsigned short port)
     {
         listen_fd__ = socket(AF_INET, SOCK_STREAM, 0);
@@ -67,7 +200,7 @@ namespace skyfire
         {
             return false;
         }
-        if (fcntl(listen_fd__, F_SETFL, fcntl(listen_fd__, F_GETFD, 0) | O_NONBLOCK) == -1)
+        if (fcntl(listen_fd__, F_SETFL, fcntl(listen_fd__, F_GETFL, 0) | O_NONBLOCK) == -1)
         {
             return false;
         }
@@ -94,6 +227,19 @@ namespace skyfire
             return false;
         }
 
+        cur_fd_count__ = 1;
+
+        // 对象已移动到反应堆事件循环：直接在事件循环线程中处理IO，信号在该线程中发出
+        auto loop = get_eventloop();
+        if (loop != nullptr && loop->is_reactor())
+        {
+            reactor__ = loop;
+            return reactor__->add_fd(listen_fd__, EPOLLIN | EPOLLET, [=](unsigned int)
+            {
+                accept_connections__();
+            });
+        }
+
         epoll_fd__ = epoll_create(SOMAXCONN);    //!> create
         ev.events = EPOLLIN | EPOLLET;      //!> accept Read!
         ev.data.fd = listen_fd__;                 //!> 将listen_fd 加入
@@ -102,13 +248,8 @@ namespace skyfire
             return false;
         }
 
-        cur_fd_count__ = 1;
-
         std::thread([=]
                     {
-
-                        byte_array recv_buf(SF_NET_BUFFER_SIZE);
-                        sf_pkg_header_t header{};
                         while (true)
                         {
                             int wait_fds = 0;
@@ -119,106 +260,12 @@ namespace skyfire
 
                             for (auto i = 0; i < wait_fds; ++i)
                             {
-                                if (evs[i].data.fd == listen_fd__ && cur_fd_count__ < SOMAXCONN)
+                                if (evs[i].data.fd == listen_fd__)
                                 {
-                                    int conn_fd = 0;
-                                    sockaddr_in client_addr{};
-                                    socklen_t len = sizeof(client_addr);
-                                    if ((conn_fd = accept(listen_fd__, (struct sockaddr *) &client_addr, &len)) ==
-                                        -1)
-                                    {
-                                        break;
-                                    }
-                                    ev.events = EPOLLIN | EPOLLET;
-                                    ev.data.fd = conn_fd;
-                                    if (epoll_ctl(epoll_fd__, EPOLL_CTL_ADD, conn_fd, &ev) < 0)
-                                    {
-                                        close(conn_fd);
-                                        continue;
-                                    }
-                                    ++cur_fd_count__;
-
-                                    sf_debug("new connection");
-                                    new_connection(conn_fd);
+                                    accept_connections__();
                                     continue;
                                 }
-
-                                while (true)
-                                {
-                                    recv_buf.resize(SF_NET_BUFFER_SIZE);
-                                    auto count_read = static_cast<int>(read(evs[i].data.fd, recv_buf.data(),
-                                                                            SF_NET_BUFFER_SIZE));
-                                    if (count_read < 0)
-                                    {
-                                        closed(static_cast<SOCKET>(evs[i].data.fd));
-                                        close(evs[i].data.fd);
-                                        epoll_ctl(epoll_fd__, EPOLL_CTL_DEL, evs[i].data.fd, &ev);
-                                        --cur_fd_count__;
-
-                                        sf_debug("close connection");
-                                        close(evs[i].data.fd);
-                                        break;
-                                    }
-                                    if (count_read == 0)
-                                    {
-                                        sf_debug("read finish");
-                                        break;
-                                    }
-
-
-                                    recv_buf.resize(static_cast<unsigned long>(count_read));
-                                    if (raw__)
-                                    {
-                                        sf_debug("raw data", recv_buf.size());
-                                        raw_data_coming(static_cast<SOCKET>(evs[i].data.fd), recv_buf);
-                                    } else
-                                    {
-                                        sock_data_buffer__[evs[i].data.fd].insert(
-                                                sock_data_buffer__[evs[i].data.fd].end(),
-                                                recv_buf.begin(),
-                                                recv_buf.end());
-                                        size_t read_pos = 0;
-                                        while (sock_data_buffer__[evs[i].data.fd].size() - read_pos >=
-                                               sizeof(sf_pkg_header_t))
-                                        {
-                                            memmove(&header,
-                                                    sock_data_buffer__[evs[i].data.fd].data() + read_pos,
-                                                    sizeof(header));
-                                            if (!check_header_checksum(header))
-                                            {
-                                                close(evs[i].data.fd);
-                                                closed(static_cast<SOCKET>(evs[i].data.fd));
-                                                break;
-                                            }
-                                            if (sock_data_buffer__[evs[i].data.fd].size() - read_pos - sizeof(header) >=
-                                                header.length)
-                                            {
-                                                data_coming(
-                                                        static_cast<SOCKET>(evs[i].data.fd), header,
-                                                        byte_array(
-                                                                sock_data_buffer__[evs[i].data.fd].begin() +
-                                                                read_pos +
-                                                                sizeof(header),
-                                                                sock_data_buffer__[evs[i].data.fd].begin() +
-                                                                read_pos +
-                                                                sizeof(header) + header.length)
-                                                );
-                                                read_pos += sizeof(header) + header.length;
-                                            }
-                                            else
-                                            {
-                                                break;
-                                            }
-                                        }
-                                        if (read_pos != 0)
-                                        {
-                                            sock_data_buffer__[evs[i].data.fd].erase(
-                                                    sock_data_buffer__[evs[i].data.fd].begin(),
-                                                    sock_data_buffer__[evs[i].data.fd].begin() + read_pos);
-                                        }
-                                    }
-                                }
-
+                                on_readable__(evs[i].data.fd);
                             }
                         }
                     }).detach();
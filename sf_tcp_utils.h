@@ -30,6 +30,7 @@
 #include <string>
 #include "sf_type.hpp"
 #include "sf_define.h"
+#include "sf_byte_order.hpp"
 
 namespace skyfire
 {
@@ -47,6 +48,27 @@ namespace skyfire
 
 #pragma pack()
 
+    /**
+     * 包类型包含该标志时，数据以一个字节的扩展标志开始（低4位为序列化方式sf_binary_profile，高位为压缩标志），之后才是实际数据
+     * 扩展标志为0时不使用该标志，数据包与之前的版本相同
+     */
+    constexpr int sf_pkg_ex_type_flag = 0x40000000;
+
+    /**
+     * 扩展标志中序列化方式（sf_binary_profile）的掩码
+     */
+    constexpr unsigned char sf_pkg_ex_profile_mask = 0x0f;
+
+    /**
+     * 扩展标志：发送方可以解压，对端可以向其发送压缩的数据包（只在压缩握手的数据包中设置，见sf_pkg_compress.h）
+     */
+    constexpr unsigned char sf_pkg_ex_accept_compress = 0x40;
+
+    /**
+     * 扩展标志：数据已压缩（见sf_pkg_compress.h）
+     */
+    constexpr unsigned char sf_pkg_ex_compressed = 0x80;
+
     /**
      * 生成数据包
      * @tparam T 数据类型
@@ -78,6 +100,45 @@ namespace skyfire
      */
     inline bool check_header_checksum(const sf_pkg_header_t& header);
 
+    /**
+     * 生成完整的数据包，包头与数据写入同一个缓冲区（只分配一次内存）
+     * @tparam _Func 写入数据的函数类型
+     * @param type 包类型
+     * @param length 数据长度（用于预分配，包头中的长度以实际写入的长度为准）
+     * @param write_data 写入数据的函数，参数为缓冲区（byte_array &），数据追加到包头之后
+     * @return 数据包（使用不带类型的send发送）
+     */
+    template<typename _Func>
+    byte_array sf_make_pkg_frame(int type, size_t length, _Func write_data);
+
+    /**
+     * 生成带扩展标志的完整数据包
+     * @tparam _Func 写入数据的函数类型
+     * @param type 包类型
+     * @param ex_flags 扩展标志（为0时与不带扩展标志的数据包相同）
+     * @param length 数据长度（用于预分配）
+     * @param write_data 写入数据的函数
+     * @return 数据包（使用不带类型的send发送）
+     */
+    template<typename _Func>
+    byte_array sf_make_pkg_frame(int type, unsigned char ex_flags, size_t length, _Func write_data);
+
+    /**
+     * 去除扩展标志后的包类型
+     * @param type 包类型
+     * @return 包类型
+     */
+    inline int sf_pkg_base_type(int type);
+
+    /**
+     * 读取数据包的扩展标志
+     * @param header 包头
+     * @param data 数据
+     * @param ex_flags 扩展标志（没有扩展标志时为0）
+     * @return 实际数据在data中的开始位置
+     */
+    inline size_t sf_take_pkg_ex_flags(const sf_pkg_header_t &header, const byte_array &data, unsigned char &ex_flags);
+
     /**
      * 64位整型网络字节序转主机字节序
      * @param input 整型数字（网络字节序）
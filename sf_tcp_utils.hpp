@@ -63,19 +63,50 @@ namespace skyfire
         return checksum == header.checksum;
     }
 
+    template<typename _Func>
+    byte_array sf_make_pkg_frame(int type, size_t length, _Func write_data) {
+        byte_array frame;
+        frame.reserve(sizeof(sf_pkg_header_t) + length);
+        frame.resize(sizeof(sf_pkg_header_t));
+        write_data(frame);
+        sf_pkg_header_t header{};
+        header.type = type;
+        header.length = frame.size() - sizeof(sf_pkg_header_t);
+        make_header_checksum(header);
+        memcpy(frame.data(), &header, sizeof(header));
+        return frame;
+    }
+
+    template<typename _Func>
+    byte_array sf_make_pkg_frame(int type, unsigned char ex_flags, size_t length, _Func write_data) {
+        if (ex_flags == 0) {
+            return sf_make_pkg_frame(type, length, write_data);
+        }
+        return sf_make_pkg_frame(type | sf_pkg_ex_type_flag, length + 1, [&](byte_array &buffer) {
+            buffer.push_back(static_cast<char>(ex_flags));
+            write_data(buffer);
+        });
+    }
+
+    inline int sf_pkg_base_type(int type) {
+        return type & ~sf_pkg_ex_type_flag;
+    }
+
+    inline size_t sf_take_pkg_ex_flags(const sf_pkg_header_t &header, const byte_array &data, unsigned char &ex_flags) {
+        ex_flags = 0;
+        if ((header.type & sf_pkg_ex_type_flag) == 0 || data.empty()) {
+            return 0;
+        }
+        ex_flags = static_cast<unsigned char>(data[0]);
+        return 1;
+    }
+
     inline unsigned long long sf_ntoh64(unsigned long long input) {
-        unsigned long long val;
-        auto *data = reinterpret_cast<unsigned char *>(&val);
-
-        data[0] = static_cast<unsigned char>(input >> 56);
-        data[1] = static_cast<unsigned char>(input >> 48);
-        data[2] = static_cast<unsigned char>(input >> 40);
-        data[3] = static_cast<unsigned char>(input >> 32);
-        data[4] = static_cast<unsigned char>(input >> 24);
-        data[5] = static_cast<unsigned char>(input >> 16);
-        data[6] = static_cast<unsigned char>(input >> 8);
-        data[7] = static_cast<unsigned char>(input >> 0);
-        return val;
+        if constexpr (sf_host_little_endian) {
+            return sf_byte_swap64(input);
+        } else {
+            return input;
+        }
     }
 
     inline unsigned long long sf_hton64(unsigned long long input) {
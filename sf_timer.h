@@ -56,6 +56,9 @@ namespace skyfire
     private:
         std::atomic<bool> running__ {false};
         std::thread::id current_timer_thread__ ;
+        // 反应堆模式下的定时器id
+        std::atomic<int> reactor_timer_id__ {-1};
+        sf_eventloop *reactor__ = nullptr;
     };
 
 }
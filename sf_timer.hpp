@@ -29,6 +29,33 @@ namespace skyfire
         }
         running__ = true;
 
+#ifndef _WIN32
+        // 对象已移动到反应堆事件循环：使用timerfd，在事件循环线程中触发
+        auto loop = get_eventloop();
+        if (loop != nullptr && loop->is_reactor())
+        {
+            reactor__ = loop;
+            auto timer_id = loop->add_timer(ms, false, [=] {
+                if (!running__)
+                {
+                    return;
+                }
+                if (once)
+                {
+                    stop();
+                }
+                timeout();
+            });
+            if (timer_id == -1)
+            {
+                running__ = false;
+                return;
+            }
+            reactor_timer_id__ = timer_id;
+            return;
+        }
+#endif
+
         std::thread new_thread = std::thread ([=](bool is_once)
                                               {
                                                   while (true)
@@ -64,5 +91,12 @@ namespace skyfire
 
     inline void sf_timer::stop() {
         running__ = false;
+#ifndef _WIN32
+        auto timer_id = reactor_timer_id__.exchange(-1);
+        if (timer_id != -1)
+        {
+            reactor__->remove_timer(timer_id);
+        }
+#endif
     }
 }
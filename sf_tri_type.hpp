@@ -54,7 +54,7 @@ namespace skyfire
 	{}
 
 	inline sf_tri_type<void>::operator bool() const {
-		return true;
+		return init__;
 	}
 
 }
@@ -34,7 +34,7 @@ namespace skyfire {
             header.fin_rsv_oc |= type;
             header.mask_len = data.size();
             ret += to_byte_array(header);
-        }else if(data.size()>=126 && data.size() <= 0xffffffffffffffffUL){
+        }else if(data.size()>=126 && data.size() <= 0xffff){
             sf_websocket_server_data_2_header_t header;
             memset(&header,0,sizeof(header));
             header.mask_len = 126;
@@ -43,12 +43,13 @@ namespace skyfire {
             *reinterpret_cast<unsigned short*>(header.extend_len) = htons(data.size());
             ret += to_byte_array(header);
         }else{
-            sf_websocket_server_data_2_header_t header;
+            sf_websocket_server_data_3_header_t header;
             memset(&header,0,sizeof(header));
             header.mask_len = 127;
             header.fin_rsv_oc = 0b10000000;
             header.fin_rsv_oc |= type;
-            *reinterpret_cast<unsigned short*>(header.extend_len) = sf_hton64(data.size());
+            auto len = sf_hton64(data.size());
+            memcpy(header.extend_len, &len, sizeof(len));
             ret += to_byte_array(header);
         }
         if constexpr (std::is_same_v<T,std::string>) {
@@ -0,0 +1,332 @@
+/**
+* @version 1.0.0
+* @author skyfire
+* @mail skyfireitdiy@hotmail.com
+* @see http://github.com/skyfireitdiy/sflib
+* @file bench_logger.cpp
+
+* sflib第一版本发布
+* 版本号1.0.0
+* 发布日期：2018-10-22
+*/
+
+/*
+ * 日志基准测试：打印线程中单次日志调用的耗时（不同溢出策略、不同线程数），以及旧的字符串路径
+ */
+
+#include "sf_logger.hpp"
+#include "bench_utils.h"
+#include <thread>
+#include <cstdio>
+
+using namespace skyfire;
+
+constexpr size_t iterations = 200000;
+constexpr size_t burst_iterations = 40000;
+
+// 多个线程同时打印日志，返回每次调用的平均耗时
+template<typename Func>
+double threads_ns(int thread_count, Func func)
+{
+    std::vector<std::thread> threads;
+    std::vector<double> result(static_cast<size_t>(thread_count));
+    for (auto i = 0; i < thread_count; ++i)
+    {
+        threads.emplace_back([&, i] {
+            result[static_cast<size_t>(i)] = sf_bench_ns(iterations / static_cast<size_t>(thread_count), func);
+        });
+    }
+    for (auto &p : threads)
+    {
+        p.join();
+    }
+    double sum = 0;
+    for (auto p : result)
+    {
+        sum += p;
+    }
+    return sum / thread_count;
+}
+
+// 旧的格式化实现：每条日志对格式字符串做多次查找替换
+std::string legacy_format(std::string format_str, const sf_logger_info_t__ &log_info)
+{
+    auto replace = [](std::string &str, const std::string &from, const std::string &to) {
+        size_t start_pos = 0;
+        while ((start_pos = str.find(from, start_pos)) != std::string::npos)
+        {
+            str.replace(start_pos, from.length(), to);
+            start_pos += to.length();
+        }
+    };
+    auto thread_to_str = [](std::thread::id id) {
+        std::ostringstream oss;
+        oss << id;
+        return oss.str();
+    };
+    std::map<SF_LOG_LEVEL, std::string> level_str{
+            {SF_DEBUG_LEVEL, "DEBUG"},
+            {SF_INFO_LEVEL,  "INFO "},
+            {SF_WARN_LEVEL,  "WARN "},
+            {SF_ERROR_LEVEL, "ERROR"},
+            {SF_FATAL_LEVEL, "FATAL"},
+    };
+    replace(format_str, "{func}", log_info.func);
+    replace(format_str, "{time}", log_info.time);
+    replace(format_str, "{thread}", thread_to_str(log_info.thread_id));
+    replace(format_str, "{line}", std::to_string(log_info.line));
+    replace(format_str, "{file}", log_info.file);
+    replace(format_str, "{level}", level_str[log_info.level]);
+    replace(format_str, "{msg}", log_info.msg);
+    return format_str;
+}
+
+void bench_format(sf_bench_report &report)
+{
+    sf_logger_info_t__ log_info{SF_INFO_LEVEL, "2018-10-22 12:00:00", 128, "/root/sflib/sf_tcp_server_linux.hpp",
+                                std::this_thread::get_id(), "on_readable__", "[accept][42][connection][3.5]"};
+    std::string format_str = sf_default_log_format;
+    report.add("format_legacy", "ns_per_call", sf_bench_ns(iterations, [&] {
+        sf_bench_keep(legacy_format(format_str, log_info));
+    }));
+    sf_log_format fmt(format_str);
+    std::string buffer;
+    report.add("format_compiled", "ns_per_call", sf_bench_ns(iterations, [&] {
+        fmt.render(buffer, log_info);
+        sf_bench_keep(buffer);
+    }));
+    fmt.render(buffer, log_info);
+    report.add("format_compiled", "identical", buffer == legacy_format(format_str, log_info) ? 1 : 0);
+}
+
+void bench_time_str(sf_bench_report &report)
+{
+    auto now = [] {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+    };
+    report.add("time_str_legacy", "ns_per_call", sf_bench_ns(iterations, [&] {
+        auto tt = static_cast<time_t>(now() / 1000000000LL);
+        std::ostringstream os;
+        os << std::put_time(localtime(&tt), "%Y-%m-%d %H:%M:%S");
+        sf_bench_keep(os.str());
+    }));
+    report.add("time_str_cached", "ns_per_call", sf_bench_ns(iterations, [&] {
+        sf_bench_keep(sf_log_time_str(static_cast<time_t>(now() / 1000000000LL)));
+    }));
+    report.add("time_str_cached_ms", "ns_per_call", sf_bench_ns(iterations, [&] {
+        sf_bench_keep(sf_log_time_str(now(), 3));
+    }));
+}
+
+// 每秒写入文件的行数（写入完成并关闭文件后计时结束）
+template<typename Func>
+double lines_per_second(size_t lines, Func func)
+{
+    auto begin = std::chrono::steady_clock::now();
+    func(lines);
+    auto end = std::chrono::steady_clock::now();
+    return static_cast<double>(lines) / std::chrono::duration<double>(end - begin).count();
+}
+
+void bench_file_sink(sf_bench_report &report)
+{
+    constexpr size_t lines = 1000000;
+    const std::string filename = "/tmp/sf_bench_logger.log";
+    std::string line = "[INFO ][2018-10-22 12:00:00][140640616818624][/root/sflib/sf_tcp_server_linux.hpp (128) "
+                       "on_readable__] --> [accept][42][connection][3.5]\n";
+    auto cleanup = [&] {
+        std::remove(filename.c_str());
+        for (auto i = 1; i <= 8; ++i)
+        {
+            std::remove((filename + "." + std::to_string(i)).c_str());
+            std::remove((filename + "." + std::to_string(i) + ".gz").c_str());
+        }
+    };
+
+    cleanup();
+    report.add("file_ofstream", "lines_per_second", lines_per_second(lines, [&](size_t n) {
+        std::ofstream ofs(filename, std::ios::app);
+        for (size_t i = 0; i < n; ++i)
+        {
+            ofs << line;
+        }
+    }));
+
+    auto run_sink = [&](const std::string &name, sf_log_file_sink_config_t config) {
+        cleanup();
+        config.filename = filename;
+        unsigned long long rotate_count = 0;
+        report.add(name, "lines_per_second", lines_per_second(lines, [&](size_t n) {
+            sf_log_file_sink sink(config);
+            for (size_t i = 0; i < n; ++i)
+            {
+                sink.write(line.data(), line.size());
+                // NOTE 模拟日志线程每处理一批日志后调用flush
+                if (i % 256 == 255)
+                {
+                    sink.flush();
+                }
+            }
+            rotate_count = sink.rotate_count();
+        }));
+        report.add(name, "rotate_count", static_cast<double>(rotate_count));
+    };
+
+    run_sink("file_sink", sf_log_file_sink_config_t{});
+
+    sf_log_file_sink_config_t config;
+    config.fsync_policy = sf_log_fsync_policy::interval;
+    config.fsync_interval = std::chrono::milliseconds(100);
+    run_sink("file_sink_fsync_100ms", config);
+
+    config = sf_log_file_sink_config_t{};
+    config.fsync_policy = sf_log_fsync_policy::bytes;
+    config.fsync_bytes = 1024 * 1024;
+    run_sink("file_sink_fsync_1mb", config);
+
+    config = sf_log_file_sink_config_t{};
+    config.max_file_size = 16 * 1024 * 1024;
+    config.max_history = 4;
+    config.compress = true;
+    run_sink("file_sink_rotate_gzip", config);
+
+    cleanup();
+}
+
+// 与日志线程相同的处理：文本输出解码、格式化后写入文件，二进制输出直接写入编码后的参数
+void bench_binary_sink(sf_bench_report &report)
+{
+    constexpr size_t records = 200000;
+    const std::string text_file = "/tmp/sf_bench_logger_text.log";
+    const std::string binary_file = "/tmp/sf_bench_logger_binary.log";
+    static const sf_log_location_t location{SF_INFO_LEVEL, __FILE__, __LINE__, __FUNCTION__};
+    std::string str = "connection";
+    std::vector<char> args(256);
+    auto end = args.data();
+    end = sf_log_arg_encode(end, "accept");
+    end = sf_log_arg_encode(end, 42);
+    end = sf_log_arg_encode(end, str);
+    end = sf_log_arg_encode(end, 3.5);
+    sf_log_record_header_t header{0, 4, &location, 0};
+    auto thread_id = std::this_thread::get_id();
+    auto now = [] {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+    };
+
+    std::remove(text_file.c_str());
+    sf_log_file_sink_config_t config;
+    config.filename = text_file;
+    auto text_sink = std::make_shared<sf_log_file_sink>(config);
+    sf_log_format fmt(sf_default_log_format);
+    std::string buffer;
+    report.add("sink_text", "ns_per_record", sf_bench_ns(records, [&] {
+        header.ticks = now();
+        sf_logger_info_t__ log_info;
+        log_info.level = static_cast<SF_LOG_LEVEL>(location.level);
+        log_info.file = location.file;
+        log_info.line = location.line;
+        log_info.func = location.func;
+        log_info.thread_id = thread_id;
+        log_info.time = sf_log_time_str(header.ticks, 0);
+        std::ostringstream oss;
+        const char *pos = args.data();
+        for (unsigned int i = 0; i < header.arg_count; ++i)
+        {
+            oss << "[";
+            pos = sf_log_arg_decode(oss, pos);
+            oss << "]";
+        }
+        log_info.msg = oss.str();
+        fmt.render(buffer, log_info);
+        text_sink->write(buffer.data(), buffer.size());
+    }));
+    text_sink->flush();
+    report.add("sink_text", "bytes_per_record", static_cast<double>(text_sink->written_bytes()) / records);
+
+    std::remove(binary_file.c_str());
+    config.filename = binary_file;
+    auto binary_file_sink = std::make_shared<sf_log_file_sink>(config);
+    sf_log_binary_sink binary_sink(binary_file_sink);
+    report.add("sink_binary", "ns_per_record", sf_bench_ns(records, [&] {
+        header.ticks = now();
+        binary_sink.write(header, thread_id, args.data());
+    }));
+    binary_sink.flush();
+    report.add("sink_binary", "bytes_per_record", static_cast<double>(binary_file_sink->written_bytes()) / records);
+
+    std::remove(text_file.c_str());
+    std::remove(binary_file.c_str());
+}
+
+int main(int argc, char **argv)
+{
+    // NOTE 不输出日志内容，只测量打印线程的开销
+    std::cout.setstate(std::ios::failbit);
+    sf_bench_report report("logger");
+    auto logger = sf_logger::get_instance();
+    logger->set_thread_buffer_size(4 * 1024 * 1024);
+
+    bench_format(report);
+    bench_time_str(report);
+    bench_file_sink(report);
+    bench_binary_sink(report);
+
+    int n = 0;
+    std::string str = "connection";
+
+    // 突发：记录总量小于环形缓冲区容量，不会发生丢弃与阻塞，得到打印线程的真实开销
+    // NOTE 预热一轮，使缓冲区的内存页都已映射
+    for (size_t i = 0; i < burst_iterations; ++i)
+    {
+        sf_info("accept", ++n, str, 3.5);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    report.add("ring_burst", "ns_per_call", sf_bench_ns(burst_iterations, [&] {
+        sf_info("accept", ++n, str, 3.5);
+    }));
+    report.add("ring_burst", "dropped", static_cast<double>(logger->dropped_count()));
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    for (auto policy : {sf_log_overflow_policy::drop, sf_log_overflow_policy::block})
+    {
+        logger->set_overflow_policy(policy);
+        auto suffix = std::string(policy == sf_log_overflow_policy::drop ? "_drop" : "_block");
+        for (auto thread_count : {1, 4})
+        {
+            auto name = "ring_" + std::to_string(thread_count) + "_threads" + suffix;
+            auto dropped = logger->dropped_count();
+            report.add(name, "ns_per_call", threads_ns(thread_count, [&] {
+                sf_info("accept", ++n, str, 3.5);
+            }));
+            report.add(name, "dropped", static_cast<double>(logger->dropped_count() - dropped));
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        }
+    }
+
+    // 低于最低等级的日志只有一次relaxed读取，参数不求值
+    logger->set_min_level(SF_WARN_LEVEL);
+    report.add("below_min_level", "ns_per_call", sf_bench_ns(iterations, [&] {
+        sf_info("accept", ++n, str, 3.5);
+    }));
+    logger->set_min_level(SF_DEBUG_LEVEL);
+
+    // 限频打印：大部分调用被抑制，只有原子操作的开销
+    report.add("every_n_1000", "ns_per_call", sf_bench_ns(iterations, [&] {
+        sf_info_every_n(1000, "accept", ++n, str, 3.5);
+    }));
+    report.add("every_ms_100", "ns_per_call", sf_bench_ns(iterations, [&] {
+        sf_info_every_ms(100, "accept", ++n, str, 3.5);
+    }));
+    report.add("sampled_0.001", "ns_per_call", sf_bench_ns(iterations, [&] {
+        sf_info_sampled(0.001, "accept", ++n, str, 3.5);
+    }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    report.add("legacy_string_path", "ns_per_call", sf_bench_ns(iterations / 10, [&] {
+        logger->logout(SF_INFO_LEVEL, __FILE__, __LINE__, __FUNCTION__, "accept", ++n, str, 3.5);
+    }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    std::cout.clear();
+    report.output(argc > 1 ? argv[1] : "");
+}
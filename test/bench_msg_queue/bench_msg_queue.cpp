@@ -0,0 +1,210 @@
+/**
+* @version 1.0.0
+* @author skyfire
+* @mail skyfireitdiy@hotmail.com
+* @see http://github.com/skyfireitdiy/sflib
+* @file bench_msg_queue.cpp
+
+* sflib第一版本发布
+* 版本号1.0.0
+* 发布日期：2018-10-22
+*/
+
+/*
+ * 消息队列基准测试：大量未处理消息下对象析构（取消消息）的耗时，以及对生产者的阻塞；
+ * 跳过作废消息取出消息时的内存分配次数；没有消费者时析构对象后保留的消息数量
+ */
+
+#define SF_BENCH_COUNT_ALLOC
+
+#include "sf_object.hpp"
+#include "bench_utils.h"
+#include <atomic>
+#include <list>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace skyfire;
+
+class A : public sf_object
+{
+    SF_REG_SIGNAL(s1, int)
+};
+
+constexpr size_t pending_count = 300000;
+constexpr size_t object_count = 1000;
+
+// 旧实现：全量remove_if扫描
+double legacy_remove_ns()
+{
+    std::list<std::pair<void *, std::function<void()>>> data;
+    std::mutex mu;
+    std::vector<int> ids(object_count);
+    for (size_t i = 0; i < pending_count; ++i)
+    {
+        data.emplace_back(&ids[i % object_count], [] {});
+    }
+    size_t index = 0;
+    return sf_bench_ns(100, [&] {
+        std::lock_guard<std::mutex> lck(mu);
+        void *id = &ids[index++];
+        data.remove_if([=](const std::pair<void *, std::function<void()>> &dt) {
+            return dt.first == id;
+        });
+    });
+}
+
+double remove_ns()
+{
+    sf_msg_queue queue;
+    std::vector<int> ids(object_count);
+    for (size_t i = 0; i < pending_count; ++i)
+    {
+        queue.add_msg(&ids[i % object_count], [] {});
+    }
+    size_t index = 0;
+    return sf_bench_ns(object_count, [&] {
+        queue.remove_msg(&ids[index++]);
+    });
+}
+
+// 四分之一对象的消息已取消时取出所有有效消息，作废消息连续出现（每个对象的消息连续投递）
+void take_canceled(sf_bench_report &report)
+{
+    sf_msg_queue queue;
+    std::vector<int> ids(object_count);
+    auto per_object = pending_count / object_count;
+    for (size_t i = 0; i < object_count; ++i)
+    {
+        for (size_t j = 0; j < per_object; ++j)
+        {
+            queue.add_msg(&ids[i], [] {});
+        }
+    }
+    size_t canceled = 0;
+    for (size_t i = 0; i < object_count; i += 4)
+    {
+        queue.remove_msg(&ids[i]);
+        canceled += per_object;
+    }
+    auto valid = object_count * per_object - canceled;
+    report.add("take_canceled", "canceled_msgs", static_cast<double>(canceled));
+    report.add("take_canceled", "allocs_per_take", sf_bench_allocs(valid, [&] {
+        queue.take()();
+    }));
+}
+
+// 消息捕获的数据，统计未释放的数量
+struct payload_t
+{
+    static std::atomic<size_t> &live()
+    {
+        static std::atomic<size_t> count{0};
+        return count;
+    }
+
+    std::vector<char> data = std::vector<char>(64);
+
+    payload_t()
+    {
+        ++live();
+    }
+
+    payload_t(const payload_t &other) : data(other.data)
+    {
+        ++live();
+    }
+
+    ~payload_t()
+    {
+        --live();
+    }
+};
+
+// 事件循环没有运行（没有消费者）时析构所有对象，统计仍未释放的消息（作废消息由remove_msg整理释放）
+void teardown_no_consumer(sf_bench_report &report)
+{
+    sf_eventloop loop(sf_eventloop_mode::private_queue);
+    std::vector<std::unique_ptr<A>> objects;
+    for (size_t i = 0; i < object_count; ++i)
+    {
+        objects.emplace_back(new A);
+        objects.back()->move_to_thread(&loop);
+    }
+    auto queue = loop.get_msg_queue();
+    for (size_t i = 0; i < pending_count; ++i)
+    {
+        queue->add_msg(objects[i % object_count].get(), [payload = payload_t()] {});
+    }
+    auto begin = std::chrono::steady_clock::now();
+    objects.clear();
+    auto teardown_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+    report.add("teardown_no_consumer", "pending_msgs", pending_count);
+    report.add("teardown_no_consumer", "ns_per_object", teardown_ns / object_count);
+    report.add("teardown_no_consumer", "retained_msgs", static_cast<double>(payload_t::live().load()));
+}
+
+// 生产者持续投递消息时析构所有对象，统计析构耗时与生产者单次投递的最大延迟
+void teardown_under_load(sf_bench_report &report)
+{
+    sf_eventloop loop(sf_eventloop_mode::private_queue);
+    std::vector<std::unique_ptr<A>> objects;
+    for (size_t i = 0; i < object_count; ++i)
+    {
+        objects.emplace_back(new A);
+        objects.back()->move_to_thread(&loop);
+        sf_bind_signal(objects.back(), s1, [](int) {}, false);
+    }
+    for (size_t i = 0; i < pending_count; ++i)
+    {
+        objects[i % object_count]->s1(static_cast<int>(i));
+    }
+
+    std::atomic<bool> running{true};
+    std::atomic<long long> max_add_ns{0};
+    std::vector<std::thread> producers;
+    int producer_token = 0;
+    for (auto i = 0; i < 4; ++i)
+    {
+        producers.emplace_back([&] {
+            auto queue = loop.get_msg_queue();
+            while (running)
+            {
+                auto begin = std::chrono::steady_clock::now();
+                queue->add_msg(&producer_token, [] {});
+                auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - begin).count();
+                auto old = max_add_ns.load();
+                while (ns > old && !max_add_ns.compare_exchange_weak(old, ns))
+                {
+                }
+            }
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    max_add_ns = 0;
+    auto begin = std::chrono::steady_clock::now();
+    objects.clear();
+    auto teardown_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+    running = false;
+    for (auto &p : producers)
+    {
+        p.join();
+    }
+    report.add("teardown_under_load", "objects", object_count);
+    report.add("teardown_under_load", "pending_msgs", pending_count);
+    report.add("teardown_under_load", "ns_per_object", teardown_ns / object_count);
+    report.add("teardown_under_load", "producer_max_add_ns", static_cast<double>(max_add_ns.load()));
+}
+
+int main(int argc, char **argv)
+{
+    sf_bench_report report("msg_queue");
+    report.add("remove_msg_legacy_scan", "ns_per_op", legacy_remove_ns());
+    report.add("remove_msg", "ns_per_op", remove_ns());
+    take_canceled(report);
+    teardown_no_consumer(report);
+    teardown_under_load(report);
+    report.output(argc > 1 ? argv[1] : "");
+}
@@ -0,0 +1,331 @@
+/**
+* @version 1.0.0
+* @author skyfire
+* @mail skyfireitdiy@hotmail.com
+* @see http://github.com/skyfireitdiy/sflib
+* @file bench_object.cpp
+
+* sflib第一版本发布
+* 版本号1.0.0
+* 发布日期：2018-10-22
+*/
+
+/*
+ * sf_object基准测试，结果以JSON输出（可指定输出文件），用于回归比较：
+ *   baseline_*       普通函数调用、std::function调用
+ *   latency_*        直接连接与排队连接（普通事件循环/反应堆）从发射到槽函数执行的延迟
+ *   emit_N_slots_M_threads  N个槽函数、M个线程同时发射时的平均发射耗时
+ *   queued_*         排队槽函数每次发射的内存分配次数与耗时
+ *   aop_*            AOP包装调用与普通调用
+ *   static_aop_*     编译期AOP（空切面链、计数切面、计数+计时切面）与普通调用
+ */
+
+#define SF_BENCH_COUNT_ALLOC
+
+#include "sf_object.hpp"
+#include "sf_static_aop.hpp"
+#include "sf_tcp_utils.hpp"
+#include "bench_utils.h"
+#include <thread>
+
+using namespace skyfire;
+
+class A : public sf_object
+{
+    SF_REG_SIGNAL(s1, int)
+    SF_REG_SIGNAL(data_coming, SOCKET, const sf_pkg_header_t &, const byte_array &)
+};
+
+class B : public sf_object
+{
+public:
+    SF_REG_AOP(add, int, int)
+
+    SF_BENCH_NOINLINE int add(int a, int b)
+    {
+        return a + b;
+    }
+};
+
+class C
+{
+public:
+    SF_REG_STATIC_AOP(add)
+
+    SF_BENCH_NOINLINE int add(int a, int b)
+    {
+        return a + b;
+    }
+};
+
+class D
+{
+public:
+    SF_REG_STATIC_AOP(add, sf_counting_aspect)
+
+    SF_BENCH_NOINLINE int add(int a, int b)
+    {
+        return a + b;
+    }
+};
+
+class E
+{
+public:
+    SF_REG_STATIC_AOP(add, sf_counting_aspect, sf_timing_aspect)
+
+    SF_BENCH_NOINLINE int add(int a, int b)
+    {
+        return a + b;
+    }
+};
+
+SF_BENCH_NOINLINE void plain_slot(int n)
+{
+    sf_bench_keep(n);
+}
+
+// 旧实现：发射时持有递归锁遍历槽列表
+class legacy_signal
+{
+public:
+    std::recursive_mutex mu;
+    std::vector<std::tuple<std::function<void(int)>, bool, int>> vec;
+
+    void emit(int n)
+    {
+        std::lock_guard<std::recursive_mutex> lck(mu);
+        for (auto &p : vec)
+        {
+            std::get<0>(p)(n);
+        }
+    }
+};
+
+constexpr size_t iterations = 200000;
+
+// 旧实现的排队发射：std::bind包装后转为std::function投递（与新实现使用同一个消息队列）
+class legacy_queued_signal
+{
+public:
+    std::vector<std::function<void(SOCKET, const sf_pkg_header_t &, const byte_array &)>> vec;
+    std::shared_ptr<sf_msg_queue> queue;
+    std::recursive_mutex mu;
+
+    void emit(SOCKET sock, const sf_pkg_header_t &header, const byte_array &data)
+    {
+        std::lock_guard<std::recursive_mutex> lck(mu);
+        for (auto &p : vec)
+        {
+            auto bind_obj = std::bind(p, sock, header, data);
+            queue->add_msg(this, std::function<void()>(bind_obj));
+        }
+    }
+};
+
+void drain(sf_msg_queue &queue)
+{
+    while (auto func = queue.take())
+    {
+        func();
+    }
+}
+
+// 排队槽函数：每次发射（含执行）的分配次数与耗时
+void queued_emit(sf_bench_report &report)
+{
+    constexpr size_t queued_iterations = 100000;
+    sf_pkg_header_t header{};
+    for (auto payload_size : {0, 1024})
+    {
+        byte_array data(static_cast<size_t>(payload_size));
+        for (auto slot_count : {1, 4})
+        {
+            sf_eventloop loop(sf_eventloop_mode::private_queue);
+            auto queue = loop.get_msg_queue();
+            A a;
+            a.move_to_thread(&loop);
+            legacy_queued_signal legacy;
+            legacy.queue = queue;
+            for (auto i = 0; i < slot_count; ++i)
+            {
+                sf_bind_signal(&a, data_coming, [](SOCKET, const sf_pkg_header_t &, const byte_array &d) {
+                    sf_bench_keep(d);
+                }, false);
+                legacy.vec.emplace_back([](SOCKET, const sf_pkg_header_t &, const byte_array &d) {
+                    sf_bench_keep(d);
+                });
+            }
+            // 预热，使队列容量稳定
+            a.data_coming(0, header, data);
+            drain(*queue);
+
+            auto name = "queued_" + std::to_string(slot_count) + "_slots_" + std::to_string(payload_size) + "_bytes";
+            report.add(name, "allocs_per_emit", sf_bench_allocs(queued_iterations, [&] {
+                a.data_coming(0, header, data);
+                drain(*queue);
+            }));
+            report.add(name, "legacy_allocs_per_emit", sf_bench_allocs(queued_iterations, [&] {
+                legacy.emit(0, header, data);
+                drain(*queue);
+            }));
+            report.add(name, "ns_per_emit", sf_bench_ns(queued_iterations, [&] {
+                a.data_coming(0, header, data);
+                drain(*queue);
+            }));
+            report.add(name, "legacy_ns_per_emit", sf_bench_ns(queued_iterations, [&] {
+                legacy.emit(0, header, data);
+                drain(*queue);
+            }));
+        }
+    }
+}
+
+// 多个线程同时发射同一个信号，返回总耗时平摊到每次发射的纳秒数
+template<typename Func>
+double contended_ns(int thread_count, Func emit)
+{
+    std::vector<std::thread> threads;
+    std::atomic<int> ready{0};
+    auto begin = std::chrono::steady_clock::now();
+    for (auto i = 0; i < thread_count; ++i)
+    {
+        threads.emplace_back([&, i] {
+            ++ready;
+            while (ready != thread_count)
+            {
+                std::this_thread::yield();
+            }
+            for (size_t j = 0; j < iterations; ++j)
+            {
+                emit(i);
+            }
+        });
+    }
+    for (auto &p : threads)
+    {
+        p.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - begin).count() / (iterations * thread_count);
+}
+
+// 基准：普通函数调用与std::function调用
+void baseline(sf_bench_report &report)
+{
+    report.add("baseline_plain_call", "ns_per_call", sf_bench_ns(iterations, [] {
+        plain_slot(1);
+    }));
+    std::function<void(int)> func = plain_slot;
+    sf_bench_keep(func);
+    report.add("baseline_std_function", "ns_per_call", sf_bench_ns(iterations, [&] {
+        func(1);
+    }));
+}
+
+// 从发射到槽函数执行的延迟：直接连接在发射线程中执行；排队连接投递到另一个线程的事件循环，等待槽函数执行完毕
+void latency(sf_bench_report &report)
+{
+    constexpr size_t latency_iterations = 20000;
+    {
+        A a;
+        std::atomic<int> done{0};
+        sf_bind_signal(&a, s1, [&](int n) { done.store(n, std::memory_order_release); }, true);
+        int n = 0;
+        report.add("latency_direct", "ns_per_emit", sf_bench_ns(latency_iterations, [&] {
+            a.s1(++n);
+        }));
+    }
+    for (auto mode : {sf_eventloop_mode::private_queue, sf_eventloop_mode::reactor})
+    {
+        sf_eventloop loop(mode);
+        std::thread worker([&] { loop.exec(); });
+        A a;
+        a.move_to_thread(&loop);
+        std::atomic<int> done{0};
+        sf_bind_signal(&a, s1, [&](int n) { done.store(n, std::memory_order_release); }, false);
+        int n = 0;
+        auto name = std::string("latency_queued_") + (mode == sf_eventloop_mode::reactor ? "reactor" : "private_queue");
+        report.add(name, "ns_per_emit", sf_bench_ns(latency_iterations, [&] {
+            a.s1(++n);
+            while (done.load(std::memory_order_acquire) != n)
+            {
+                std::this_thread::yield();
+            }
+        }));
+        loop.quit();
+        worker.join();
+    }
+}
+
+// 不同槽数量、不同发射线程数下的发射耗时（直接连接）
+void contention(sf_bench_report &report)
+{
+    for (auto slot_count : {0, 1, 2, 4, 8, 16})
+    {
+        A a;
+        legacy_signal legacy;
+        for (auto i = 0; i < slot_count; ++i)
+        {
+            sf_bind_signal(&a, s1, [](int n) { sf_bench_keep(n); }, true);
+            legacy.vec.emplace_back([](int n) { sf_bench_keep(n); }, true, i);
+        }
+        for (auto thread_count : {1, 2, 4, 8})
+        {
+            auto name = "emit_" + std::to_string(slot_count) + "_slots_" + std::to_string(thread_count) + "_threads";
+            report.add(name, "ns_per_emit", contended_ns(thread_count, [&](int n) { a.s1(n); }));
+            report.add(name, "legacy_ns_per_emit", contended_ns(thread_count, [&](int n) { legacy.emit(n); }));
+        }
+    }
+}
+
+// AOP包装调用：无注入、注入前后各一个函数，与直接调用比较
+void aop(sf_bench_report &report)
+{
+    B b;
+    int n = 0;
+    report.add("aop_plain_call", "ns_per_call", sf_bench_ns(iterations, [&] {
+        sf_bench_keep(b.add(++n, 1));
+    }));
+    report.add("aop_no_hook", "ns_per_call", sf_bench_ns(iterations, [&] {
+        sf_bench_keep(b.aop_add(++n, 1));
+    }));
+    sf_aop_before_bind(&b, add, [](int a, int) { sf_bench_keep(a); });
+    sf_aop_after_bind(&b, add, [] {});
+    report.add("aop_before_after_hook", "ns_per_call", sf_bench_ns(iterations, [&] {
+        sf_bench_keep(b.aop_add(++n, 1));
+    }));
+}
+
+// 编译期AOP：空切面链应与直接调用相同
+void static_aop(sf_bench_report &report)
+{
+    C c;
+    D d;
+    E e;
+    int n = 0;
+    report.add("static_aop_plain_call", "ns_per_call", sf_bench_ns(iterations, [&] {
+        sf_bench_keep(c.add(++n, 1));
+    }));
+    report.add("static_aop_empty_chain", "ns_per_call", sf_bench_ns(iterations, [&] {
+        sf_bench_keep(c.aop_add(++n, 1));
+    }));
+    report.add("static_aop_counting", "ns_per_call", sf_bench_ns(iterations, [&] {
+        sf_bench_keep(d.aop_add(++n, 1));
+    }));
+    report.add("static_aop_counting_timing", "ns_per_call", sf_bench_ns(iterations, [&] {
+        sf_bench_keep(e.aop_add(++n, 1));
+    }));
+}
+
+int main(int argc, char **argv)
+{
+    sf_bench_report report("object");
+    baseline(report);
+    latency(report);
+    contention(report);
+    queued_emit(report);
+    aop(report);
+    static_aop(report);
+    report.output(argc > 1 ? argv[1] : "");
+}
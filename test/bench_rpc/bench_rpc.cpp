@@ -0,0 +1,268 @@
+/**
+* @version 1.0.0
+* @author skyfire
+* @mail skyfireitdiy@hotmail.com
+* @see http://github.com/skyfireitdiy/sflib
+* @file bench_rpc.cpp
+
+* sflib第一版本发布
+* 版本号1.0.0
+* 发布日期：2018-10-22
+*/
+
+/*
+ * sf_rpc_server请求分发基准测试，结果以JSON输出（可指定输出文件），用于回归比较。
+ * 以下为分发方式的模型（只包括查找与调用，不包括服务端的参数解析与返回），用于比较查找方式：
+ *   dispatch_scan_*   旧实现：依次调用所有注册的函数，每个函数比较函数id，1、50、500个注册函数
+ *   dispatch_hash_*   按函数id在unordered_map中查找后调用，1、50、500个注册函数
+ *   request_*         解析请求数据（sf_rpc_req_view_t）后分发，500个注册函数
+ *   not_found_hash    查找不存在的函数id
+ *   request_id_500    按函数编号的请求（sf_rpc_req_id_view_t）解析后按下标分发，500个注册函数
+ * 以下直接调用sf_rpc_server::__on_data_coming处理完整的请求数据包，包括参数解析、调用与生成返回数据包：
+ *   server_request_500     按函数id的请求，500个注册函数
+ *   server_request_id_500  按函数编号的请求，500个注册函数
+ *   server_not_found       不存在的函数id（返回错误数据包）
+ *   req_bytes_*       同一个短调用（两个int参数）按函数id与按函数编号的请求长度，native与compact方式
+ * 每次分发的请求在所有注册函数中轮流选择，计算每次分发的耗时与内存分配次数
+ */
+
+#define SF_BENCH_COUNT_ALLOC
+
+#include "sf_rpc_server.hpp"
+#include "bench_utils.h"
+
+#include <deque>
+#include <functional>
+#include <list>
+#include <string_view>
+#include <unordered_map>
+
+using namespace skyfire;
+
+using rpc_func_t = std::function<void(const sf_rpc_req_view_t &)>;
+
+// 旧实现：函数保存在vector中，每个函数内部比较函数id
+struct scan_dispatcher_t
+{
+    std::vector<rpc_func_t> funcs;
+
+    void reg(const std::string &id, size_t &counter)
+    {
+        funcs.push_back([id, &counter](const sf_rpc_req_view_t &req) {
+            if (req.func_id == id)
+            {
+                ++counter;
+            }
+        });
+    }
+
+    void dispatch(const sf_rpc_req_view_t &req) const
+    {
+        for (auto &p : funcs)
+        {
+            p(req);
+        }
+    }
+};
+
+// 哈希查找的模型：键指向链表中保存的函数id（sf_rpc_server中为函数表中保存的函数名）
+struct hash_dispatcher_t
+{
+    std::list<std::string> ids;
+    std::unordered_map<std::string_view, rpc_func_t> funcs;
+
+    void reg(const std::string &id, size_t &counter)
+    {
+        ids.push_back(id);
+        funcs.emplace(ids.back(), [&counter](const sf_rpc_req_view_t &) {
+            ++counter;
+        });
+    }
+
+    bool dispatch(const sf_rpc_req_view_t &req) const
+    {
+        auto iter = funcs.find(req.func_id);
+        if (iter == funcs.end())
+        {
+            return false;
+        }
+        iter->second(req);
+        return true;
+    }
+};
+
+std::string method_name(size_t i)
+{
+    return "user_service.get_user_info_" + std::to_string(i);
+}
+
+int main(int argc, char **argv)
+{
+    sf_bench_report report("rpc");
+    constexpr size_t iterations = 200000;
+
+    for (size_t count : {1, 50, 500})
+    {
+        size_t scan_counter = 0, hash_counter = 0;
+        scan_dispatcher_t scan;
+        hash_dispatcher_t hash;
+        std::vector<std::string> names;
+        for (size_t i = 0; i < count; ++i)
+        {
+            names.push_back(method_name(i));
+            scan.reg(names.back(), scan_counter);
+            hash.reg(names.back(), hash_counter);
+        }
+        std::vector<sf_rpc_req_view_t> reqs;
+        for (auto &name : names)
+        {
+            reqs.push_back(sf_rpc_req_view_t{1, name, {}});
+        }
+
+        size_t next = 0;
+        auto scan_dispatch = [&] {
+            scan.dispatch(reqs[next]);
+            next = next + 1 == reqs.size() ? 0 : next + 1;
+        };
+        auto hash_dispatch = [&] {
+            hash.dispatch(reqs[next]);
+            next = next + 1 == reqs.size() ? 0 : next + 1;
+        };
+        // NOTE 注册函数较多时旧实现很慢，按注册函数的数量减少执行次数
+        auto scan_iterations = std::max<size_t>(iterations / count, 1000);
+        auto suffix = std::to_string(count);
+        report.add("dispatch_scan_" + suffix, "ns", sf_bench_ns(scan_iterations, scan_dispatch));
+        report.add("dispatch_scan_" + suffix, "allocs", sf_bench_allocs(scan_iterations, scan_dispatch));
+        report.add("dispatch_hash_" + suffix, "ns", sf_bench_ns(iterations, hash_dispatch));
+        report.add("dispatch_hash_" + suffix, "allocs", sf_bench_allocs(iterations, hash_dispatch));
+        // NOTE 每个请求恰好调用一个函数
+        if (scan_counter != scan_iterations * 2 || hash_counter != iterations * 2)
+        {
+            std::cerr << "dispatch mismatch" << std::endl;
+            return 1;
+        }
+
+        if (count != 500)
+        {
+            continue;
+        }
+
+        // 完整的请求：从请求数据中解析sf_rpc_req_view_t（不复制函数id与参数）后分发
+        std::vector<byte_array> bodies;
+        for (auto &name : names)
+        {
+            bodies.push_back(sf_serialize_binary(
+                    sf_rpc_req_context_t{1, name, sf_serialize_binary(42, std::string("skyfire"))}));
+        }
+        auto request = [&](auto &dispatcher) {
+            return [&] {
+                sf_rpc_req_view_t req;
+                sf_deserialize_binary(bodies[next], req, 0);
+                dispatcher.dispatch(req);
+                next = next + 1 == bodies.size() ? 0 : next + 1;
+            };
+        };
+        next = 0;
+        report.add("request_scan_500", "ns", sf_bench_ns(scan_iterations, request(scan)));
+        report.add("request_hash_500", "ns", sf_bench_ns(iterations, request(hash)));
+        report.add("request_hash_500", "allocs", sf_bench_allocs(iterations, request(hash)));
+
+        sf_rpc_req_view_t missing{1, "user_service.get_user_info_missing", {}};
+        auto not_found = 0;
+        report.add("not_found_hash", "ns", sf_bench_ns(iterations, [&] {
+            not_found += hash.dispatch(missing) ? 0 : 1;
+        }));
+        sf_bench_keep(not_found);
+
+        // 按函数编号的模型：函数表为deque，下标为函数编号
+        std::deque<rpc_func_t> table;
+        size_t id_counter = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            table.push_back([&id_counter](const sf_rpc_req_view_t &) {
+                ++id_counter;
+            });
+        }
+        std::vector<byte_array> id_bodies;
+        for (size_t i = 0; i < count; ++i)
+        {
+            sf_binary_writer writer;
+            sf_serialize_binary_to(writer, static_cast<int>(1));
+            sf_serialize_binary_to(writer, static_cast<int>(i));
+            sf_serialize_binary_to(writer, sf_serialize_binary(42, std::string("skyfire")));
+            id_bodies.push_back(writer.buffer());
+        }
+        next = 0;
+        report.add("request_id_500", "ns", sf_bench_ns(iterations, [&] {
+            sf_rpc_req_id_view_t req;
+            sf_deserialize_binary(id_bodies[next], req, 0);
+            if (req.method_id >= 0 && static_cast<size_t>(req.method_id) < table.size())
+            {
+                table[req.method_id](sf_rpc_req_view_t{req.call_id, names[req.method_id], req.params});
+            }
+            next = next + 1 == id_bodies.size() ? 0 : next + 1;
+        }));
+        if (id_counter != iterations)
+        {
+            std::cerr << "dispatch mismatch" << std::endl;
+            return 1;
+        }
+
+        // 服务端：注册顺序即函数编号，请求数据包与从连接收到的相同
+        // NOTE 返回写入无效的socket，写入失败，只计算生成返回数据包与一次系统调用
+        auto server = sf_rpc_server::make_server();
+        size_t server_counter = 0;
+        for (auto &name : names)
+        {
+            server->reg_rpc_func(name, [&server_counter](int a, std::string) {
+                ++server_counter;
+                return a;
+            });
+        }
+        auto sock = static_cast<SOCKET>(-1);
+        auto server_request = [&](int type, const std::vector<byte_array> &frames) {
+            return [&, type] {
+                sf_pkg_header_t header{};
+                header.type = type;
+                header.length = frames[next].size();
+                server->__on_data_coming(sock, header, frames[next]);
+                next = next + 1 == frames.size() ? 0 : next + 1;
+            };
+        };
+        next = 0;
+        report.add("server_request_500", "ns", sf_bench_ns(iterations, server_request(RPC_REQ_TYPE, bodies)));
+        report.add("server_request_500", "allocs",
+                   sf_bench_allocs(iterations, server_request(RPC_REQ_TYPE, bodies)));
+        report.add("server_request_id_500", "ns",
+                   sf_bench_ns(iterations, server_request(RPC_REQ_ID_TYPE, id_bodies)));
+        report.add("server_request_id_500", "allocs",
+                   sf_bench_allocs(iterations, server_request(RPC_REQ_ID_TYPE, id_bodies)));
+        if (server_counter != iterations * 4)
+        {
+            std::cerr << "dispatch mismatch" << std::endl;
+            return 1;
+        }
+        std::vector<byte_array> missing_bodies{sf_serialize_binary(sf_rpc_req_context_t{
+                1, "user_service.get_user_info_missing", sf_serialize_binary(42, std::string("skyfire"))})};
+        next = 0;
+        report.add("server_not_found", "ns", sf_bench_ns(iterations, server_request(RPC_REQ_TYPE, missing_bodies)));
+    }
+
+    for (auto profile : {sf_binary_profile::native, sf_binary_profile::compact})
+    {
+        auto params = sf_serialize_binary(std::tuple<int, int>{3, 4});
+        sf_binary_writer name_writer(profile), id_writer(profile);
+        sf_serialize_binary_to(name_writer, 1);
+        sf_serialize_binary_to(name_writer, method_name(499));
+        sf_serialize_binary_to(name_writer, params);
+        sf_serialize_binary_to(id_writer, 1);
+        sf_serialize_binary_to(id_writer, 499);
+        sf_serialize_binary_to(id_writer, params);
+        auto suffix = profile == sf_binary_profile::native ? "native" : "compact";
+        report.add(std::string("req_bytes_") + suffix, "by_name", static_cast<double>(name_writer.size()));
+        report.add(std::string("req_bytes_") + suffix, "by_id", static_cast<double>(id_writer.size()));
+    }
+
+    report.output(argc > 1 ? argv[1] : "");
+    return 0;
+}
@@ -0,0 +1,550 @@
+/**
+* @version 1.0.0
+* @author skyfire
+* @mail skyfireitdiy@hotmail.com
+* @see http://github.com/skyfireitdiy/sflib
+* @file bench_serialize.cpp
+
+* sflib第一版本发布
+* 版本号1.0.0
+* 发布日期：2018-10-22
+*/
+
+/*
+ * sf_serialize_binary基准测试，结果以JSON输出（可指定输出文件），用于回归比较：
+ *   vector_string_*   10000个字符串的vector：旧实现（每个元素返回新的byte_array）、sf_serialize_binary、
+ *                     复用sf_binary_writer、写入栈上pmr缓冲区，每次序列化的内存分配次数与耗时
+ *   vector_double_*   100万个double的序列化/反序列化：旧实现（逐个元素）与整体memcpy，耗时与吞吐量（GB/s）
+ *   string_*          1MB字符串的反序列化：旧实现（先复制到vector<char>）与整体memcpy
+ *   msg_bus_decode_*  解析4KB的消息总线数据：反序列化为sf_msg_bus_t与sf_msg_bus_view_t（视图，不复制）
+ *   rpc_frame_*       生成rpc请求数据包（64KB参数）：旧实现（参数、请求、包头依次复制）与按sf_serialized_size一次写入
+ *   profile_*         10000条小整数与短字符串组成的记录：native、compact与portable方式的序列化长度与序列化/反序列化耗时
+ *   stream_decode     同样的记录按4KB分段输入sf_binary_reader增量反序列化：耗时与缓冲区中最多保留的字节数
+ *   roundtrip_*       各类数据（pod、pod的vector、字符串、嵌套map、tuple、rpc请求、nat穿透上下文）分别调用
+ *                     sf_serialize_binary与sf_deserialize_binary：吞吐量（MB/s）与每次操作的内存分配次数
+ *   baseline_*        基线：同样长度的memcpy、按内存原样复制的定长结构
+ *   compress_*        2KB与64KB类json消息的数据包压缩：复用z_stream的sf_pkg_compressor与每次重新初始化的sf_deflate_compress，
+ *                     耗时、吞吐量与压缩比
+ *   byte_swap_*       100万个double反转字节序（大端主机上portable方式的数组编解码）：逐个元素与sf_byte_swap_copy
+ */
+
+#define SF_BENCH_COUNT_ALLOC
+
+#include "sf_serialize_binary.hpp"
+#include "sf_rpc_utils.h"
+#include "sf_msg_bus_utils.h"
+#include "sf_tcp_utils.hpp"
+#include "sf_tcp_nat_traversal_utils.h"
+#include "sf_pkg_compress.hpp"
+#include "sf_utils.hpp"
+#include "bench_utils.h"
+
+namespace skyfire
+{
+    // 典型的小消息：整数值都比较小，字符串比较短
+    struct record_t
+    {
+        int id;
+        short level;
+        long long delta;
+        unsigned int flags;
+        std::string name;
+    };
+
+    SF_MAKE_SERIALIZABLE_BINARY(record_t, id, level, delta, flags, name)
+
+    // 与sf_tcp_nat_traversal_context_t__字段相同的定长结构（ip使用定长数组），作为结构序列化的基线
+    struct plain_context_t
+    {
+        int connect_id;
+        unsigned long long src_id;
+        char src_ip[16];
+        unsigned short src_port;
+        unsigned long long dest_id;
+        char dest_ip[16];
+        unsigned short dest_port;
+        int error_code;
+        int step;
+        bool raw;
+    };
+}
+
+using namespace skyfire;
+
+// 旧实现：每个元素序列化为新的byte_array后追加
+byte_array legacy_serialize(size_t value)
+{
+    byte_array ret(sizeof(value));
+    memcpy(ret.data(), &value, sizeof(value));
+    return ret;
+}
+
+byte_array legacy_serialize(char value)
+{
+    byte_array ret(sizeof(value));
+    memcpy(ret.data(), &value, sizeof(value));
+    return ret;
+}
+
+byte_array legacy_serialize(const std::vector<char> &value)
+{
+    byte_array ret;
+    auto tmp_ret = legacy_serialize(value.size());
+    ret.insert(ret.end(), tmp_ret.begin(), tmp_ret.end());
+    for (auto const &p : value)
+    {
+        tmp_ret = legacy_serialize(p);
+        ret.insert(ret.end(), tmp_ret.begin(), tmp_ret.end());
+    }
+    return ret;
+}
+
+byte_array legacy_serialize(const std::string &value)
+{
+    std::vector<char> tmp_obj(value.begin(), value.end());
+    return legacy_serialize(tmp_obj);
+}
+
+byte_array legacy_serialize(const std::vector<std::string> &value)
+{
+    byte_array ret;
+    auto tmp_ret = legacy_serialize(value.size());
+    ret.insert(ret.end(), tmp_ret.begin(), tmp_ret.end());
+    for (auto const &p : value)
+    {
+        tmp_ret = legacy_serialize(p);
+        ret.insert(ret.end(), tmp_ret.begin(), tmp_ret.end());
+    }
+    return ret;
+}
+
+byte_array legacy_serialize(double value)
+{
+    byte_array ret(sizeof(value));
+    memcpy(ret.data(), &value, sizeof(value));
+    return ret;
+}
+
+byte_array legacy_serialize(const std::vector<double> &value)
+{
+    byte_array ret;
+    auto tmp_ret = legacy_serialize(value.size());
+    ret.insert(ret.end(), tmp_ret.begin(), tmp_ret.end());
+    for (auto const &p : value)
+    {
+        tmp_ret = legacy_serialize(p);
+        ret.insert(ret.end(), tmp_ret.begin(), tmp_ret.end());
+    }
+    return ret;
+}
+
+// 旧实现的反序列化：逐个元素检查长度后复制
+template<typename T>
+size_t legacy_deserialize(const byte_array &data, std::vector<T> &obj, size_t begin_pos)
+{
+    obj.clear();
+    size_t len;
+    auto offset = sf_deserialize_binary(data, len, begin_pos);
+    obj.resize(len);
+    for (size_t i = 0; i < len; ++i)
+    {
+        offset = sf_deserialize_binary(data, obj[i], offset);
+    }
+    return offset;
+}
+
+size_t legacy_deserialize(const byte_array &data, std::string &obj, size_t begin_pos)
+{
+    std::vector<char> tmp_obj;
+    auto ret = legacy_deserialize(data, tmp_obj, begin_pos);
+    obj = std::string(tmp_obj.begin(), tmp_obj.end());
+    return ret;
+}
+
+/**
+ * 测试一种数据的序列化与反序列化（每次反序列化到新对象，包含对象自身的分配）
+ * @param report 报告
+ * @param name 用例名称
+ * @param value 数据
+ * @param iterations 执行次数
+ * @return 反序列化结果是否与原数据相同
+ */
+template<typename T>
+bool bench_round_trip(sf_bench_report &report, const std::string &name, const T &value, size_t iterations)
+{
+    auto data = sf_serialize_binary(value);
+    auto serialize = [&] {
+        sf_bench_keep(sf_serialize_binary(value));
+    };
+    auto deserialize = [&] {
+        T out;
+        sf_deserialize_binary(data, out, 0);
+        sf_bench_keep(out);
+    };
+    auto mb = static_cast<double>(data.size()) / (1024 * 1024);
+    report.add(name, "bytes", data.size());
+    report.add(name, "serialize_mb_per_s", mb * 1e9 / sf_bench_ns(iterations, serialize));
+    report.add(name, "serialize_allocs", sf_bench_allocs(iterations, serialize));
+    report.add(name, "deserialize_mb_per_s", mb * 1e9 / sf_bench_ns(iterations, deserialize));
+    report.add(name, "deserialize_allocs", sf_bench_allocs(iterations, deserialize));
+    T out;
+    sf_deserialize_binary(data, out, 0);
+    return sf_serialize_binary(out) == data;
+}
+
+int main(int argc, char **argv)
+{
+    sf_bench_report report("serialize");
+
+    std::vector<std::string> strings;
+    for (auto i = 0; i < 10000; ++i)
+    {
+        strings.push_back("item_" + std::to_string(i) + "_of_the_benchmark");
+    }
+    if (legacy_serialize(strings) != sf_serialize_binary(strings))
+    {
+        std::cerr << "output mismatch" << std::endl;
+        return 1;
+    }
+
+    constexpr size_t iterations = 50;
+    auto legacy = [&] {
+        sf_bench_keep(legacy_serialize(strings));
+    };
+    report.add("vector_string_legacy", "allocs", sf_bench_allocs(iterations, legacy));
+    report.add("vector_string_legacy", "ns", sf_bench_ns(iterations, legacy));
+
+    auto wrapper = [&] {
+        sf_bench_keep(sf_serialize_binary(strings));
+    };
+    report.add("vector_string_serialize", "allocs", sf_bench_allocs(iterations, wrapper));
+    report.add("vector_string_serialize", "ns", sf_bench_ns(iterations, wrapper));
+
+    byte_array buffer;
+    auto reuse = [&] {
+        buffer.clear();
+        sf_binary_writer writer(buffer);
+        sf_serialize_binary_to(writer, strings);
+        sf_bench_keep(buffer);
+    };
+    reuse();
+    report.add("vector_string_writer_reuse", "allocs", sf_bench_allocs(iterations, reuse));
+    report.add("vector_string_writer_reuse", "ns", sf_bench_ns(iterations, reuse));
+
+    std::vector<char> arena(1024 * 1024);
+    auto pmr = [&] {
+        std::pmr::monotonic_buffer_resource resource(arena.data(), arena.size());
+        std::pmr::vector<char> pmr_buffer(&resource);
+        sf_pmr_binary_writer writer(pmr_buffer);
+        sf_serialize_binary_to(writer, strings);
+        sf_bench_keep(pmr_buffer);
+    };
+    report.add("vector_string_writer_pmr", "allocs", sf_bench_allocs(iterations, pmr));
+    report.add("vector_string_writer_pmr", "ns", sf_bench_ns(iterations, pmr));
+
+    std::vector<double> doubles(1000000);
+    for (size_t i = 0; i < doubles.size(); ++i)
+    {
+        doubles[i] = static_cast<double>(i) * 0.5;
+    }
+    auto double_bytes = static_cast<double>(doubles.size() * sizeof(double));
+    auto add_throughput = [&](const std::string &name, double ns) {
+        report.add(name, "ns", ns);
+        report.add(name, "gb_per_s", double_bytes / ns);
+    };
+    auto double_data = sf_serialize_binary(doubles);
+    if (legacy_serialize(doubles) != double_data)
+    {
+        std::cerr << "output mismatch" << std::endl;
+        return 1;
+    }
+    constexpr size_t double_iterations = 20;
+    add_throughput("vector_double_serialize_legacy", sf_bench_ns(double_iterations, [&] {
+        sf_bench_keep(legacy_serialize(doubles));
+    }));
+    byte_array double_buffer;
+    add_throughput("vector_double_serialize_memcpy", sf_bench_ns(double_iterations, [&] {
+        double_buffer.clear();
+        sf_binary_writer writer(double_buffer);
+        sf_serialize_binary_to(writer, doubles);
+        sf_bench_keep(double_buffer);
+    }));
+    std::vector<double> double_out;
+    add_throughput("vector_double_deserialize_legacy", sf_bench_ns(double_iterations, [&] {
+        legacy_deserialize(double_data, double_out, 0);
+        sf_bench_keep(double_out);
+    }));
+    add_throughput("vector_double_deserialize_memcpy", sf_bench_ns(double_iterations, [&] {
+        sf_deserialize_binary(double_data, double_out, 0);
+        sf_bench_keep(double_out);
+    }));
+    if (double_out != doubles)
+    {
+        std::cerr << "output mismatch" << std::endl;
+        return 1;
+    }
+
+    auto string_data = sf_serialize_binary(std::string(1024 * 1024, 'x'));
+    std::string string_out;
+    report.add("string_deserialize_legacy", "ns", sf_bench_ns(double_iterations, [&] {
+        legacy_deserialize(string_data, string_out, 0);
+        sf_bench_keep(string_out);
+    }));
+    report.add("string_deserialize_memcpy", "ns", sf_bench_ns(double_iterations, [&] {
+        sf_deserialize_binary(string_data, string_out, 0);
+        sf_bench_keep(string_out);
+    }));
+
+    std::tuple<int, std::string, std::vector<double>> param{1, "param", std::vector<double>(8192, 1.0)};
+    auto legacy_frame = [&] {
+        sf_rpc_req_context_t req;
+        req.call_id = 1;
+        req.func_id = "func";
+        req.params = sf_serialize_binary(param);
+        auto body = sf_serialize_binary(req);
+        sf_pkg_header_t header{};
+        header.type = 1;
+        header.length = body.size();
+        make_header_checksum(header);
+        return make_pkg(header) + body;
+    };
+    auto new_frame = [&] {
+        int call_id = 1;
+        std::string func_id = "func";
+        auto length = sf_serialized_size(call_id) + sf_serialized_size(func_id) + sizeof(size_t)
+                      + sf_serialized_size(param);
+        return sf_make_pkg_frame(1, length, [&](byte_array &buffer) {
+            sf_binary_writer writer(buffer);
+            sf_serialize_binary_to(writer, call_id);
+            sf_serialize_binary_to(writer, func_id);
+            auto pos = writer.begin_block();
+            sf_serialize_binary_to(writer, param);
+            writer.end_block(pos);
+        });
+    };
+    if (legacy_frame() != new_frame())
+    {
+        std::cerr << "output mismatch" << std::endl;
+        return 1;
+    }
+    constexpr size_t frame_iterations = 2000;
+    auto legacy_frame_keep = [&] {
+        sf_bench_keep(legacy_frame());
+    };
+    auto new_frame_keep = [&] {
+        sf_bench_keep(new_frame());
+    };
+    report.add("rpc_frame_legacy", "allocs", sf_bench_allocs(frame_iterations, legacy_frame_keep));
+    report.add("rpc_frame_legacy", "ns", sf_bench_ns(frame_iterations, legacy_frame_keep));
+    report.add("rpc_frame_sized", "allocs", sf_bench_allocs(frame_iterations, new_frame_keep));
+    report.add("rpc_frame_sized", "ns", sf_bench_ns(frame_iterations, new_frame_keep));
+
+    sf_msg_bus_t msg{"topic/with/a/longer/name", byte_array(4096, 'x')};
+    auto msg_data = sf_serialize_binary(msg);
+    auto owned_decode = [&] {
+        sf_msg_bus_t out;
+        sf_deserialize_binary(msg_data, out, 0);
+        sf_bench_keep(out);
+    };
+    auto view_decode = [&] {
+        sf_msg_bus_view_t out;
+        sf_deserialize_binary(msg_data, out, 0);
+        sf_bench_keep(out);
+    };
+    report.add("msg_bus_decode_owned", "allocs", sf_bench_allocs(frame_iterations, owned_decode));
+    report.add("msg_bus_decode_owned", "ns", sf_bench_ns(frame_iterations, owned_decode));
+    report.add("msg_bus_decode_view", "allocs", sf_bench_allocs(frame_iterations, view_decode));
+    report.add("msg_bus_decode_view", "ns", sf_bench_ns(frame_iterations, view_decode));
+
+    std::vector<record_t> records;
+    for (auto i = 0; i < 10000; ++i)
+    {
+        records.push_back({i % 500, static_cast<short>(i % 5), (i % 2 ? -1 : 1) * (i % 100),
+                           static_cast<unsigned int>(i % 3), "rec" + std::to_string(i % 100)});
+    }
+    constexpr size_t profile_iterations = 200;
+    for (auto profile : {sf_binary_profile::native, sf_binary_profile::compact, sf_binary_profile::portable})
+    {
+        std::string name = profile == sf_binary_profile::native ? "profile_native"
+                           : profile == sf_binary_profile::compact ? "profile_compact" : "profile_portable";
+        byte_array profile_buffer;
+        auto profile_serialize = [&] {
+            profile_buffer.clear();
+            sf_binary_writer writer(profile_buffer, profile);
+            sf_serialize_binary_to(writer, records);
+            sf_bench_keep(profile_buffer);
+        };
+        profile_serialize();
+        std::vector<record_t> records_out;
+        auto profile_deserialize = [&] {
+            sf_binary_cursor cursor(profile_buffer, 0, profile);
+            sf_deserialize_binary_from(cursor, records_out);
+            sf_bench_keep(records_out);
+        };
+        profile_deserialize();
+        if (records_out.size() != records.size() || records_out.back().name != records.back().name
+            || records_out.back().delta != records.back().delta)
+        {
+            std::cerr << "output mismatch" << std::endl;
+            return 1;
+        }
+        report.add(name, "bytes", profile_buffer.size());
+        report.add(name, "serialize_ns", sf_bench_ns(profile_iterations, profile_serialize));
+        report.add(name, "deserialize_ns", sf_bench_ns(profile_iterations, profile_deserialize));
+    }
+
+    auto record_data = sf_serialize_binary(records);
+    constexpr size_t chunk_size = 4096;
+    size_t max_buffered = 0;
+    auto stream_decode = [&] {
+        sf_binary_reader reader;
+        std::vector<record_t> records_out;
+        for (size_t pos = 0; pos < record_data.size(); pos += chunk_size)
+        {
+            reader.feed(record_data.data() + pos, std::min(chunk_size, record_data.size() - pos));
+            max_buffered = std::max(max_buffered, reader.buffered());
+            if (reader.read(records_out) != sf_binary_read_status::need_more)
+            {
+                break;
+            }
+        }
+        sf_bench_keep(records_out);
+    };
+    report.add("stream_decode", "ns", sf_bench_ns(profile_iterations, stream_decode));
+    report.add("stream_decode", "max_buffered_bytes", max_buffered);
+
+    constexpr size_t round_trip_iterations = 2000;
+    std::map<std::string, std::map<int, std::vector<double>>> nested;
+    for (auto i = 0; i < 16; ++i)
+    {
+        for (auto j = 0; j < 16; ++j)
+        {
+            nested["group_" + std::to_string(i)][j] = std::vector<double>(8, i * 0.5 + j);
+        }
+    }
+    sf_rpc_req_context_t rpc_req{1, "get_user_info", sf_serialize_binary(42, std::string("skyfire"))};
+    sf_tcp_nat_traversal_context_t__ nat_context{1, 0x1234, {"192.168.100.200", 8080}, 0x5678,
+                                                {"10.0.0.1", 9090}, 0, 2, false};
+    auto ok = bench_round_trip(report, "roundtrip_pod", 3.1415926, round_trip_iterations)
+              && bench_round_trip(report, "roundtrip_vector_pod", std::vector<int>(16384, 7), round_trip_iterations)
+              && bench_round_trip(report, "roundtrip_string", std::string(65536, 's'), round_trip_iterations)
+              && bench_round_trip(report, "roundtrip_vector_string", strings, 20)
+              && bench_round_trip(report, "roundtrip_nested_map", nested, 200)
+              && bench_round_trip(report, "roundtrip_tuple",
+                                  std::make_tuple(1, std::string("tuple"), 2.5, std::vector<short>(64, 3)),
+                                  round_trip_iterations)
+              && bench_round_trip(report, "roundtrip_rpc_req", rpc_req, round_trip_iterations)
+              && bench_round_trip(report, "roundtrip_nat_context", nat_context, round_trip_iterations);
+    if (!ok)
+    {
+        std::cerr << "output mismatch" << std::endl;
+        return 1;
+    }
+
+    // NOTE 基线与roundtrip_*使用相同的度量方式：每次分配新的byte_array
+    byte_array memcpy_src(65536, 'm');
+    auto memcpy_mb = static_cast<double>(memcpy_src.size()) / (1024 * 1024);
+    auto memcpy_copy = [&] {
+        byte_array dst(memcpy_src.size());
+        memcpy(dst.data(), memcpy_src.data(), memcpy_src.size());
+        sf_bench_keep(dst);
+    };
+    report.add("baseline_memcpy", "bytes", memcpy_src.size());
+    report.add("baseline_memcpy", "mb_per_s", memcpy_mb * 1e9 / sf_bench_ns(round_trip_iterations, memcpy_copy));
+    report.add("baseline_memcpy", "allocs", sf_bench_allocs(round_trip_iterations, memcpy_copy));
+    plain_context_t plain_context{1, 0x1234, "192.168.100.200", 8080, 0x5678, "10.0.0.1", 9090, 0, 2, false};
+    auto plain_mb = static_cast<double>(sizeof(plain_context)) / (1024 * 1024);
+    auto plain_copy = [&] {
+        byte_array dst(sizeof(plain_context));
+        memcpy(dst.data(), &plain_context, sizeof(plain_context));
+        plain_context_t out;
+        memcpy(&out, dst.data(), sizeof(out));
+        sf_bench_keep(out);
+    };
+    report.add("baseline_plain_struct", "bytes", sizeof(plain_context));
+    report.add("baseline_plain_struct", "round_trip_mb_per_s",
+               plain_mb * 1e9 / sf_bench_ns(round_trip_iterations, plain_copy));
+    report.add("baseline_plain_struct", "allocs", sf_bench_allocs(round_trip_iterations, plain_copy));
+
+    // NOTE 小数据包（刚超过默认阈值）上z_stream初始化的开销更明显
+    auto bench_compress = [&](const std::string &suffix, size_t blob_size) {
+        std::string json_blob;
+        for (auto i = 0; json_blob.size() < blob_size; ++i)
+        {
+            json_blob += R"({"id":)" + std::to_string(i) + R"(,"name":"user_)" + std::to_string(i % 97)
+                         + R"(","tags":["bus","msg"],"score":)" + std::to_string(i * 1.5) + "},";
+        }
+        auto blob_frame = sf_make_pkg_frame(msg_bus_new_msg, 0, json_blob.size() + 64, [&](byte_array &buffer) {
+            sf_binary_writer writer(buffer);
+            sf_serialize_binary_to(writer, std::string("topic"));
+            sf_serialize_binary_to(writer, json_blob);
+        });
+        auto blob_body = byte_array(blob_frame.begin() + sizeof(sf_pkg_header_t), blob_frame.end());
+        auto blob_mb = static_cast<double>(blob_body.size()) / (1024 * 1024);
+        auto iterations = 64 * 1024 * 200 / blob_size;
+        sf_pkg_compress_option_t compress_option;
+        compress_option.enable = true;
+        sf_pkg_compressor compressor(compress_option);
+        byte_array compressed_frame;
+        auto reused = [&] {
+            compressed_frame = blob_frame;
+            compressor.compress_frame(compressed_frame);
+            sf_bench_keep(compressed_frame);
+        };
+        auto reused_ns = sf_bench_ns(iterations, reused);
+        report.add("compress_reused" + suffix, "ns", reused_ns);
+        report.add("compress_reused" + suffix, "mb_per_s", blob_mb * 1e9 / reused_ns);
+        report.add("compress_reused" + suffix, "ratio", compressor.stat().ratio());
+        report.add("compress_reused" + suffix, "allocs", sf_bench_allocs(iterations, reused));
+        // NOTE sf_deflate_compress使用compress()，每次调用都初始化并释放z_stream
+        auto per_call = [&] {
+            byte_array copy = blob_body;
+            sf_bench_keep(sf_deflate_compress(copy));
+        };
+        auto per_call_ns = sf_bench_ns(iterations, per_call);
+        report.add("compress_per_call" + suffix, "ns", per_call_ns);
+        report.add("compress_per_call" + suffix, "mb_per_s", blob_mb * 1e9 / per_call_ns);
+        report.add("compress_per_call" + suffix, "ratio", static_cast<double>(sf_deflate_compress(blob_body).size())
+                                                          / static_cast<double>(blob_body.size()));
+        report.add("compress_per_call" + suffix, "allocs", sf_bench_allocs(iterations, per_call));
+        sf_pkg_header_t compressed_header;
+        memcpy(&compressed_header, compressed_frame.data(), sizeof(compressed_header));
+        byte_array compressed_body(compressed_frame.begin() + sizeof(compressed_header), compressed_frame.end());
+        byte_array decompressed;
+        unsigned char blob_flags;
+        size_t blob_offset;
+        auto decompress_ns = sf_bench_ns(iterations, [&] {
+            sf_bench_keep(sf_take_pkg_body(compressed_header, compressed_body, blob_flags, blob_offset, decompressed,
+                                           &compressor));
+        });
+        report.add("compress_decompress" + suffix, "ns", decompress_ns);
+        report.add("compress_decompress" + suffix, "mb_per_s", blob_mb * 1e9 / decompress_ns);
+        return decompressed == blob_body;
+    };
+    if (!bench_compress("_2k", 2 * 1024) || !bench_compress("_64k", 64 * 1024))
+    {
+        std::cerr << "output mismatch" << std::endl;
+        return 1;
+    }
+
+    std::vector<double> swapped(doubles.size());
+    add_throughput("byte_swap_scalar", sf_bench_ns(double_iterations, [&] {
+        for (size_t i = 0; i < doubles.size(); ++i)
+        {
+            swapped[i] = sf_byte_swap(doubles[i]);
+        }
+        sf_bench_keep(swapped);
+    }));
+    add_throughput("byte_swap_copy", sf_bench_ns(double_iterations, [&] {
+        sf_byte_swap_copy(swapped.data(), doubles.data(), doubles.size(), sizeof(double));
+        sf_bench_keep(swapped);
+    }));
+    if (sf_byte_swap(swapped.back()) != doubles.back())
+    {
+        std::cerr << "output mismatch" << std::endl;
+        return 1;
+    }
+
+    report.output(argc > 1 ? argv[1] : "");
+    return 0;
+}
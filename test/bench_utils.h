@@ -0,0 +1,273 @@
+/**
+* @version 1.0.0
+* @author skyfire
+* @mail skyfireitdiy@hotmail.com
+* @see http://github.com/skyfireitdiy/sflib
+* @file bench_utils.h
+
+* sflib第一版本发布
+* 版本号1.0.0
+* 发布日期：2018-10-22
+*/
+
+/*
+ * bench_utils 基准测试工具（计时、结果以JSON输出）
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SF_BENCH_NOINLINE __attribute__((noinline))
+#else
+#define SF_BENCH_NOINLINE __declspec(noinline)
+#endif
+
+namespace skyfire
+{
+    /**
+     * 防止编译器优化掉基准测试中的计算结果
+     * @tparam T 类型
+     * @param value 值
+     */
+    template<typename T>
+    inline void sf_bench_keep(T &&value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "g"(&value) : "memory");
+#else
+        static volatile const void *sink;
+        sink = &value;
+#endif
+    }
+
+    /**
+     * 计算函数平均执行时间
+     * @tparam Func 函数类型
+     * @param iterations 执行次数
+     * @param func 函数
+     * @return 每次执行的平均纳秒数
+     */
+    template<typename Func>
+    inline double sf_bench_ns(size_t iterations, Func &&func)
+    {
+        auto begin = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            func();
+        }
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - begin).count() / static_cast<double>(iterations);
+    }
+
+    /**
+     * 堆内存分配计数（需要在包含本文件前定义SF_BENCH_COUNT_ALLOC才会统计）
+     * @return 计数器
+     */
+    inline std::atomic<size_t> &sf_bench_alloc_count()
+    {
+        static std::atomic<size_t> count{0};
+        return count;
+    }
+
+    /**
+     * 计算函数每次执行的平均堆内存分配次数
+     * @tparam Func 函数类型
+     * @param iterations 执行次数
+     * @param func 函数
+     * @return 平均分配次数
+     */
+    template<typename Func>
+    inline double sf_bench_allocs(size_t iterations, Func &&func)
+    {
+        auto begin = sf_bench_alloc_count().load();
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            func();
+        }
+        return static_cast<double>(sf_bench_alloc_count().load() - begin) / static_cast<double>(iterations);
+    }
+
+    /**
+     *  @brief 基准测试报告，每个用例包含若干数值指标，以JSON格式输出，便于回归比较
+     */
+    class sf_bench_report
+    {
+    public:
+        /**
+         * @param suite 测试集名称
+         */
+        explicit sf_bench_report(std::string suite) : suite__(std::move(suite))
+        {
+        }
+
+        /**
+         * 添加指标
+         * @param name 用例名称
+         * @param key 指标名称
+         * @param value 指标值
+         */
+        void add(const std::string &name, const std::string &key, double value)
+        {
+            if (cases__.count(name) == 0)
+            {
+                order__.push_back(name);
+            }
+            cases__[name].emplace_back(key, value);
+            std::cerr << name << " " << key << " = " << value << std::endl;
+        }
+
+        /**
+         * 转换为JSON字符串
+         * @return JSON字符串
+         */
+        std::string to_json() const
+        {
+            std::ostringstream oss;
+            oss << "{\"suite\":\"" << suite__ << "\",\"cases\":[";
+            for (size_t i = 0; i < order__.size(); ++i)
+            {
+                oss << (i == 0 ? "" : ",") << "{\"name\":\"" << order__[i] << "\"";
+                for (auto &p : cases__.at(order__[i]))
+                {
+                    oss << ",\"" << p.first << "\":" << p.second;
+                }
+                oss << "}";
+            }
+            oss << "]}";
+            return oss.str();
+        }
+
+        /**
+         * 输出结果，指定文件时同时写入文件
+         * @param filename 文件名称（为空时仅输出到标准输出）
+         */
+        void output(const std::string &filename = "") const
+        {
+            auto json = to_json();
+            std::cout << json << std::endl;
+            if (!filename.empty())
+            {
+                std::ofstream fo(filename);
+                fo << json << std::endl;
+            }
+        }
+
+    private:
+        std::string suite__;
+        std::vector<std::string> order__;
+        std::map<std::string, std::vector<std::pair<std::string, double>>> cases__;
+    };
+}
+
+#ifdef SF_BENCH_COUNT_ALLOC
+#include <new>
+
+// NOTE 替换全局operator new/delete统计分配次数（普通、数组与按对齐分配的形式，nothrow形式默认调用这些函数），
+// 每个可执行文件只能有一个源文件定义SF_BENCH_COUNT_ALLOC
+inline void *sf_bench_alloc__(size_t size)
+{
+    skyfire::sf_bench_alloc_count().fetch_add(1, std::memory_order_relaxed);
+    if (auto p = std::malloc(size == 0 ? 1 : size))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+inline void *sf_bench_aligned_alloc__(size_t size, std::align_val_t align)
+{
+    skyfire::sf_bench_alloc_count().fetch_add(1, std::memory_order_relaxed);
+    auto alignment = static_cast<size_t>(align);
+    // NOTE aligned_alloc要求长度为对齐的整数倍
+    size = (size == 0 ? 1 : size + alignment - 1) / alignment * alignment;
+#ifdef _MSC_VER
+    auto p = _aligned_malloc(size, alignment);
+#else
+    auto p = std::aligned_alloc(alignment, size);
+#endif
+    if (p == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+inline void sf_bench_aligned_free__(void *p)
+{
+#ifdef _MSC_VER
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+void *operator new(size_t size)
+{
+    return sf_bench_alloc__(size);
+}
+
+void *operator new[](size_t size)
+{
+    return sf_bench_alloc__(size);
+}
+
+void *operator new(size_t size, std::align_val_t align)
+{
+    return sf_bench_aligned_alloc__(size, align);
+}
+
+void *operator new[](size_t size, std::align_val_t align)
+{
+    return sf_bench_aligned_alloc__(size, align);
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::align_val_t) noexcept
+{
+    sf_bench_aligned_free__(p);
+}
+
+void operator delete[](void *p, std::align_val_t) noexcept
+{
+    sf_bench_aligned_free__(p);
+}
+
+void operator delete(void *p, size_t, std::align_val_t) noexcept
+{
+    sf_bench_aligned_free__(p);
+}
+
+void operator delete[](void *p, size_t, std::align_val_t) noexcept
+{
+    sf_bench_aligned_free__(p);
+}
+#endif
@@ -12,6 +12,7 @@
 */
 
 #include "sf_object.hpp"
+#include "sf_static_aop.hpp"
 #include <iostream>
 using namespace skyfire;
 
@@ -28,6 +29,30 @@ public:
     }
 };
 
+// 10.编译期AOP：切面在编译期指定，调用完全内联，不需要继承sf_object
+struct log_aspect
+{
+    void before(int a, int b)
+    {
+        std::cout<<"static before, a="<<a<<",b="<<b<<std::endl;
+    }
+    void after()
+    {
+        std::cout<<"static after"<<std::endl;
+    }
+};
+
+class C
+{
+public:
+    // 11. 注册编译期aop成员函数，参数为成员函数名称与切面列表，同样生成aop_xxx函数
+    SF_REG_STATIC_AOP(func, log_aspect, sf_counting_aspect, sf_timing_aspect)
+    int func(int a, int b)
+    {
+        return a*b;
+    }
+};
+
 // 3.定义一个函数，使其插入到函数调用前，参数列表与要注入的函数相同
 void before_call(int a,int b)
 {
@@ -68,4 +93,15 @@ int main()
     //    this is lambda, a=5,b=10
     //    15
     //    call finished
-}
\ No newline at end of file
+
+    // 12. 调用编译期aop函数
+    C c;
+    std::cout<<c.aop_func(5,10)<<std::endl;
+    std::cout<<"count="<<sf_static_aop_get(&c, func, sf_counting_aspect).count<<std::endl;
+
+    // 输出：
+    //    static before, a=5,b=10
+    //    static after
+    //    50
+    //    count=1
+}
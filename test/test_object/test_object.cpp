@@ -13,6 +13,7 @@
 
 #include "sf_object.hpp"
 #include <iostream>
+#include <memory>
 
 using namespace skyfire;
 
@@ -29,15 +30,47 @@ void slot1(int a)
     std::cout<<std::this_thread::get_id()<<" "<<a<<std::endl;
 }
 
+// 6.接收对象，其排队槽函数会在自身所在的事件循环中执行
+class B: public sf_object
+{
+public:
+    void slot2(int a)
+    {
+        std::cout<<"B "<<std::this_thread::get_id()<<" "<<a<<std::endl;
+    }
+};
+
 int main()
 {
     A a;
     // 4.绑定信号与槽， 对象指针（可以是智能指针），信号名称，槽，是否使用消息队列
     sf_bind_signal(&a, s1, slot1, false);
     sf_bind_signal(&a, s1, slot1, true);
+
+    // 7.创建拥有独立消息队列的事件循环，并将对象b移动到此事件循环
+    sf_eventloop worker_loop(sf_eventloop_mode::private_queue);
+    B b;
+    b.move_to_thread(&worker_loop);
+    // 8.绑定信号到接收对象，槽函数会投递到b所在的事件循环
+    sf_bind_signal_to(&a, s1, &b, [&](int n){
+        b.slot2(n);
+    });
+    // 9.接收对象析构后发射信号，绑定到该对象的槽函数不再执行（析构前已投递的也被取消）
+    auto c = std::make_unique<B>();
+    c->move_to_thread(&worker_loop);
+    sf_bind_signal_to(&a, s1, c, [](int n){
+        std::cout<<"destroyed receiver called "<<n<<std::endl;
+    });
+    a.s1(55);
+    c.reset();
+    std::thread worker([&]{
+        worker_loop.exec();
+    });
+
     a.s1(56);
 
     sf_eventloop e;
     // 5.启动事件循环
     e.exec();
+    worker.join();
 }
\ No newline at end of file
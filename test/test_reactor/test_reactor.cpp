@@ -0,0 +1,75 @@
+
+/**
+* @version 1.0.0
+* @author skyfire
+* @mail skyfireitdiy@hotmail.com
+* @see http://github.com/skyfireitdiy/sflib
+* @file test_reactor.cpp
+
+* sflib第一版本发布
+* 版本号1.0.0
+* 发布日期：2018-10-22
+*/
+
+#include "sf_tcp_server.hpp"
+#include "sf_tcp_client.hpp"
+#include "sf_timer.hpp"
+
+using namespace skyfire;
+
+int main()
+{
+    // 1.创建反应堆模式的事件循环，IO、定时器、消息都在执行exec的线程中处理
+    sf_eventloop loop(sf_eventloop_mode::reactor);
+
+    // 2.服务器移动到反应堆后再监听，不再启动独立的IO线程
+    auto server = sf_tcp_server::make_server();
+    server->move_to_thread(&loop);
+    if (!server->listen("127.0.0.1", 9989))
+    {
+        std::cout << "listen on 9989 error" << std::endl;
+        return -1;
+    }
+    sf_bind_signal(server, data_coming, [&](SOCKET sock, const sf_pkg_header_t &header, const byte_array &data) {
+        std::cout << "server recv:" << to_string(data) << " thread:" << std::this_thread::get_id() << std::endl;
+        server->send(sock, header.type, data);
+    }, false);
+
+    // 3.客户端同样移动到反应堆
+    auto client = sf_tcp_client::make_client();
+    client->move_to_thread(&loop);
+    if (!client->connect_to_server("127.0.0.1", 9989))
+    {
+        std::cout << "connect error" << std::endl;
+        return -1;
+    }
+    sf_bind_signal(client, data_coming, [&](const sf_pkg_header_t &, const byte_array &data) {
+        std::cout << "client recv:" << to_string(data) << " thread:" << std::this_thread::get_id() << std::endl;
+    }, false);
+
+    // 4.定时器基于timerfd，在反应堆线程中触发
+    int count = 0;
+    sf_timer timer;
+    timer.move_to_thread(&loop);
+    sf_bind_signal(&timer, timeout, [&] {
+        client->send(1, to_byte_array("hello " + std::to_string(++count)));
+        if (count == 3)
+        {
+            timer.stop();
+        }
+    }, false);
+    timer.start(100);
+
+    sf_timer quit_timer;
+    quit_timer.move_to_thread(&loop);
+    sf_bind_signal(&quit_timer, timeout, [&] {
+        client->close();
+        server->close();
+        loop.quit();
+    }, false);
+    quit_timer.start(500, true);
+
+    std::cout << "main thread:" << std::this_thread::get_id() << std::endl;
+    // 5.启动事件循环
+    loop.exec();
+}
@@ -45,7 +45,12 @@ int main()
     data = *client->call<std::vector<int>>("add_one"s, data);
     disp_vec(data);
     std::cout<<"---------"<<std::endl;
-    // 5.异步调用，第二个参数为参数为rpc函数返回类型的回调函数（需要显式指明返回值类型）
+    // 5.调用不存在的函数，服务器返回错误响应，返回值为空（不等待超时）
+    if (!client->call<int>("not_exist"s))
+    {
+        std::cout<<"method not found"<<std::endl;
+    }
+    // 6.异步调用，第二个参数为参数为rpc函数返回类型的回调函数（需要显式指明返回值类型）
     client->async_call<std::vector<int>>("add_one"s, disp_vec, data);
     getchar();
 }
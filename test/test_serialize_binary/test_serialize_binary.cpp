@@ -0,0 +1,188 @@
+/**
+* @version 1.0.0
+* @author skyfire
+* @mail skyfireitdiy@hotmail.com
+* @see http://github.com/skyfireitdiy/sflib
+* @file test_serialize_binary.cpp
+
+* sflib第一版本发布
+* 版本号1.0.0
+* 发布日期：2018-10-22
+*/
+
+#include "sf_serialize_binary.hpp"
+#include "sf_tcp_utils.hpp"
+#include <iostream>
+#include <cassert>
+
+namespace skyfire
+{
+    struct user_t
+    {
+        int id;
+        std::string name;
+        std::map<std::string, std::list<double>> scores;
+    };
+
+    // 1.自定义结构需要注入到skyfire命名空间中
+    SF_MAKE_SERIALIZABLE_BINARY(user_t, id, name, scores)
+}
+
+using namespace skyfire;
+
+int main()
+{
+    user_t user{1, "skyfire", {{"math", {90.5, 80}}, {"english", {70}}}};
+
+    // 2.直接序列化为byte_array
+    auto data = sf_serialize_binary(user);
+
+    // 3.多个对象写入同一个缓冲区
+    sf_binary_writer writer;
+    sf_serialize_binary_to(writer, user);
+    sf_serialize_binary_to(writer, std::vector<std::string>{"hello", "world"});
+    assert(byte_array(writer.buffer().begin(), writer.buffer().begin() + data.size()) == data);
+
+    // 4.写入栈上的pmr缓冲区，不使用堆内存
+    char stack_buffer[1024];
+    std::pmr::monotonic_buffer_resource resource(stack_buffer, sizeof(stack_buffer));
+    std::pmr::vector<char> pmr_buffer(&resource);
+    sf_pmr_binary_writer pmr_writer(pmr_buffer);
+    sf_serialize_binary_to(pmr_writer, user);
+    assert(byte_array(pmr_buffer.begin(), pmr_buffer.end()) == data);
+
+    // 5.反序列化
+    user_t user2;
+    auto pos = sf_deserialize_binary(writer.buffer(), user2, 0);
+    std::vector<std::string> words;
+    pos = sf_deserialize_binary(writer.buffer(), words, pos);
+    assert(pos == writer.size());
+
+    // 6.数值类型的vector、std::string与std::array整体复制
+    std::array<std::string, 2> names{"a", "b"};
+    std::array<int, 3> ids{1, 2, 3};
+    std::vector<double> values{1.5, 2.5};
+    auto array_data = sf_serialize_binary(names, ids, values);
+    std::array<std::string, 2> names2;
+    std::array<int, 3> ids2{};
+    std::vector<double> values2;
+    pos = sf_deserialize_binary(array_data, names2, 0);
+    pos = sf_deserialize_binary(array_data, ids2, pos);
+    pos = sf_deserialize_binary(array_data, values2, pos);
+    assert(pos == array_data.size() && names2 == names && ids2 == ids && values2 == values);
+
+    // 7.计算序列化长度，定长类型可以在编译期计算
+    static_assert(sf_serialized_size(std::array<int, 3>{}) == sizeof(int) * 3);
+    assert(sf_serialized_size(user) == data.size());
+    assert(sf_serialized_size(names) + sf_serialized_size(ids) + sf_serialized_size(values) == array_data.size());
+
+    // 8.反序列化为视图，不复制数据，视图指向源缓冲区（使用期间源缓冲区不能释放或修改）
+    std::string_view name_view;
+    sf_vector_view<double> values_view;
+    pos = sf_deserialize_binary(array_data, name_view, 0);
+    pos = sf_deserialize_binary(array_data, name_view, pos);
+    pos += sizeof(ids);
+    pos = sf_deserialize_binary(array_data, values_view, pos);
+    assert(name_view == "b" && values_view.size() == 2 && values_view[1] == 2.5 && values_view.to_vector() == values);
+    assert(sf_serialize_binary(values_view) == sf_serialize_binary(values));
+
+    // 9.compact方式：长度与多字节整数使用变长编码，读取时使用相同方式的sf_binary_cursor
+    sf_binary_writer compact_writer(sf_binary_profile::compact);
+    std::vector<long long> small_values{0, -1, 1, -64, 64, 300, -300, std::numeric_limits<long long>::min()};
+    sf_serialize_binary_to(compact_writer, user);
+    sf_serialize_binary_to(compact_writer, small_values);
+    sf_serialize_binary_to(compact_writer, ids);
+    assert(compact_writer.size() < data.size() + sf_serialized_size(small_values) + sizeof(ids));
+    user_t user3;
+    std::vector<long long> small_values2;
+    std::array<int, 3> ids3{};
+    sf_binary_cursor cursor(compact_writer.buffer(), 0, sf_binary_profile::compact);
+    sf_deserialize_binary_from(cursor, user3);
+    sf_deserialize_binary_from(cursor, small_values2);
+    sf_deserialize_binary_from(cursor, ids3);
+    assert(cursor.pos() == compact_writer.size());
+    assert(user3.name == user.name && user3.scores == user.scores && small_values2 == small_values && ids3 == ids);
+    auto truncated = compact_writer.buffer();
+    truncated.pop_back();
+    sf_binary_cursor truncated_cursor(truncated, 0, sf_binary_profile::compact);
+    try {
+        sf_deserialize_binary_from(truncated_cursor, user3);
+        sf_deserialize_binary_from(truncated_cursor, small_values2);
+        sf_deserialize_binary_from(truncated_cursor, ids3);
+        assert(false);
+    } catch (const sf_serialize_binary_size_mismatch_exception &) {
+    }
+
+    // 10.增量反序列化：数据分段到达，数据不足时返回need_more，继续输入后使用同一个对象再次读取
+    for (auto profile : {sf_binary_profile::native, sf_binary_profile::compact, sf_binary_profile::portable})
+    {
+        std::vector<user_t> users{user, user3, user};
+        std::map<std::string, std::vector<int>> table{{"a", {1, -2, 3}}, {"b", {}}};
+        sf_binary_writer stream_writer(profile);
+        sf_serialize_binary_to(stream_writer, users);
+        sf_serialize_binary_to(stream_writer, table);
+        auto &stream = stream_writer.buffer();
+        sf_binary_reader reader(profile);
+        std::vector<user_t> users2;
+        std::map<std::string, std::vector<int>> table2;
+        auto status = sf_binary_read_status::need_more;
+        size_t fed = 0;
+        while (status == sf_binary_read_status::need_more)
+        {
+            assert(fed < stream.size());
+            reader.feed(stream.data() + fed++, 1);
+            status = reader.read(users2);
+        }
+        assert(status == sf_binary_read_status::done && users2.size() == 3 && users2[2].scores == user.scores);
+        reader.feed(stream.data() + fed, stream.size() - fed);
+        assert(reader.read(table2) == sf_binary_read_status::done && table2 == table && reader.buffered() == 0);
+    }
+
+    // 11.portable方式：长度为64位，数值为小端字节序，不同字节序、字长的主机之间可以交换数据
+    for (auto profile : {sf_binary_profile::native, sf_binary_profile::compact, sf_binary_profile::portable})
+    {
+        sf_binary_writer profile_writer(profile);
+        std::tuple<std::int16_t, float> tuple{-2, 0.5f};
+        sf_serialize_binary_to(profile_writer, user);
+        sf_serialize_binary_to(profile_writer, values);
+        sf_serialize_binary_to(profile_writer, ids);
+        sf_serialize_binary_to(profile_writer, tuple);
+        user_t user4;
+        std::vector<double> values4;
+        std::array<int, 3> ids4{};
+        std::tuple<std::int16_t, float> tuple4;
+        sf_binary_cursor profile_cursor(profile_writer.buffer(), 0, profile);
+        sf_deserialize_binary_from(profile_cursor, user4);
+        sf_deserialize_binary_from(profile_cursor, values4);
+        sf_deserialize_binary_from(profile_cursor, ids4);
+        sf_deserialize_binary_from(profile_cursor, tuple4);
+        assert(profile_cursor.pos() == profile_writer.size());
+        assert(user4.scores == user.scores && values4 == values && ids4 == ids && tuple4 == tuple);
+        if (profile == sf_binary_profile::portable && sf_host_little_endian && sizeof(size_t) == 8)
+        {
+            // NOTE 小端64位主机上portable与native的结果相同
+            assert(profile_writer.buffer() == sf_serialize_binary(user, values, ids, tuple));
+        }
+    }
+    unsigned char be_bytes[] = {1, 2, 3, 4, 5, 6, 7, 8};
+    std::uint64_t be_value;
+    memcpy(&be_value, be_bytes, sizeof(be_value));
+    assert(sf_ntoh64(be_value) == 0x0102030405060708ULL && sf_hton64(sf_ntoh64(be_value)) == be_value);
+    for (size_t unit : {2, 4, 8})
+    {
+        // NOTE 奇数个元素，覆盖向量化部分与剩余部分
+        byte_array src(unit * 37), dst(src.size());
+        for (size_t i = 0; i < src.size(); ++i)
+        {
+            src[i] = static_cast<char>(i);
+        }
+        sf_byte_swap_copy(dst.data(), src.data(), 37, unit);
+        for (size_t i = 0; i < src.size(); ++i)
+        {
+            assert(dst[i] == src[i / unit * unit + unit - 1 - i % unit]);
+        }
+    }
+
+    std::cout << user2.id << " " << user2.name << " " << user2.scores["math"].front() << " " << words[1] << std::endl;
+    return user2.name == user.name && user2.scores == user.scores ? 0 : 1;
+}
@@ -34,6 +34,16 @@ int main()
     sf_warn("this is warn");
     sf_error("hello", "world");
     sf_warn("this is warn");
+    // 7.限频打印：每n次、每隔指定毫秒或按概率打印，恢复打印时输出被抑制的数量
+    for (auto i = 0; i < 10; ++i)
+    {
+        sf_warn_every_n(5, "every 5 times", i);
+        sf_warn_every_ms(1000, "at most once per second", i);
+        sf_warn_sampled(0.1, "10% sampled", i);
+    }
+    // 8.设置最低日志等级，低于此等级的日志不会求值参数（SF_LOG_COMPILE_LEVEL宏可在编译期移除低等级日志）
+    logger->set_min_level(SF_WARN_LEVEL);
+    sf_info("this will not be printed");
     getchar();
     g_logger->stop_logger();
     getchar();
@@ -0,0 +1,382 @@
+/**
+* @version 1.0.0
+* @author skyfire
+* @mail skyfireitdiy@hotmail.com
+* @see http://github.com/skyfireitdiy/sflib
+* @file sf_log_decode.cpp
+
+* sflib第一版本发布
+* 版本号1.0.0
+* 发布日期：2018-10-22
+*/
+
+/*
+ * sf_log_decode 将sf_log_binary_sink输出的二进制日志还原为文本或json
+ * 用法：sf_log_decode [--json] [--precision N] [--format FORMAT] file...
+ */
+
+#include "sf_logger.hpp"
+#include "sf_serialize_binary.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+using namespace skyfire;
+
+/**
+ *  @brief 解码选项
+ */
+struct decode_option_t
+{
+    bool json = false;                          // 输出json
+    int precision = 0;                          // 时间秒以下的位数
+    std::string format = sf_default_log_format; // 文本格式
+};
+
+/**
+ *  @brief 日志位置字典项
+ */
+struct location_t
+{
+    int level;
+    int line;
+    std::string file;
+    std::string func;
+};
+
+std::string json_escape(const std::string &str)
+{
+    std::string ret = "\"";
+    for (auto c : str)
+    {
+        switch (c)
+        {
+            case '"':
+                ret += "\\\"";
+                break;
+            case '\\':
+                ret += "\\\\";
+                break;
+            case '\n':
+                ret += "\\n";
+                break;
+            case '\r':
+                ret += "\\r";
+                break;
+            case '\t':
+                ret += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    char buffer[8];
+                    snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    ret += buffer;
+                }
+                else
+                {
+                    ret += c;
+                }
+        }
+    }
+    ret += "\"";
+    return ret;
+}
+
+/**
+ * 解码一个参数
+ * @param data 数据
+ * @param pos 读取位置
+ * @param text 文本形式（与运行时文本输出相同）
+ * @param json json形式
+ * @return 读取后的位置
+ */
+size_t decode_arg(const byte_array &data, size_t pos, std::string &text, std::string &json)
+{
+    unsigned char tag;
+    pos = sf_deserialize_binary(data, tag, pos);
+    std::ostringstream oss;
+    switch (static_cast<sf_log_arg_tag>(tag))
+    {
+        case sf_log_arg_tag::int64:
+        {
+            std::int64_t value;
+            pos = sf_deserialize_binary(data, value, pos);
+            oss << static_cast<long long>(value);
+            json = oss.str();
+            break;
+        }
+        case sf_log_arg_tag::uint64:
+        {
+            std::uint64_t value;
+            pos = sf_deserialize_binary(data, value, pos);
+            oss << static_cast<unsigned long long>(value);
+            json = oss.str();
+            break;
+        }
+        case sf_log_arg_tag::float64:
+        {
+            double value;
+            pos = sf_deserialize_binary(data, value, pos);
+            oss << value;
+            std::ostringstream json_oss;
+            json_oss.precision(17);
+            json_oss << value;
+            json = json_oss.str();
+            break;
+        }
+        case sf_log_arg_tag::boolean:
+        {
+            bool value;
+            pos = sf_deserialize_binary(data, value, pos);
+            oss << value;
+            json = value ? "true" : "false";
+            break;
+        }
+        case sf_log_arg_tag::character:
+        {
+            char value;
+            pos = sf_deserialize_binary(data, value, pos);
+            oss << value;
+            json = json_escape(oss.str());
+            break;
+        }
+        case sf_log_arg_tag::string:
+        {
+            std::string value;
+            pos = sf_deserialize_binary(data, value, pos);
+            oss << value;
+            json = json_escape(value);
+            break;
+        }
+        default:
+            throw sf_serialize_binary_size_mismatch_exception("unknown argument tag " + std::to_string(tag));
+    }
+    text = oss.str();
+    return pos;
+}
+
+void output(const decode_option_t &option, const sf_log_format &fmt, std::string &buffer,
+            const sf_logger_info_t__ &log_info, const std::string &thread_str, const std::vector<std::string> *json_args)
+{
+    if (!option.json)
+    {
+        fmt.render(buffer, log_info, thread_str);
+        std::cout.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        return;
+    }
+    std::string level = log_info.level >= 0 && log_info.level < static_cast<int>(std::size(sf_log_level_str))
+                        ? sf_log_level_str[log_info.level] : "";
+    level.erase(level.find_last_not_of(' ') + 1);
+    std::cout << "{\"level\":" << json_escape(level)
+              << ",\"time\":" << json_escape(log_info.time)
+              << ",\"thread\":" << json_escape(thread_str)
+              << ",\"file\":" << json_escape(log_info.file)
+              << ",\"line\":" << log_info.line
+              << ",\"func\":" << json_escape(log_info.func);
+    if (json_args != nullptr)
+    {
+        std::cout << ",\"args\":[";
+        for (size_t i = 0; i < json_args->size(); ++i)
+        {
+            std::cout << (i == 0 ? "" : ",") << (*json_args)[i];
+        }
+        std::cout << "]";
+    }
+    else
+    {
+        std::cout << ",\"msg\":" << json_escape(log_info.msg);
+    }
+    std::cout << "}\n";
+}
+
+/**
+ * 解码一个文件
+ * @return 是否成功
+ */
+bool decode_file(const std::string &filename, const decode_option_t &option)
+{
+    std::ifstream fi(filename, std::ios::in | std::ios::binary);
+    if (!fi)
+    {
+        std::cerr << "open " << filename << " failed" << std::endl;
+        return false;
+    }
+    byte_array data((std::istreambuf_iterator<char>(fi)), std::istreambuf_iterator<char>());
+
+    sf_log_format fmt(option.format);
+    std::string buffer;
+    std::vector<location_t> locations;
+    std::vector<std::string> threads;
+    std::vector<std::string> json_args;
+    size_t pos = 0;
+    try
+    {
+        while (pos < data.size())
+        {
+            unsigned char type;
+            pos = sf_deserialize_binary(data, type, pos);
+            switch (static_cast<sf_log_binary_entry>(type))
+            {
+                case sf_log_binary_entry::header:
+                {
+                    if (data.size() - pos < sizeof(sf_log_binary_magic)
+                        || std::memcmp(data.data() + pos, sf_log_binary_magic, sizeof(sf_log_binary_magic)) != 0)
+                    {
+                        std::cerr << filename << ": bad magic at " << pos << std::endl;
+                        return false;
+                    }
+                    pos += sizeof(sf_log_binary_magic);
+                    std::uint32_t version;
+                    pos = sf_deserialize_binary(data, version, pos);
+                    if (version != sf_log_binary_version)
+                    {
+                        std::cerr << filename << ": unsupported version " << version << std::endl;
+                        return false;
+                    }
+                    // 每个文件头之后字典重新编号（追加写入或切分后的新文件）
+                    locations.clear();
+                    threads.clear();
+                    break;
+                }
+                case sf_log_binary_entry::location:
+                {
+                    std::uint32_t id;
+                    std::int32_t level, line;
+                    location_t location;
+                    pos = sf_deserialize_binary(data, id, pos);
+                    pos = sf_deserialize_binary(data, level, pos);
+                    pos = sf_deserialize_binary(data, line, pos);
+                    pos = sf_deserialize_binary(data, location.file, pos);
+                    pos = sf_deserialize_binary(data, location.func, pos);
+                    location.level = level;
+                    location.line = line;
+                    if (locations.size() <= id)
+                    {
+                        locations.resize(id + 1);
+                    }
+                    locations[id] = std::move(location);
+                    break;
+                }
+                case sf_log_binary_entry::thread:
+                {
+                    std::uint32_t id;
+                    std::string thread;
+                    pos = sf_deserialize_binary(data, id, pos);
+                    pos = sf_deserialize_binary(data, thread, pos);
+                    if (threads.size() <= id)
+                    {
+                        threads.resize(id + 1);
+                    }
+                    threads[id] = std::move(thread);
+                    break;
+                }
+                case sf_log_binary_entry::record:
+                {
+                    std::uint32_t location_id, thread_id, arg_count;
+                    std::int64_t ticks;
+                    pos = sf_deserialize_binary(data, location_id, pos);
+                    pos = sf_deserialize_binary(data, thread_id, pos);
+                    pos = sf_deserialize_binary(data, ticks, pos);
+                    pos = sf_deserialize_binary(data, arg_count, pos);
+                    if (location_id >= locations.size() || thread_id >= threads.size())
+                    {
+                        std::cerr << filename << ": unknown dictionary id at " << pos << std::endl;
+                        return false;
+                    }
+                    auto &location = locations[location_id];
+                    sf_logger_info_t__ log_info;
+                    log_info.level = static_cast<SF_LOG_LEVEL>(location.level);
+                    log_info.time = sf_log_time_str(ticks, option.precision);
+                    log_info.line = location.line;
+                    log_info.file = location.file;
+                    log_info.func = location.func;
+                    json_args.clear();
+                    std::string text, json;
+                    for (std::uint32_t i = 0; i < arg_count; ++i)
+                    {
+                        pos = decode_arg(data, pos, text, json);
+                        log_info.msg += "[" + text + "]";
+                        json_args.push_back(json);
+                    }
+                    output(option, fmt, buffer, log_info, threads[thread_id], &json_args);
+                    break;
+                }
+                case sf_log_binary_entry::text:
+                {
+                    std::int32_t level, line;
+                    std::uint32_t thread_id;
+                    sf_logger_info_t__ log_info;
+                    pos = sf_deserialize_binary(data, level, pos);
+                    pos = sf_deserialize_binary(data, log_info.time, pos);
+                    pos = sf_deserialize_binary(data, thread_id, pos);
+                    pos = sf_deserialize_binary(data, log_info.file, pos);
+                    pos = sf_deserialize_binary(data, line, pos);
+                    pos = sf_deserialize_binary(data, log_info.func, pos);
+                    pos = sf_deserialize_binary(data, log_info.msg, pos);
+                    if (thread_id >= threads.size())
+                    {
+                        std::cerr << filename << ": unknown dictionary id at " << pos << std::endl;
+                        return false;
+                    }
+                    log_info.level = static_cast<SF_LOG_LEVEL>(level);
+                    log_info.line = line;
+                    output(option, fmt, buffer, log_info, threads[thread_id], nullptr);
+                    break;
+                }
+                default:
+                    std::cerr << filename << ": unknown entry type " << static_cast<int>(type) << " at " << pos
+                              << std::endl;
+                    return false;
+            }
+        }
+    }
+    catch (const sf_serialize_binary_size_mismatch_exception &e)
+    {
+        std::cerr << filename << ": truncated at " << pos << " (" << e.what() << ")" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    decode_option_t option;
+    std::vector<std::string> files;
+    for (auto i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--json")
+        {
+            option.json = true;
+        }
+        else if (arg == "--precision" && i + 1 < argc)
+        {
+            option.precision = std::atoi(argv[++i]);
+        }
+        else if (arg == "--format" && i + 1 < argc)
+        {
+            option.format = argv[++i];
+        }
+        else
+        {
+            files.push_back(arg);
+        }
+    }
+    if (files.empty())
+    {
+        std::cerr << "usage: " << argv[0] << " [--json] [--precision N] [--format FORMAT] file..." << std::endl;
+        return 1;
+    }
+    // NOTE 本工具不打印日志，移除默认的标准输出
+    g_logger->clear_filters();
+    auto ok = true;
+    for (auto &file : files)
+    {
+        ok = decode_file(file, option) && ok;
+    }
+    return ok ? 0 : 2;
+}